@@ -0,0 +1,103 @@
+#include "BounceBenchmark.h"
+
+BounceBenchmark::BounceBenchmark(const juce::String& path, double rate, int size)
+    : juce::Thread("Bounce benchmark"),
+      processor(std::make_unique<VST3LoaderAudioProcessor>()),
+      pluginPath(path),
+      sampleRate(rate > 0.0 ? rate : 48000.0),
+      blockSize(size > 0 ? size : 512)
+{
+}
+
+BounceBenchmark::~BounceBenchmark()
+{
+    stopTimer();
+    stopThread(10000);
+    processor->closeHostedPlugin();
+}
+
+void BounceBenchmark::start()
+{
+    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+    processor->loadPlugin(pluginPath);
+    startTimer(50);
+}
+
+void BounceBenchmark::timerCallback()
+{
+    if (processor->isCurrentlyLoading()) { return; }
+    
+    if (!hasStartedProcessing)
+    {
+        if (!processor->isHostedPluginLoaded())
+        {
+            stopTimer();
+            if (onFinished != nullptr) { onFinished("Cannot load " + pluginPath); }
+            return;
+        }
+        
+        hasStartedProcessing = true;
+        startThread(juce::Thread::Priority::high);
+        return;
+    }
+    
+    if (isThreadRunning()) { return; }
+    
+    stopTimer();
+    if (onFinished != nullptr) { onFinished(createReport()); }
+}
+
+void BounceBenchmark::run()
+{
+    realtimeMilliseconds = measure(false);
+    offlineMilliseconds = measure(true);
+    processor->setNonRealtime(false);
+}
+
+double BounceBenchmark::measure(bool isNonRealtime)
+{
+    processor->setNonRealtime(isNonRealtime);
+    processor->reset();
+    
+    const auto numChannels = juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
+    const auto numBlocks = (int) (secondsOfAudio * sampleRate / blockSize);
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiMessages;
+    juce::Random random(1234);
+    double elapsed = 0.0;
+    
+    for (int i = 0; i < numBlocks && !threadShouldExit(); ++i)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int s = 0; s < blockSize; ++s)
+            {
+                data[s] = random.nextFloat() * 0.5f - 0.25f;
+            }
+        }
+        
+        midiMessages.clear();
+        const auto start = juce::Time::getHighResolutionTicks();
+        processor->processBlock(buffer, midiMessages);
+        elapsed += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    }
+    
+    return elapsed * 1000.0;
+}
+
+juce::String BounceBenchmark::createReport() const
+{
+    auto speed = [](double milliseconds)
+    {
+        return juce::String(secondsOfAudio * 1000.0 / juce::jmax(1.0e-6, milliseconds), 1) + "x realtime";
+    };
+    
+    juce::String text;
+    text << juce::String(secondsOfAudio, 0) << " s at " << juce::String(sampleRate, 0) << " Hz, " << blockSize << " samples\n"
+         << "Realtime mode: " << juce::String(realtimeMilliseconds, 1) << " ms (" << speed(realtimeMilliseconds) << ")\n"
+         << "Offline mode: " << juce::String(offlineMilliseconds, 1) << " ms (" << speed(offlineMilliseconds) << ")\n"
+         << "Speed-up: " << juce::String(realtimeMilliseconds / juce::jmax(1.0e-6, offlineMilliseconds), 2);
+    return text;
+}
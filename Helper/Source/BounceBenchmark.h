@@ -0,0 +1,38 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+// 오프라인 바운스 속도 측정 (VST3LoaderHost --bounce-benchmark)
+// 래퍼 인스턴스에 플러그인을 로드하고, 같은 노이즈를 실시간 모드와 오프라인 모드로 한 번씩 처리해서 걸린 시간을 비교
+class BounceBenchmark : private juce::Thread,
+                        private juce::Timer
+{
+public:
+    BounceBenchmark(const juce::String& pluginPath, double sampleRate, int blockSize);
+    ~BounceBenchmark() override;
+    
+    // 메시지 스레드에서 불림
+    std::function<void(const juce::String& report)> onFinished;
+    
+    void start();
+    bool isRunning() const { return isTimerRunning(); }
+    
+private:
+    std::unique_ptr<VST3LoaderAudioProcessor> processor;
+    juce::String pluginPath;
+    double sampleRate;
+    int blockSize;
+    bool hasStartedProcessing = false;
+    
+    double realtimeMilliseconds = 0.0;
+    double offlineMilliseconds = 0.0;
+    
+    static constexpr double secondsOfAudio = 30.0;
+    
+    void run() override;
+    void timerCallback() override;
+    double measure(bool isNonRealtime);
+    juce::String createReport() const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BounceBenchmark)
+};
@@ -0,0 +1,835 @@
+#include <JuceHeader.h>
+#include <unistd.h>
+#include "../../Source/SharedAudioTransport.h"
+#include "../../Source/OutputSanitizer.h"
+#include "../../Source/LoadProfiler.h"
+#include "../../Source/InternalRateConverter.h"
+#include "../../Source/SessionCapture.h"
+#include "../../Source/SharedBatchEngine.h"
+#include "../../Source/MidiLearn.h"
+#include "../../Source/RealtimeSafetyMonitor.h"
+#include "RealtimeStressTest.h"
+#include "BounceBenchmark.h"
+#include "TeardownBenchmark.h"
+#include "WrapperBenchmark.h"
+
+// VST3 Loader 의 out-of-process 모드에서 호스팅 플러그인을 실행하는 자식 프로세스
+//   VST3LoaderHost --oop-worker --shm <name> --rate <sr> --block <n>
+//   VST3LoaderHost --transport-benchmark
+//   VST3LoaderHost --sanitizer-benchmark
+//   VST3LoaderHost --load-report
+//   VST3LoaderHost --resampler-benchmark [--plugin <path>]
+//   VST3LoaderHost --replay <capture> [--plugin <path>]
+//   VST3LoaderHost --batch-benchmark --plugin <path>
+//   VST3LoaderHost --midi-learn-benchmark
+//   VST3LoaderHost --instrument-benchmark --plugin <path>
+//   VST3LoaderHost --teardown-benchmark --plugin <path>
+//   VST3LoaderHost --realtime-stress-test [--plugin <path>] [--seconds <n>]   (위반이 있으면 종료 코드 1)
+//   VST3LoaderHost --bounce-benchmark --plugin <path> [--rate <sr>] [--block <n>]
+//   VST3LoaderHost --wrapper-benchmark   (예산을 넘는 경우가 있으면 종료 코드 1)
+class HostedPluginWorker : private juce::Thread,
+                           private juce::Timer,
+                           private juce::AsyncUpdater
+{
+public:
+    HostedPluginWorker(std::unique_ptr<SharedAudioTransport> transportToUse,
+                       std::unique_ptr<juce::AudioPluginInstance> instance)
+        : juce::Thread("VST3LoaderHost audio"),
+          transport(std::move(transportToUse)),
+          plugin(std::move(instance))
+    {
+        transport->getHeader().pluginLatencySamples.store(plugin->getLatencySamples());
+        startRealtimeThread(juce::Thread::RealtimeOptions{});
+        startTimer(50);
+    }
+    
+    ~HostedPluginWorker() override
+    {
+        stopTimer();
+        cancelPendingUpdate();
+        transport->getHeader().shouldQuit.store(1);
+        transport->postRequest();
+        stopThread(2000);
+        plugin->releaseResources();
+    }
+    
+    std::function<void()> onQuit;
+    
+private:
+    std::unique_ptr<SharedAudioTransport> transport;
+    std::unique_ptr<juce::AudioPluginInstance> plugin;
+    juce::MidiBuffer midiMessages;
+    
+    void run() override
+    {
+        auto& header = transport->getHeader();
+        auto next = header.requestSequence.load() + 1;
+        midiMessages.ensureSize(SharedAudioTransport::maxMidiBytes);
+        header.workerReady.store(1);
+        
+        while (!threadShouldExit() && transport->waitForRequest())
+        {
+            const auto latest = header.requestSequence.load(std::memory_order_acquire);
+            
+            // 링보다 더 밀렸으면 덮어써진 슬롯은 건너뜀
+            if (latest >= next + SharedAudioTransport::numSlots)
+            {
+                next = latest - SharedAudioTransport::numSlots + 1;
+            }
+            
+            for (; next <= latest; ++next)
+            {
+                auto& slot = transport->getSlot(next);
+                if (slot.requestSequence.load(std::memory_order_acquire) == next)
+                {
+                    processSlot(next, slot);
+                }
+                slot.completedSequence.store(next, std::memory_order_release);
+            }
+            
+            transport->postCompletion();
+            
+            // 상태 요청은 래퍼가 이 스레드를 깨워서 알리고, 상태는 메시지 스레드에서 가져옴
+            if (transport->isStateRequested()) { triggerAsyncUpdate(); }
+        }
+        
+        header.workerReady.store(0);
+    }
+    
+    void processSlot(juce::uint64 sequence, SharedAudioTransport::Slot& slot)
+    {
+        const auto pluginChannels = juce::jmax(plugin->getTotalNumInputChannels(),
+                                               plugin->getTotalNumOutputChannels());
+        const auto numChannels = juce::jlimit(0, SharedAudioTransport::maxChannels,
+                                              juce::jmax((int) slot.numChannels, pluginChannels));
+        float* channels[SharedAudioTransport::maxChannels] = {};
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            channels[ch] = transport->getChannel(sequence, ch);
+            if (ch >= slot.numChannels)
+            {
+                juce::FloatVectorOperations::clear(channels[ch], slot.numSamples);
+            }
+        }
+        
+        juce::AudioBuffer<float> buffer(channels, numChannels, slot.numSamples);
+        
+        midiMessages.clear();
+        SharedAudioTransport::readMidi(transport->getMidiData(sequence), slot.numMidiBytes,
+                                       midiMessages, slot.numSamples);
+        
+        if (slot.isActive != 0)
+            plugin->processBlock(buffer, midiMessages);
+        else
+            plugin->processBlockBypassed(buffer, midiMessages);
+        
+        slot.numMidiBytes = SharedAudioTransport::writeMidi(midiMessages, transport->getMidiData(sequence),
+                                                            SharedAudioTransport::maxMidiBytes);
+    }
+    
+    void timerCallback() override
+    {
+        auto& header = transport->getHeader();
+        
+        // 부모(로직)가 죽으면 함께 종료
+        if (getppid() == 1 || header.shouldQuit.load() != 0)
+        {
+            stopTimer();
+            if (onQuit != nullptr) { onQuit(); }
+            return;
+        }
+        
+        header.pluginLatencySamples.store(plugin->getLatencySamples());
+    }
+    
+    void handleAsyncUpdate() override
+    {
+        if (!transport->isStateRequested()) { return; }
+        
+        juce::MemoryBlock innerState;
+        plugin->getStateInformation(innerState);
+        transport->postState(innerState);
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HostedPluginWorker)
+};
+
+// 기록된 블록의 재생 위치를 그대로 돌려주는 플레이헤드
+class CapturedPlayHead : public juce::AudioPlayHead
+{
+public:
+    SessionCapture::BlockInfo block;
+    
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        if (!block.hasPosition) { return {}; }
+        return block.position;
+    }
+};
+
+class VST3LoaderHostApplication : public juce::JUCEApplicationBase
+{
+public:
+    const juce::String getApplicationName() override { return "VST3LoaderHost"; }
+    const juce::String getApplicationVersion() override { return "1.0.0"; }
+    bool moreThanOneInstanceAllowed() override { return true; }
+    void anotherInstanceStarted(const juce::String&) override {}
+    void suspended() override {}
+    void resumed() override {}
+    void systemRequestedQuit() override { quit(); }
+    void unhandledException(const std::exception*, const juce::String&, int) override {}
+    
+    void initialise(const juce::String&) override
+    {
+        const auto args = getCommandLineParameterArray();
+        
+        if (args.contains("--transport-benchmark"))
+        {
+            runTransportBenchmark();
+            quit();
+            return;
+        }
+        
+        if (args.contains("--sanitizer-benchmark"))
+        {
+            runSanitizerBenchmark();
+            quit();
+            return;
+        }
+        
+        if (args.contains("--load-report"))
+        {
+            printLoadReport();
+            quit();
+            return;
+        }
+        
+        if (args.contains("--resampler-benchmark"))
+        {
+            runResamplerBenchmark(getArgument(args, "--plugin"));
+            quit();
+            return;
+        }
+        
+        if (args.contains("--batch-benchmark"))
+        {
+            runBatchBenchmark(getArgument(args, "--plugin"));
+            quit();
+            return;
+        }
+        
+        if (args.contains("--midi-learn-benchmark"))
+        {
+            runMidiLearnBenchmark();
+            quit();
+            return;
+        }
+        
+        if (args.contains("--instrument-benchmark"))
+        {
+            runInstrumentBenchmark(getArgument(args, "--plugin"));
+            quit();
+            return;
+        }
+        
+        if (args.contains("--teardown-benchmark"))
+        {
+            startTeardownBenchmark(getArgument(args, "--plugin"));
+            return;
+        }
+        
+        if (args.contains("--realtime-stress-test"))
+        {
+            startStressTest(getArgument(args, "--plugin"), getArgument(args, "--seconds"));
+            return;
+        }
+        
+        if (args.contains("--wrapper-benchmark"))
+        {
+            if (!runWrapperBenchmark())
+            {
+                setApplicationReturnValue(1);
+            }
+            quit();
+            return;
+        }
+        
+        if (args.contains("--bounce-benchmark"))
+        {
+            startBounceBenchmark(getArgument(args, "--plugin"),
+                                 getArgument(args, "--rate").getDoubleValue(),
+                                 getArgument(args, "--block").getIntValue());
+            return;
+        }
+        
+        if (args.contains("--replay"))
+        {
+            if (!runReplay(juce::File(getArgument(args, "--replay")), getArgument(args, "--plugin")))
+            {
+                setApplicationReturnValue(1);
+            }
+            quit();
+            return;
+        }
+        
+        if (!args.contains("--oop-worker") || !startWorker(args))
+        {
+            setApplicationReturnValue(1);
+            quit();
+        }
+    }
+    
+    void shutdown() override
+    {
+        worker.reset();
+        stressTest.reset();
+        bounceBenchmark.reset();
+        teardownBenchmark.reset();
+    }
+    
+private:
+    std::unique_ptr<HostedPluginWorker> worker;
+    std::unique_ptr<RealtimeStressTest> stressTest;
+    std::unique_ptr<BounceBenchmark> bounceBenchmark;
+    std::unique_ptr<TeardownBenchmark> teardownBenchmark;
+    
+    static constexpr double defaultStressTestSeconds = 10.0;
+    
+    static juce::String getArgument(const juce::StringArray& args, const juce::String& name)
+    {
+        const auto index = args.indexOf(name);
+        return index >= 0 ? args[index + 1] : juce::String();
+    }
+    
+    bool startWorker(const juce::StringArray& args)
+    {
+        auto transport = SharedAudioTransport::open(getArgument(args, "--shm"));
+        if (transport == nullptr) { return false; }
+        
+        // 래퍼가 띄우기 전에 공유 메모리의 상태 영역에 써둔 플러그인 설명과 상태
+        juce::MemoryBlock launchData;
+        if (!transport->readState(launchData)) { return false; }
+        
+        auto xml = juce::parseXML(launchData.toString());
+        if (xml == nullptr) { return false; }
+        
+        juce::PluginDescription description;
+        auto* descriptionNode = xml->getChildByName("PLUGIN");
+        if (descriptionNode == nullptr || !description.loadFromXml(*descriptionNode)) { return false; }
+        
+        const auto sampleRate = getArgument(args, "--rate").getDoubleValue();
+        const auto blockSize = getArgument(args, "--block").getIntValue();
+        
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+        
+        juce::String error;
+        auto instance = formatManager.createPluginInstance(description, sampleRate, blockSize, error);
+        if (instance == nullptr) { return false; }
+        
+        instance->enableAllBuses();
+        instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        instance->prepareToPlay(sampleRate, blockSize);
+        
+        juce::MemoryBlock innerState;
+        innerState.fromBase64Encoding(xml->getChildElementAllSubText("inner_state", {}));
+        if (!innerState.isEmpty())
+        {
+            instance->setStateInformation(innerState.getData(), (int) innerState.getSize());
+        }
+        
+        worker = std::make_unique<HostedPluginWorker>(std::move(transport), std::move(instance));
+        worker->onQuit = [this]() { quit(); };
+        return true;
+    }
+    
+    void startStressTest(const juce::String& pluginPath, const juce::String& seconds)
+    {
+        // 이 바이너리의 operator new 가 ScopedBlock 안의 할당을 셈
+        RealtimeSafetyMonitor::setCheckingAllocations(true);
+        
+        const auto durationSeconds = seconds.isNotEmpty() ? seconds.getDoubleValue() : defaultStressTestSeconds;
+        stressTest = std::make_unique<RealtimeStressTest>(pluginPath, durationSeconds);
+        stressTest->onFinished = [this](const juce::String& report, bool passed)
+        {
+            std::cout << report << std::endl
+                      << (passed ? "PASS" : "FAIL") << std::endl;
+            
+            if (!passed) { setApplicationReturnValue(1); }
+            quit();
+        };
+        stressTest->start();
+    }
+    
+    void startBounceBenchmark(const juce::String& pluginPath, double sampleRate, int blockSize)
+    {
+        // 플러그인 로드가 비동기이므로 끝날 때까지 메시지 루프를 돌림 (0 이면 48 kHz, 512 샘플)
+        bounceBenchmark = std::make_unique<BounceBenchmark>(pluginPath, sampleRate, blockSize);
+        bounceBenchmark->onFinished = [this](const juce::String& report)
+        {
+            std::cout << report << std::endl;
+            quit();
+        };
+        bounceBenchmark->start();
+    }
+    
+    void startTeardownBenchmark(const juce::String& pluginPath)
+    {
+        // 래퍼 경로의 VST3 정리는 메시지 스레드로 넘어오므로 끝날 때까지 메시지 루프를 돌림
+        teardownBenchmark = std::make_unique<TeardownBenchmark>(pluginPath);
+        teardownBenchmark->onFinished = [this](const juce::String& report)
+        {
+            std::cout << report << std::endl;
+            quit();
+        };
+        teardownBenchmark->start();
+    }
+    
+    static bool runWrapperBenchmark()
+    {
+        const auto results = WrapperBenchmark::run();
+        auto numFailed = 0;
+        
+        std::cout << "stub\tplugin_channels\twrapper_channels\tactive\tblock\tdirect_ns\twrapper_ns\toverhead_ns\tbudget_ns\tresult" << std::endl;
+        for (const auto& result : results)
+        {
+            if (!result.hasPassed()) { ++numFailed; }
+            
+            std::cout << result.stub << "\t"
+                      << result.pluginChannels << "\t"
+                      << WrapperBenchmark::wrapperChannels << "\t"
+                      << (result.isActive ? "active" : "bypassed") << "\t"
+                      << result.blockSize << "\t"
+                      << juce::String(result.directNanoseconds, 1) << "\t"
+                      << juce::String(result.wrapperNanoseconds, 1) << "\t"
+                      << juce::String(result.getOverheadNanoseconds(), 1) << "\t"
+                      << juce::String(result.budgetNanoseconds, 0) << "\t"
+                      << (result.hasPassed() ? "pass" : "FAIL") << std::endl;
+        }
+        
+        std::cout << (int) results.size() << " cases, " << numFailed << " over budget" << std::endl;
+        return numFailed == 0 && !results.empty();
+    }
+    
+    static void runTransportBenchmark()
+    {
+        const auto results = SharedAudioTransport::measureRoundTripLatency({ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 });
+        
+        std::cout << "block\tavg_us\tworst_us" << std::endl;
+        for (const auto& result : results)
+        {
+            std::cout << result.blockSize << "\t"
+                      << juce::String(result.averageMicroseconds, 2) << "\t"
+                      << juce::String(result.worstMicroseconds, 2) << std::endl;
+        }
+    }
+    
+    static void runSanitizerBenchmark()
+    {
+        const auto results = OutputSanitizer::measureScanCost({ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 });
+        
+        std::cout << "block\tns_per_channel_sample" << std::endl;
+        for (const auto& result : results)
+        {
+            std::cout << result.blockSize << "\t" << juce::String(result.nanosecondsPerChannelSample, 3) << std::endl;
+        }
+    }
+    
+    static void runResamplerBenchmark(const juce::String& pluginPath)
+    {
+        const std::vector<double> sampleRates { 88200.0, 96000.0, 176400.0, 192000.0 };
+        const auto results = InternalRateConverter::measure(sampleRates);
+        
+        std::cout << "rate\tfactor\tlatency\tns_per_channel_sample\tpassband_error_db\talias_rejection_db" << std::endl;
+        for (const auto& result : results)
+        {
+            std::cout << result.hostSampleRate << "\t"
+                      << result.factor << "\t"
+                      << result.latencySamples << "\t"
+                      << juce::String(result.nanosecondsPerChannelSample, 3) << "\t"
+                      << juce::String(result.passbandErrorDb, 4) << "\t"
+                      << juce::String(result.aliasRejectionDb, 1) << std::endl;
+        }
+        
+        if (pluginPath.isEmpty()) { return; }
+        
+        // 실제 플러그인으로 호스트 레이트 처리와 내부 레이트 처리(변환 포함)의 CPU 시간을 비교
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+        
+        juce::OwnedArray<juce::PluginDescription> descriptions;
+        if (!describePlugin(formatManager, pluginPath, descriptions)) { return; }
+        
+        constexpr int blockSize = 512;
+        constexpr double secondsOfAudio = 10.0;
+        
+        std::cout << std::endl << "rate\tnative_ms\treduced_ms\tratio" << std::endl;
+        
+        for (const auto sampleRate : sampleRates)
+        {
+            InternalRateConverter converter;
+            const auto factor = InternalRateConverter::getFactorForRate(sampleRate);
+            converter.prepare(sampleRate, blockSize, 2, factor);
+            
+            auto measure = [&](bool useConverter) -> double
+            {
+                const auto pluginRate = useConverter ? converter.getInternalSampleRate() : sampleRate;
+                const auto pluginBlockSize = useConverter ? converter.getMaxInternalBlockSize() : blockSize;
+                
+                juce::String error;
+                auto instance = formatManager.createPluginInstance(*descriptions.getFirst(), pluginRate, pluginBlockSize, error);
+                if (instance == nullptr) { return -1.0; }
+                
+                instance->enableAllBuses();
+                instance->setRateAndBufferSizeDetails(pluginRate, pluginBlockSize);
+                instance->prepareToPlay(pluginRate, pluginBlockSize);
+                
+                const auto numChannels = juce::jmax(2, instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+                converter.prepare(sampleRate, blockSize, numChannels, factor);
+                juce::AudioBuffer<float> buffer(numChannels, blockSize);
+                juce::MidiBuffer midiMessages;
+                juce::Random random;
+                
+                auto process = [&](juce::AudioBuffer<float>& block, juce::MidiBuffer& midi) { instance->processBlock(block, midi); };
+                const auto numBlocks = (int) (secondsOfAudio * sampleRate / blockSize);
+                double elapsed = 0.0;
+                
+                for (int i = 0; i < numBlocks; ++i)
+                {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        for (int s = 0; s < blockSize; ++s) { buffer.setSample(ch, s, random.nextFloat() * 0.5f - 0.25f); }
+                    }
+                    
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    
+                    if (useConverter)
+                        converter.process(buffer, midiMessages, process);
+                    else
+                        process(buffer, midiMessages);
+                    
+                    elapsed += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                }
+                
+                instance->releaseResources();
+                return elapsed * 1000.0;
+            };
+            
+            const auto nativeMs = measure(false);
+            const auto reducedMs = measure(true);
+            
+            std::cout << sampleRate << "\t"
+                      << juce::String(nativeMs, 1) << "\t"
+                      << juce::String(reducedMs, 1) << "\t"
+                      << juce::String(reducedMs / juce::jmax(1.0e-9, nativeMs), 3) << std::endl;
+        }
+    }
+    
+    static void runMidiLearnBenchmark()
+    {
+        const auto results = MidiLearn::measureThroughput({ 64, 128, 256, 512, 1024, 2048 });
+        
+        std::cout << "block\tcc_events\tns_per_event\tslices_per_block" << std::endl;
+        for (const auto& result : results)
+        {
+            std::cout << result.blockSize << "\t"
+                      << result.eventsPerBlock << "\t"
+                      << juce::String(result.nanosecondsPerEvent, 2) << "\t"
+                      << juce::String(result.slicesPerBlock, 1) << std::endl;
+        }
+    }
+    
+    static void runInstrumentBenchmark(const juce::String& pluginPath)
+    {
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+        
+        juce::OwnedArray<juce::PluginDescription> descriptions;
+        if (!describePlugin(formatManager, pluginPath, descriptions)) { return; }
+        
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+        constexpr double secondsOfAudio = 10.0;
+        const double eventRates[] = { 0.0, 1000.0, 10000.0, 50000.0, 200000.0 };
+        
+        std::cout << "events_per_second\tevents_per_block\tmean_block_ms\tmax_block_ms\tdeadline_ms" << std::endl;
+        
+        for (const auto eventRate : eventRates)
+        {
+            juce::String error;
+            auto instance = formatManager.createPluginInstance(*descriptions.getFirst(), sampleRate, blockSize, error);
+            if (instance == nullptr)
+            {
+                std::cout << "Cannot create " << pluginPath << ": " << error << std::endl;
+                return;
+            }
+            
+            instance->enableAllBuses();
+            instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance->prepareToPlay(sampleRate, blockSize);
+            
+            const auto numChannels = juce::jmax(2, instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            
+            // 래퍼처럼 미리 잡아둔 버퍼에 노트 온/오프를 블록 안에 고르게 넣음 (블록마다 다시 할당하지 않음)
+            juce::MidiBuffer midiMessages;
+            midiMessages.ensureSize(65536);
+            
+            const auto numBlocks = (int) (secondsOfAudio * sampleRate / blockSize);
+            const auto eventsPerSample = eventRate / sampleRate;
+            double pendingEvents = 0.0;
+            int noteIndex = 0;
+            double totalSeconds = 0.0;
+            double maxSeconds = 0.0;
+            
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buffer.clear();
+                midiMessages.clear();
+                
+                pendingEvents += eventsPerSample * blockSize;
+                const auto numEvents = (int) pendingEvents;
+                pendingEvents -= numEvents;
+                
+                for (int e = 0; e < numEvents; ++e)
+                {
+                    const auto position = (e * blockSize) / numEvents;
+                    const auto noteNumber = 36 + (noteIndex / 2) % 60;
+                    const auto message = (noteIndex % 2) == 0 ? juce::MidiMessage::noteOn(1, noteNumber, (juce::uint8) 100)
+                                                              : juce::MidiMessage::noteOff(1, noteNumber);
+                    midiMessages.addEvent(message, position);
+                    ++noteIndex;
+                }
+                
+                const auto start = juce::Time::getHighResolutionTicks();
+                instance->processBlock(buffer, midiMessages);
+                const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                
+                totalSeconds += seconds;
+                maxSeconds = juce::jmax(maxSeconds, seconds);
+            }
+            
+            instance->releaseResources();
+            
+            std::cout << eventRate << "\t"
+                      << juce::String(eventsPerSample * blockSize, 1) << "\t"
+                      << juce::String(totalSeconds * 1000.0 / numBlocks, 4) << "\t"
+                      << juce::String(maxSeconds * 1000.0, 4) << "\t"
+                      << juce::String(blockSize * 1000.0 / sampleRate, 4) << std::endl;
+        }
+    }
+    
+    static void runBatchBenchmark(const juce::String& pluginPath)
+    {
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+        
+        juce::OwnedArray<juce::PluginDescription> descriptions;
+        if (!describePlugin(formatManager, pluginPath, descriptions)) { return; }
+        
+        // 스테레오 인스턴스 N 개를 따로 부를 때와 2N 채널 인스턴스 하나로 모아 부를 때 (모으고 나누는 복사 포함)
+        const auto results = SharedBatchEngine::measure(formatManager, *descriptions.getFirst(), { 2, 4, 8, 16 });
+        
+        std::cout << "instances\tchannels\tseparate_ms\tbatched_ms\tratio" << std::endl;
+        for (const auto& result : results)
+        {
+            std::cout << result.numInstances << "\t"
+                      << result.numChannels << "\t"
+                      << juce::String(result.separateMilliseconds, 1) << "\t";
+            
+            if (result.isSupported)
+                std::cout << juce::String(result.batchedMilliseconds, 1) << "\t"
+                          << juce::String(result.batchedMilliseconds / juce::jmax(1.0e-9, result.separateMilliseconds), 3) << std::endl;
+            else
+                std::cout << "unsupported\t-" << std::endl;
+        }
+    }
+    
+    static bool describePlugin(juce::AudioPluginFormatManager& formatManager,
+                               const juce::String& pluginPath,
+                               juce::OwnedArray<juce::PluginDescription>& descriptions)
+    {
+        for (auto* format : formatManager.getFormats())
+        {
+            if (format->fileMightContainThisPluginType(pluginPath))
+            {
+                format->findAllTypesForFile(descriptions, pluginPath);
+            }
+        }
+        
+        if (descriptions.isEmpty())
+        {
+            std::cout << "Cannot describe " << pluginPath << std::endl;
+            return false;
+        }
+        
+        return true;
+    }
+    
+    static bool runReplay(const juce::File& captureFile, const juce::String& pluginOverride)
+    {
+        SessionCapture::Reader reader(captureFile);
+        if (!reader.isValid())
+        {
+            std::cout << "Cannot read capture " << captureFile.getFullPathName() << std::endl;
+            return false;
+        }
+        
+        const auto& header = reader.getHeader();
+        const auto pluginPath = pluginOverride.isNotEmpty() ? pluginOverride : header.pluginPath;
+        
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+        
+        juce::OwnedArray<juce::PluginDescription> descriptions;
+        if (!describePlugin(formatManager, pluginPath, descriptions)) { return false; }
+        
+        juce::String error;
+        auto instance = formatManager.createPluginInstance(*descriptions.getFirst(), header.sampleRate, header.maxBlockSize, error);
+        if (instance == nullptr)
+        {
+            std::cout << "Cannot load " << pluginPath << ": " << error << std::endl;
+            return false;
+        }
+        
+        // 기록을 시작한 시점의 상태에서 같은 블록 경계로 처리해야 결과가 재현됨
+        instance->enableAllBuses();
+        instance->setRateAndBufferSizeDetails(header.sampleRate, header.maxBlockSize);
+        instance->prepareToPlay(header.sampleRate, header.maxBlockSize);
+        
+        if (!header.initialState.isEmpty())
+        {
+            instance->setStateInformation(header.initialState.getData(), (int) header.initialState.getSize());
+        }
+        
+        CapturedPlayHead playHead;
+        instance->setPlayHead(&playHead);
+        
+        const auto numChannels = juce::jmax(header.numChannels, instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, header.maxBlockSize);
+        juce::MidiBuffer midiMessages;
+        midiMessages.ensureSize(65536);
+        
+        struct BlockTiming
+        {
+            int index;
+            juce::uint32 sequence;
+            int numSamples;
+            double milliseconds;
+        };
+        
+        std::vector<BlockTiming> timings;
+        juce::String log = "block\tsequence\tsamples\tmidi_events\tms\tdeadline_ms\n";
+        juce::uint32 expectedSequence = 0;
+        int numGaps = 0;
+        
+        while (reader.readNextBlock(buffer, midiMessages, playHead.block))
+        {
+            const auto& block = playHead.block;
+            if (block.sequence != expectedSequence) { ++numGaps; }
+            expectedSequence = block.sequence + 1;
+            
+            juce::AudioBuffer<float> blockBuffer(buffer.getArrayOfWritePointers(), numChannels, block.numSamples);
+            const auto numMidiEvents = midiMessages.getNumEvents();
+            const auto start = juce::Time::getHighResolutionTicks();
+            
+            if (block.isActive)
+                instance->processBlock(blockBuffer, midiMessages);
+            else
+                instance->processBlockBypassed(blockBuffer, midiMessages);
+            
+            const auto milliseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+            const auto deadline = 1000.0 * block.numSamples / header.sampleRate;
+            
+            log << (int) timings.size() << "\t" << (juce::int64) block.sequence << "\t" << block.numSamples << "\t"
+                << numMidiEvents << "\t" << juce::String(milliseconds, 4) << "\t" << juce::String(deadline, 4) << "\n";
+            timings.push_back({ (int) timings.size(), block.sequence, block.numSamples, milliseconds });
+        }
+        
+        instance->releaseResources();
+        
+        if (timings.empty())
+        {
+            std::cout << "Capture contains no blocks" << std::endl;
+            return false;
+        }
+        
+        const auto reportFile = captureFile.getSiblingFile(captureFile.getFileNameWithoutExtension() + ".replay.tsv");
+        reportFile.replaceWithText(log);
+        
+        double totalMs = 0.0;
+        juce::int64 totalSamples = 0;
+        for (const auto& timing : timings)
+        {
+            totalMs += timing.milliseconds;
+            totalSamples += timing.numSamples;
+        }
+        
+        std::sort(timings.begin(), timings.end(), [](const auto& a, const auto& b) { return a.milliseconds > b.milliseconds; });
+        const auto p99 = timings[(size_t) ((double) timings.size() * 0.01)].milliseconds;
+        
+        std::cout << "plugin\t" << pluginPath << std::endl
+                  << "blocks\t" << timings.size() << " (" << numGaps << " gaps from dropped blocks)" << std::endl
+                  << "audio_s\t" << juce::String((double) totalSamples / header.sampleRate, 3) << std::endl
+                  << "total_ms\t" << juce::String(totalMs, 3) << std::endl
+                  << "mean_ms\t" << juce::String(totalMs / (double) timings.size(), 4) << std::endl
+                  << "p99_ms\t" << juce::String(p99, 4) << std::endl
+                  << "max_ms\t" << juce::String(timings.front().milliseconds, 4) << std::endl
+                  << std::endl << "slowest blocks" << std::endl << "block\tsequence\tsamples\tms" << std::endl;
+        
+        for (size_t i = 0; i < juce::jmin((size_t) 10, timings.size()); ++i)
+        {
+            const auto& timing = timings[i];
+            std::cout << timing.index << "\t" << (juce::int64) timing.sequence << "\t" << timing.numSamples << "\t"
+                      << juce::String(timing.milliseconds, 4) << std::endl;
+        }
+        
+        std::cout << std::endl << "per-block timings: " << reportFile.getFullPathName() << std::endl;
+        return true;
+    }
+    
+    static void printLoadReport()
+    {
+        // 플러그인이 남긴 세션 로그 중 가장 최근 것을 그대로 출력
+        juce::File latestLog;
+        for (const auto& log : LoadProfiler::getLogDirectory().findChildFiles(juce::File::findFiles, false, "load-*.tsv"))
+        {
+            if (latestLog == juce::File() || log.getLastModificationTime() > latestLog.getLastModificationTime())
+            {
+                latestLog = log;
+            }
+        }
+        
+        if (latestLog.existsAsFile())
+        {
+            std::cout << latestLog.loadFileAsString() << std::flush;
+        }
+    }
+};
+
+// 실시간 스트레스 테스트용 할당 훅. 플러그인 바이너리에는 없고 이 헬퍼에만 있음
+void* operator new(std::size_t size)
+{
+    RealtimeSafetyMonitor::noteAllocation();
+    
+    if (auto* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+START_JUCE_APPLICATION (VST3LoaderHostApplication)
@@ -0,0 +1,169 @@
+#include "RealtimeStressTest.h"
+
+// 호스트의 자동 저장처럼 메시지 스레드가 아닌 곳에서 상태를 읽음
+// 상태 복원은 호스팅 플러그인을 지우고 다시 만들 수 있으므로 메시지 스레드에서 함
+class RealtimeStressTest::StateThread : public juce::Thread
+{
+public:
+    explicit StateThread(VST3LoaderAudioProcessor& p) : juce::Thread("Realtime stress state"), processor(p) {}
+    
+    ~StateThread() override { stopThread(2000); }
+    
+    void run() override
+    {
+        juce::Random random;
+        juce::MemoryBlock state;
+        
+        while (!threadShouldExit())
+        {
+            processor.getStateInformation(state);
+            wait(1 + random.nextInt(5));
+        }
+    }
+    
+private:
+    VST3LoaderAudioProcessor& processor;
+};
+
+RealtimeStressTest::RealtimeStressTest(const juce::String& path, double seconds)
+    : juce::Thread("Realtime stress audio"),
+      processor(std::make_unique<VST3LoaderAudioProcessor>()),
+      pluginPath(path),
+      durationSeconds(seconds)
+{
+    stateThread = std::make_unique<StateThread>(*processor);
+}
+
+RealtimeStressTest::~RealtimeStressTest()
+{
+    stopTimer();
+    stopThread(5000);
+    stateThread.reset();
+    processor->closeHostedPlugin();
+}
+
+void RealtimeStressTest::start()
+{
+    processor->loadPluginInstance(std::make_unique<StubPluginInstance>(StubPluginInstance::gain));
+    
+    const auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(512, 48000.0);
+    if (!startRealtimeThread(options))
+    {
+        startThread(juce::Thread::Priority::highest);
+    }
+    
+    stateThread->startThread();
+    startTimer(lifecycleIntervalMs);
+}
+
+void RealtimeStressTest::run()
+{
+    static constexpr double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    static constexpr int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048 };
+    
+    juce::Random random;
+    juce::AudioBuffer<float> storage(2, blockSizes[juce::numElementsInArray(blockSizes) - 1]);
+    juce::MidiBuffer midiMessages;
+    midiMessages.ensureSize(4096);
+    
+    const auto deadline = juce::Time::getMillisecondCounterHiRes() + durationSeconds * 1000.0;
+    
+    while (!threadShouldExit() && juce::Time::getMillisecondCounterHiRes() < deadline)
+    {
+        // 호스트처럼 처리 중이 아닐 때만 설정을 바꿈
+        const auto sampleRate = sampleRates[random.nextInt(juce::numElementsInArray(sampleRates))];
+        const auto maxBlockSize = blockSizes[random.nextInt(juce::numElementsInArray(blockSizes))];
+        const auto channelSet = random.nextBool() ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        
+        auto layout = processor->getBusesLayout();
+        layout.inputBuses.getReference(0) = channelSet;
+        layout.outputBuses.getReference(0) = channelSet;
+        processor->setBusesLayout(layout);
+        
+        processor->setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor->prepareToPlay(sampleRate, maxBlockSize);
+        ++numConfigurations;
+        
+        const auto numChannels = juce::jmin(storage.getNumChannels(),
+                                            juce::jmax(processor->getTotalNumInputChannels(),
+                                                       processor->getTotalNumOutputChannels()));
+        
+        for (int i = 0; i < blocksPerConfiguration && !threadShouldExit(); ++i)
+        {
+            const auto numSamples = 1 + random.nextInt(maxBlockSize);
+            juce::AudioBuffer<float> buffer(storage.getArrayOfWritePointers(), numChannels, numSamples);
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                for (int s = 0; s < numSamples; ++s)
+                {
+                    data[s] = random.nextFloat() * 2.0f - 1.0f;
+                }
+            }
+            
+            midiMessages.clear();
+            if (random.nextInt(8) == 0)
+            {
+                midiMessages.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), random.nextInt(numSamples));
+            }
+            
+            if (random.nextInt(16) == 0)
+                processor->processBlockBypassed(buffer, midiMessages);
+            else
+                processor->processBlock(buffer, midiMessages);
+        }
+        
+        processor->releaseResources();
+    }
+}
+
+void RealtimeStressTest::timerCallback()
+{
+    if (!isThreadRunning())
+    {
+        stopTimer();
+        stateThread->stopThread(2000);
+        
+        if (onFinished != nullptr) { onFinished(createReport(), hasPassed()); }
+        return;
+    }
+    
+    ++numLifecycleCalls;
+    
+    switch (lifecycleRandom.nextInt(4))
+    {
+        case 0:
+            processor->loadPluginInstance(std::make_unique<StubPluginInstance>(StubPluginInstance::gain));
+            break;
+        case 1:
+            if (pluginPath.isNotEmpty())
+                processor->loadPlugin(pluginPath);
+            else
+                processor->loadPluginInstance(std::make_unique<StubPluginInstance>(StubPluginInstance::gain));
+            break;
+        case 2:
+            processor->closeHostedPlugin();
+            break;
+        default:
+            processor->reloadHostedPlugin();
+            break;
+    }
+}
+
+juce::String RealtimeStressTest::createReport() const
+{
+    const auto report = processor->getRealtimeSafetyReport();
+    
+    juce::String text;
+    text << "Configurations: " << numConfigurations.load() << "\n"
+         << "Load/close calls: " << numLifecycleCalls << "\n"
+         << report.toString();
+    return text;
+}
+
+bool RealtimeStressTest::hasPassed() const
+{
+    const auto report = processor->getRealtimeSafetyReport();
+    return report.numContendedLocks == 0 && report.numAllocations <= 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "StubPluginInstance.h"
+
+// 래퍼의 실시간 안전성 스트레스 테스트 (VST3LoaderHost --realtime-stress-test)
+// 별도의 래퍼 인스턴스를 만들어 오디오 스레드에서 샘플레이트/블록 크기/채널 수를 바꿔가며 processBlock 을 쉬지 않고 부르고,
+// 그동안 메시지 스레드는 로드/닫기/상태 복원을, 백그라운드 스레드는 상태 저장을 계속 호출함
+class RealtimeStressTest : private juce::Thread,
+                           private juce::Timer
+{
+public:
+    // pluginPath 가 비어 있지 않으면 스텁 플러그인과 번갈아 실제 플러그인도 로드함
+    RealtimeStressTest(const juce::String& pluginPath, double durationSeconds);
+    ~RealtimeStressTest() override;
+    
+    // 메시지 스레드에서 불림. 오디오 스레드에서 막힌 락이나 할당이 한 번이라도 있으면 passed 가 false
+    std::function<void(const juce::String& report, bool passed)> onFinished;
+    
+    void start();
+    bool isRunning() const { return isThreadRunning(); }
+    
+private:
+    class StateThread;
+    
+    std::unique_ptr<VST3LoaderAudioProcessor> processor;
+    std::unique_ptr<StateThread> stateThread;
+    juce::String pluginPath;
+    double durationSeconds;
+    juce::Random lifecycleRandom;
+    
+    std::atomic<int> numConfigurations { 0 };
+    int numLifecycleCalls = 0;
+    
+    static constexpr int blocksPerConfiguration = 200;
+    static constexpr int lifecycleIntervalMs = 20;
+    
+    void run() override;
+    void timerCallback() override;
+    juce::String createReport() const;
+    bool hasPassed() const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeStressTest)
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 헬퍼의 테스트와 벤치마크가 같이 쓰는, 하는 일이 정해진 가벼운 플러그인
+// 래퍼 자체의 비용과 락만 드러나게 함
+class StubPluginInstance : public juce::AudioPluginInstance
+{
+public:
+    enum Kind
+    {
+        passthrough,
+        gain,
+        spin
+    };
+    
+    // channels 가 비어 있으면 입력과 출력이 같은 어떤 레이아웃이든 받고, 아니면 그 채널 수만 받음
+    // (래퍼와 다른 채널 수로 고정해서 채널 재배치 경로를 타게 할 수 있음)
+    explicit StubPluginInstance(Kind k, const juce::AudioChannelSet& channels = juce::AudioChannelSet::disabled())
+        : AudioPluginInstance(BusesProperties()
+                              .withInput  ("Input",  channels.isDisabled() ? juce::AudioChannelSet::stereo() : channels, true)
+                              .withOutput ("Output", channels.isDisabled() ? juce::AudioChannelSet::stereo() : channels, true)),
+          kind(k),
+          channelSet(channels)
+    {
+    }
+    
+    static juce::String getKindName(Kind kind)
+    {
+        switch (kind)
+        {
+            case passthrough: return "passthrough";
+            case gain:        return "gain";
+            default:          return "spin";
+        }
+    }
+    
+    void fillInPluginDescription(juce::PluginDescription& description) const override
+    {
+        description.name = getName();
+        description.manufacturerName = "VST3 Loader";
+        description.pluginFormatName = "Internal";
+        description.numInputChannels = getTotalNumInputChannels();
+        description.numOutputChannels = getTotalNumOutputChannels();
+    }
+    
+    const juce::String getName() const override { return "Stub " + getKindName(kind); }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override
+    {
+        switch (kind)
+        {
+            case passthrough:
+                break;
+            
+            case gain:
+                buffer.applyGain(gainValue.load(std::memory_order_relaxed));
+                break;
+            
+            case spin:
+            {
+                const auto end = juce::Time::getHighResolutionTicks()
+                               + juce::Time::secondsToHighResolutionTicks(spinMicroseconds * 1.0e-6);
+                while (juce::Time::getHighResolutionTicks() < end) {}
+                break;
+            }
+        }
+    }
+    
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override
+    {
+        if (layouts.getMainInputChannelSet() != layouts.getMainOutputChannelSet()) { return false; }
+        return channelSet.isDisabled() || layouts.getMainOutputChannelSet() == channelSet;
+    }
+    
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    
+    // 상태는 게인 값 하나. 상태 저장/복원 경로도 실제로 타게 함
+    void getStateInformation(juce::MemoryBlock& destData) override
+    {
+        const auto value = gainValue.load();
+        destData.replaceAll(&value, sizeof(value));
+    }
+    
+    void setStateInformation(const void* data, int sizeInBytes) override
+    {
+        float value;
+        if (sizeInBytes != (int) sizeof(value)) { return; }
+        
+        std::memcpy(&value, data, sizeof(value));
+        gainValue.store(value);
+    }
+    
+private:
+    Kind kind;
+    juce::AudioChannelSet channelSet;
+    std::atomic<float> gainValue { -1.0f }; // 크기가 줄지 않아야 자동 절전에 걸리지 않음
+    
+    static constexpr double spinMicroseconds = 5.0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StubPluginInstance)
+};
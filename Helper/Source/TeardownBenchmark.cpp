@@ -0,0 +1,170 @@
+#include "TeardownBenchmark.h"
+
+TeardownBenchmark::SimulatedAudioThread::SimulatedAudioThread(std::function<void(juce::AudioBuffer<float>&, juce::MidiBuffer&)> p,
+                                                              int numChannels, int numSamples, double rate)
+    : juce::Thread("Simulated audio"), process(std::move(p)), buffer(numChannels, numSamples),
+      blockMilliseconds(numSamples * 1000.0 / rate)
+{
+    midiMessages.ensureSize(1024);
+}
+
+void TeardownBenchmark::SimulatedAudioThread::run()
+{
+    while (!threadShouldExit())
+    {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        buffer.clear();
+        midiMessages.clear();
+        process(buffer, midiMessages);
+        
+        const auto elapsed = juce::Time::getMillisecondCounterHiRes() - start;
+        worstBlockMilliseconds.store(juce::jmax(worstBlockMilliseconds.load(), elapsed));
+        wait(juce::jmax(1, (int) (blockMilliseconds - elapsed)));
+    }
+}
+
+TeardownBenchmark::TeardownBenchmark(const juce::String& path)
+    : pluginPath(path)
+{
+}
+
+TeardownBenchmark::~TeardownBenchmark()
+{
+    stopTimer();
+    if (audioThread != nullptr) { audioThread->stopThread(1000); }
+    if (processor != nullptr) { processor->closeHostedPlugin(); }
+}
+
+void TeardownBenchmark::start()
+{
+    lines.add("mode\tclose_ms\tteardown_ms\tworst_block_ms\tdeadline_ms");
+    
+    if (!measureUnderLock()) { return; }
+    
+    processor = std::make_unique<VST3LoaderAudioProcessor>();
+    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+    processor->loadPlugin(pluginPath);
+    stage = Stage::loading;
+    startTimer(5);
+}
+
+bool TeardownBenchmark::measureUnderLock()
+{
+    // 이전 방식: 오디오 스레드와 같은 락을 잡은 채 메시지 스레드에서 바로 지움
+    juce::AudioPluginFormatManager formatManager;
+    formatManager.addDefaultFormats();
+    
+    juce::OwnedArray<juce::PluginDescription> descriptions;
+    for (auto* format : formatManager.getFormats())
+    {
+        if (format->fileMightContainThisPluginType(pluginPath)) { format->findAllTypesForFile(descriptions, pluginPath); }
+    }
+    
+    juce::String error;
+    auto instance = descriptions.isEmpty() ? nullptr
+                                           : formatManager.createPluginInstance(*descriptions.getFirst(), sampleRate, blockSize, error);
+    if (instance == nullptr)
+    {
+        finish("Cannot create " + pluginPath + ": " + error);
+        return false;
+    }
+    
+    instance->enableAllBuses();
+    instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    instance->prepareToPlay(sampleRate, blockSize);
+    
+    juce::CriticalSection lock;
+    const auto numChannels = juce::jmax(2, instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+    SimulatedAudioThread underLockThread([&](juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+    {
+        const juce::ScopedLock sl(lock);
+        if (instance != nullptr) { instance->processBlock(buffer, midiMessages); }
+    }, numChannels, blockSize, sampleRate);
+    
+    underLockThread.startThread(juce::Thread::Priority::highest);
+    juce::Thread::sleep((int) warmUpMs);
+    underLockThread.resetWorstBlock();
+    
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    {
+        const juce::ScopedLock sl(lock);
+        instance.reset();
+    }
+    const auto teardownMs = juce::Time::getMillisecondCounterHiRes() - start;
+    
+    // 지우는 동안 밀린 블록이 끝나고 기록될 때까지 기다림
+    juce::Thread::sleep(50);
+    underLockThread.stopThread(1000);
+    
+    addLine("under_lock", teardownMs, teardownMs, underLockThread.getWorstBlockMilliseconds());
+    return true;
+}
+
+void TeardownBenchmark::timerCallback()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    
+    switch (stage)
+    {
+        case Stage::loading:
+        {
+            if (processor->isCurrentlyLoading()) { return; }
+            
+            if (!processor->isHostedPluginLoaded())
+            {
+                finish("Cannot load " + pluginPath);
+                return;
+            }
+            
+            const auto numChannels = juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
+            audioThread = std::make_unique<SimulatedAudioThread>([this](juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+            {
+                processor->processBlock(buffer, midiMessages);
+            }, numChannels, blockSize, sampleRate);
+            
+            audioThread->startThread(juce::Thread::Priority::highest);
+            stage = Stage::warmingUp;
+            stageStartMs = now;
+            return;
+        }
+        
+        case Stage::warmingUp:
+        {
+            if (now - stageStartMs < warmUpMs) { return; }
+            
+            // 래퍼가 닫는 경로 그대로: 락 안에서 떼어내고 회수기에 넘긴 뒤 바로 돌아옴
+            audioThread->resetWorstBlock();
+            stageStartMs = juce::Time::getMillisecondCounterHiRes();
+            processor->closeHostedPlugin();
+            closeMilliseconds = juce::Time::getMillisecondCounterHiRes() - stageStartMs;
+            stage = Stage::closing;
+            return;
+        }
+        
+        case Stage::closing:
+        {
+            if (instanceReclaimer->getNumPending() > 0) { return; }
+            
+            const auto teardownMs = now - stageStartMs;
+            juce::Thread::sleep(50);
+            audioThread->stopThread(1000);
+            
+            addLine("reclaimer", closeMilliseconds, teardownMs, audioThread->getWorstBlockMilliseconds());
+            finish(lines.joinIntoString("\n"));
+            return;
+        }
+    }
+}
+
+void TeardownBenchmark::addLine(const juce::String& mode, double closeMs, double teardownMs, double worstBlockMs)
+{
+    lines.add(mode + "\t" + juce::String(closeMs, 2) + "\t" + juce::String(teardownMs, 2) + "\t"
+              + juce::String(worstBlockMs, 3) + "\t" + juce::String(blockSize * 1000.0 / sampleRate, 3));
+}
+
+void TeardownBenchmark::finish(const juce::String& report)
+{
+    stopTimer();
+    if (onFinished != nullptr) { onFinished(report); }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/InstanceReclaimer.h"
+
+// 플러그인을 닫는 동안 오디오 스레드의 최악 블록 시간 (VST3LoaderHost --teardown-benchmark)
+// 이전 방식처럼 오디오 락을 잡은 채 인스턴스를 지울 때와, 래퍼의 closeHostedPlugin 으로 닫아 회수기가 지울 때를 비교
+// 회수기의 VST3 정리 단계는 메시지 스레드로 넘어오므로 메시지 루프를 돌리면서 끝날 때까지 기다림
+class TeardownBenchmark : private juce::Timer
+{
+public:
+    explicit TeardownBenchmark(const juce::String& pluginPath);
+    ~TeardownBenchmark() override;
+    
+    // 메시지 스레드에서 불림
+    std::function<void(const juce::String& report)> onFinished;
+    
+    void start();
+    
+private:
+    // 블록 길이마다 한 번씩 처리하면서 가장 오래 걸린 블록을 기록
+    class SimulatedAudioThread : public juce::Thread
+    {
+    public:
+        SimulatedAudioThread(std::function<void(juce::AudioBuffer<float>&, juce::MidiBuffer&)> process,
+                             int numChannels, int numSamples, double rate);
+        
+        double getWorstBlockMilliseconds() const { return worstBlockMilliseconds.load(); }
+        void resetWorstBlock() { worstBlockMilliseconds.store(0.0); }
+    
+    private:
+        std::function<void(juce::AudioBuffer<float>&, juce::MidiBuffer&)> process;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midiMessages;
+        const double blockMilliseconds;
+        std::atomic<double> worstBlockMilliseconds { 0.0 };
+        
+        void run() override;
+    };
+    
+    enum class Stage
+    {
+        loading,
+        warmingUp,
+        closing
+    };
+    
+    juce::String pluginPath;
+    juce::SharedResourcePointer<InstanceReclaimer> instanceReclaimer;
+    std::unique_ptr<VST3LoaderAudioProcessor> processor;
+    std::unique_ptr<SimulatedAudioThread> audioThread;
+    Stage stage = Stage::loading;
+    double stageStartMs = 0.0;
+    double closeMilliseconds = 0.0;
+    juce::StringArray lines;
+    
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr double warmUpMs = 500.0;
+    
+    bool measureUnderLock();
+    void addLine(const juce::String& mode, double closeMs, double teardownMs, double worstBlockMs);
+    void finish(const juce::String& report);
+    void timerCallback() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TeardownBenchmark)
+};
@@ -0,0 +1,108 @@
+#include "WrapperBenchmark.h"
+#include "StubPluginInstance.h"
+
+std::vector<WrapperBenchmark::Result> WrapperBenchmark::run()
+{
+    static constexpr int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const auto maxBlockSize = blockSizes[juce::numElementsInArray(blockSizes) - 1];
+    
+    VST3LoaderAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+    processor.prepareToPlay(sampleRate, maxBlockSize);
+    
+    std::vector<Result> results;
+    
+    for (const auto kind : { StubPluginInstance::passthrough, StubPluginInstance::gain, StubPluginInstance::spin })
+    {
+        // 래퍼는 스테레오, 플러그인은 스테레오(채널 수 일치) 또는 모노(불일치)
+        for (const auto pluginChannels : { wrapperChannels, 1 })
+        {
+            const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(pluginChannels);
+            
+            processor.loadPluginInstance(std::make_unique<StubPluginInstance>(kind, channelSet));
+            if (!processor.isHostedPluginLoaded()) { continue; }
+            
+            StubPluginInstance direct(kind, channelSet);
+            direct.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+            direct.prepareToPlay(sampleRate, maxBlockSize);
+            
+            for (const auto isActive : { true, false })
+            {
+                for (const auto blockSize : blockSizes)
+                {
+                    results.push_back(measure(processor, direct, StubPluginInstance::getKindName(kind),
+                                              pluginChannels, isActive, blockSize));
+                }
+            }
+            
+            processor.closeHostedPlugin();
+        }
+    }
+    
+    processor.releaseResources();
+    return results;
+}
+
+WrapperBenchmark::Result WrapperBenchmark::measure(VST3LoaderAudioProcessor& processor, juce::AudioPluginInstance& direct,
+                                                   const juce::String& stubName, int pluginChannels, bool isActive, int blockSize)
+{
+    juce::AudioBuffer<float> wrapperBuffer(wrapperChannels, blockSize);
+    juce::AudioBuffer<float> directBuffer(pluginChannels, blockSize);
+    juce::MidiBuffer midiMessages;
+    midiMessages.ensureSize(1024);
+    
+    // 무음이면 자동 절전으로 호출을 건너뛸 수 있으므로 작은 노이즈를 넣음
+    juce::Random random(42);
+    for (auto* buffer : { &wrapperBuffer, &directBuffer })
+    {
+        for (int ch = 0; ch < buffer->getNumChannels(); ++ch)
+        {
+            for (int s = 0; s < blockSize; ++s)
+            {
+                buffer->setSample(ch, s, random.nextFloat() * 0.1f - 0.05f);
+            }
+        }
+    }
+    
+    auto timeBlocks = [&](auto&& processOne, int numBlocks)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numBlocks; ++i) { processOne(); }
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        return elapsed * 1.0e9 / numBlocks;
+    };
+    
+    auto processDirect = [&]
+    {
+        midiMessages.clear();
+        if (isActive)
+            direct.processBlock(directBuffer, midiMessages);
+        else
+            direct.processBlockBypassed(directBuffer, midiMessages);
+    };
+    
+    auto processWrapped = [&]
+    {
+        midiMessages.clear();
+        if (isActive)
+            processor.processBlock(wrapperBuffer, midiMessages);
+        else
+            processor.processBlockBypassed(wrapperBuffer, midiMessages);
+    };
+    
+    // 한 번 돌려서 블록 수를 정하고, 번갈아 여러 번 재서 가장 빠른 값을 씀 (다른 작업의 간섭 제거)
+    const auto estimate = juce::jmax(1.0, timeBlocks(processWrapped, 16));
+    const auto numBlocks = juce::jlimit(16, 100000, (int) (targetMillisecondsPerRun * 1.0e6 / estimate));
+    
+    auto directNanoseconds = std::numeric_limits<double>::max();
+    auto wrapperNanoseconds = std::numeric_limits<double>::max();
+    
+    for (int repeat = 0; repeat < numRepeats; ++repeat)
+    {
+        directNanoseconds = juce::jmin(directNanoseconds, timeBlocks(processDirect, numBlocks));
+        wrapperNanoseconds = juce::jmin(wrapperNanoseconds, timeBlocks(processWrapped, numBlocks));
+    }
+    
+    const auto budget = fixedBudgetNanoseconds + perChannelSampleBudgetNanoseconds * wrapperChannels * blockSize;
+    return { stubName, pluginChannels, isActive, blockSize, directNanoseconds, wrapperNanoseconds, budget };
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+// 래퍼가 플러그인을 직접 호출하는 것에 비해 블록마다 얼마나 더 쓰는지 재는 마이크로벤치마크 (VST3LoaderHost --wrapper-benchmark)
+// 통과/게인/고정 비용 스텁 플러그인을 채널 수 일치/불일치, 활성/바이패스, 블록 16~4096 으로 조합해서
+// 래퍼의 processBlock 과 스텁의 processBlock 을 번갈아 재고, 차이가 예산을 넘으면 실패로 표시함
+// 래퍼의 로드와 닫기는 메시지 스레드 전용이므로 측정까지 모두 메시지 스레드에서 동기로 돌림
+class WrapperBenchmark
+{
+public:
+    struct Result
+    {
+        juce::String stub;
+        int pluginChannels;
+        bool isActive;
+        int blockSize;
+        double directNanoseconds;
+        double wrapperNanoseconds;
+        double budgetNanoseconds;
+        
+        double getOverheadNanoseconds() const { return wrapperNanoseconds - directNanoseconds; }
+        bool hasPassed() const { return getOverheadNanoseconds() <= budgetNanoseconds; }
+    };
+    
+    static std::vector<Result> run();
+    
+    // 블록마다 허용하는 래퍼 비용: 고정 비용 + 채널-샘플당 비용 (복사, NaN 검사, 마감 감시용 원음 지연)
+    static constexpr double fixedBudgetNanoseconds = 3000.0;
+    static constexpr double perChannelSampleBudgetNanoseconds = 1.5;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int wrapperChannels = 2;
+    
+private:
+    static constexpr int numRepeats = 5;
+    static constexpr double targetMillisecondsPerRun = 4.0;
+    
+    static Result measure(VST3LoaderAudioProcessor& processor, juce::AudioPluginInstance& direct,
+                          const juce::String& stubName, int pluginChannels, bool isActive, int blockSize);
+};
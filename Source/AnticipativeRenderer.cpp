@@ -0,0 +1,227 @@
+#include "AnticipativeRenderer.h"
+
+AnticipativeRenderer::AnticipativeRenderer(RenderCallback callback)
+    : juce::Thread("Anticipative renderer"), renderCallback(std::move(callback))
+{
+}
+
+AnticipativeRenderer::~AnticipativeRenderer()
+{
+    signalThreadShouldExit();
+    workAvailable.signal();
+    stopThread(1000);
+}
+
+void AnticipativeRenderer::prepare(double sampleRate, int maxBlockSize, int numChannels, int blocksAhead)
+{
+    signalThreadShouldExit();
+    workAvailable.signal();
+    stopThread(1000);
+    
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = juce::jmax(1, maxBlockSize);
+    latencySamples = juce::jlimit(1, maxBlocksAhead, blocksAhead) * preparedBlockSize;
+    
+    for (auto& slot : slots)
+    {
+        slot.audio.setSize(juce::jmax(1, numChannels), preparedBlockSize, false, true, false);
+        slot.midi.ensureSize(midiBufferBytes);
+        slot.midi.clear();
+        slot.index.store(-1);
+        slot.state.store(slotFree);
+    }
+    
+    writeIndex = 0;
+    readIndex = 0;
+    inputPosition = 0;
+    nextRenderIndex.store(0);
+    needsReset.store(false);
+    
+    startWorker();
+}
+
+void AnticipativeRenderer::startWorker()
+{
+    const auto options = juce::Thread::RealtimeOptions{}
+                             .withApproximateAudioProcessingTime(preparedBlockSize,
+                                                                 preparedSampleRate > 0.0 ? preparedSampleRate : 44100.0);
+    
+    if (!startRealtimeThread(options))
+    {
+        startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void AnticipativeRenderer::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool isActive,
+                                   juce::AudioPlayHead* playHead)
+{
+    if (needsReset.exchange(false))
+    {
+        discardPendingBlocks();
+    }
+    
+    const auto outputPosition = inputPosition - latencySamples;
+    
+    writeInput(buffer, midiMessages, isActive, playHead);
+    readOutput(buffer, midiMessages, outputPosition);
+}
+
+void AnticipativeRenderer::discardPendingBlocks()
+{
+    // 아직 렌더링 전인 블록은 건너뛰게 하고, 지연만큼 무음부터 다시 시작
+    for (auto index = readIndex; index < writeIndex; ++index)
+    {
+        auto expected = (int) slotPending;
+        slots[(size_t) (index % numSlots)].state.compare_exchange_strong(expected, slotSkipped);
+    }
+    
+    readIndex = writeIndex;
+    inputPosition = 0;
+    nextRenderIndex.store(writeIndex);
+}
+
+void AnticipativeRenderer::writeInput(const juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages,
+                                      bool isActive, juce::AudioPlayHead* playHead)
+{
+    const auto numSamples = buffer.getNumSamples();
+    auto& slot = slots[(size_t) (writeIndex % numSlots)];
+    const auto state = slot.state.load(std::memory_order_acquire);
+    
+    // 링이 가득 찼거나 블록이 너무 크면 입력을 버리고 해당 구간은 무음이 됨
+    if (writeIndex - readIndex >= numSlots || state == slotPending || state == slotRendering
+        || numSamples > slot.audio.getNumSamples())
+    {
+        ++numLateBlocks;
+        inputPosition += numSamples;
+        return;
+    }
+    
+    // 인덱스를 바꾸기 전에 비워둬야 작업 스레드가 이전 상태를 새 블록의 것으로 보지 않음
+    slot.state.store(slotFree, std::memory_order_release);
+    
+    for (int ch = 0; ch < slot.audio.getNumChannels(); ++ch)
+    {
+        if (ch < buffer.getNumChannels())
+            slot.audio.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+        else
+            slot.audio.clear(ch, 0, numSamples);
+    }
+    
+    slot.midi.clear();
+    slot.midi.addEvents(midiMessages, 0, numSamples, 0);
+    slot.position = playHead != nullptr ? playHead->getPosition() : juce::nullopt;
+    slot.startPosition = inputPosition;
+    slot.numSamples = numSamples;
+    slot.isActive = isActive;
+    slot.index.store(writeIndex, std::memory_order_release);
+    slot.state.store(slotPending, std::memory_order_release);
+    
+    ++writeIndex;
+    inputPosition += numSamples;
+    workAvailable.signal();
+}
+
+void AnticipativeRenderer::readOutput(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
+                                      juce::int64 outputPosition)
+{
+    const auto numSamples = buffer.getNumSamples();
+    const auto outputEnd = outputPosition + numSamples;
+    
+    buffer.clear();
+    midiMessages.clear();
+    
+    for (auto index = readIndex; index < writeIndex; ++index)
+    {
+        auto& slot = slots[(size_t) (index % numSlots)];
+        const auto slotEnd = slot.startPosition + slot.numSamples;
+        
+        if (slot.startPosition >= outputEnd) { break; }
+        
+        const auto state = slot.state.load(std::memory_order_acquire);
+        const auto overlapStart = juce::jmax(outputPosition, slot.startPosition);
+        const auto overlapEnd = juce::jmin(outputEnd, slotEnd);
+        
+        if (state == slotDone && overlapEnd > overlapStart)
+        {
+            const auto destOffset = (int) (overlapStart - outputPosition);
+            const auto sourceOffset = (int) (overlapStart - slot.startPosition);
+            const auto length = (int) (overlapEnd - overlapStart);
+            
+            for (int ch = 0; ch < juce::jmin(buffer.getNumChannels(), slot.audio.getNumChannels()); ++ch)
+            {
+                buffer.copyFrom(ch, destOffset, slot.audio, ch, sourceOffset, length);
+            }
+            
+            for (const auto metadata : slot.midi)
+            {
+                const auto position = slot.startPosition + metadata.samplePosition;
+                if (position >= overlapStart && position < overlapEnd)
+                {
+                    midiMessages.addEvent(metadata.data, metadata.numBytes, (int) (position - outputPosition));
+                }
+            }
+        }
+        
+        if (slotEnd > outputEnd) { break; }
+        
+        // 다 내보낸 슬롯: 아직 렌더링 전이면 작업 스레드가 건너뛰게 함
+        if (state != slotDone)
+        {
+            auto expected = (int) slotPending;
+            slot.state.compare_exchange_strong(expected, slotSkipped);
+            ++numLateBlocks;
+        }
+        
+        readIndex = index + 1;
+    }
+}
+
+void AnticipativeRenderer::run()
+{
+    while (!threadShouldExit())
+    {
+        auto index = nextRenderIndex.load(std::memory_order_acquire);
+        auto& slot = slots[(size_t) (index % numSlots)];
+        
+        const auto slotIndex = slot.index.load(std::memory_order_acquire);
+        
+        if (slotIndex < index)
+        {
+            workAvailable.wait(10);
+            continue;
+        }
+        
+        // 이미 다음 바퀴의 블록으로 바뀐 슬롯이면 이 블록은 건너뛴 것
+        if (slotIndex > index)
+        {
+            nextRenderIndex.compare_exchange_strong(index, index + 1);
+            continue;
+        }
+        
+        auto expected = (int) slotPending;
+        if (slot.state.compare_exchange_strong(expected, slotRendering, std::memory_order_acquire))
+        {
+            // 확인한 직후 오디오 스레드가 슬롯을 새 블록으로 바꿨으면 순서를 지키기 위해 돌려놓음
+            if (slot.index.load(std::memory_order_acquire) != index)
+            {
+                slot.state.store(slotPending, std::memory_order_release);
+                nextRenderIndex.compare_exchange_strong(index, index + 1);
+                continue;
+            }
+            
+            juce::AudioBuffer<float> block(slot.audio.getArrayOfWritePointers(), slot.audio.getNumChannels(),
+                                           slot.numSamples);
+            slotPlayHead.slot = &slot;
+            renderCallback(block, slot.midi, slot.isActive, &slotPlayHead);
+            slot.state.store(slotDone, std::memory_order_release);
+        }
+        else if (expected != slotSkipped && expected != slotDone)
+        {
+            workAvailable.wait(10);
+            continue;
+        }
+        
+        // 그 사이에 오디오 스레드가 리셋했으면 새 위치를 그대로 둠
+        nextRenderIndex.compare_exchange_strong(index, index + 1);
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인을 래퍼 소유의 실시간 스레드에서 몇 블록 앞서 처리하는 렌더러
+// 호스트 오디오 스레드는 입력을 슬롯에 복사하고, 지연만큼 앞서 끝난 결과를 가져오기만 함
+// 작업 스레드가 늦은 블록은 무음으로 내보내고 건너뛰어서 지연이 항상 일정하게 유지됨
+class AnticipativeRenderer : private juce::Thread
+{
+public:
+    using RenderCallback = std::function<void(juce::AudioBuffer<float>&, juce::MidiBuffer&, bool isActive, juce::AudioPlayHead*)>;
+    
+    static constexpr int maxBlocksAhead = 8;
+    
+    explicit AnticipativeRenderer(RenderCallback callback);
+    ~AnticipativeRenderer() override;
+    
+    // 메시지 스레드에서 호출 (process 와 동시에 호출하면 안 됨)
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, int blocksAhead);
+    void reset() { needsReset.store(true); }
+    int getLatencySamples() const { return latencySamples; }
+    juce::int64 getNumLateBlocks() const { return numLateBlocks.load(); }
+    
+    // 오디오 스레드에서 호출
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool isActive,
+                 juce::AudioPlayHead* playHead);
+    
+private:
+    enum SlotState { slotFree, slotPending, slotRendering, slotDone, slotSkipped };
+    
+    struct Slot
+    {
+        std::atomic<int> state { slotFree };
+        std::atomic<juce::int64> index { -1 };
+        juce::int64 startPosition = 0;
+        int numSamples = 0;
+        bool isActive = true;
+        juce::AudioBuffer<float> audio;
+        juce::MidiBuffer midi;
+        juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+    };
+    
+    // 작업 스레드에서는 호스트의 플레이헤드를 쓸 수 없으므로 블록마다 찍어둔 위치를 돌려줌
+    class SlotPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        juce::Optional<PositionInfo> getPosition() const override { return slot != nullptr ? slot->position : juce::nullopt; }
+        const Slot* slot = nullptr;
+    };
+    
+    static constexpr int numSlots = 32;
+    static constexpr int midiBufferBytes = 16384;
+    
+    RenderCallback renderCallback;
+    std::array<Slot, numSlots> slots;
+    SlotPlayHead slotPlayHead;
+    juce::WaitableEvent workAvailable;
+    
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+    int latencySamples = 0;
+    
+    // 오디오 스레드 전용
+    juce::int64 writeIndex = 0;
+    juce::int64 readIndex = 0;
+    juce::int64 inputPosition = 0;
+    
+    std::atomic<juce::int64> nextRenderIndex { 0 };
+    std::atomic<bool> needsReset { false };
+    std::atomic<juce::int64> numLateBlocks { 0 };
+    
+    void run() override;
+    void startWorker();
+    void discardPendingBlocks();
+    void writeInput(const juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages, bool isActive,
+                    juce::AudioPlayHead* playHead);
+    void readOutput(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, juce::int64 outputPosition);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnticipativeRenderer)
+};
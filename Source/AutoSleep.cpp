@@ -0,0 +1,12 @@
+#include "AutoSleep.h"
+
+void AutoSleep::prepare(double sampleRate, double tailLengthSeconds, int latencySamples, bool canSleep)
+{
+    if (!canSleep || !std::isfinite(tailLengthSeconds) || tailLengthSeconds > maxTailLengthSeconds || sampleRate <= 0.0)
+    {
+        silentSamplesBeforeSleep.store(-1);
+        return;
+    }
+    
+    silentSamplesBeforeSleep.store((juce::int64) std::ceil(tailLengthSeconds * sampleRate) + juce::jmax(0, latencySamples));
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 입력이 테일 길이보다 오래 무음이면 호스팅 플러그인 호출을 건너뛰고 무음을 출력
+// 소리가 들어온 블록은 바로 플러그인에 넘기므로 깨어날 때 잃는 샘플이 없음
+// MIDI 를 받거나 테일이 무한한 플러그인은 잠들지 않음
+class AutoSleep
+{
+public:
+    // 메시지 스레드에서 호출
+    void prepare(double sampleRate, double tailLengthSeconds, int latencySamples, bool canSleep);
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled); }
+    bool isEnabled() const { return enabled.load(); }
+    juce::int64 getNumSkippedBlocks() const { return numSkippedBlocks.load(); }
+    bool isSleeping() const { return sleeping.load(); }
+    
+    // 오디오 스레드에서 호출: true 면 이번 블록은 처리하지 말고 건너뜀 (버퍼는 이미 비워져 있음)
+    template<typename SampleType>
+    bool shouldSkipBlock(juce::AudioBuffer<SampleType>& buffer,
+                         const juce::MidiBuffer& midiMessages,
+                         int numInputChannels);
+    
+private:
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> sleeping { false };
+    std::atomic<juce::int64> numSkippedBlocks { 0 };
+    std::atomic<juce::int64> silentSamplesBeforeSleep { -1 }; // -1 이면 잠들지 않음
+    juce::int64 numSilentSamples = 0;
+    
+    static constexpr float silenceThreshold = 1.0e-6f; // 약 -120 dB
+    static constexpr double maxTailLengthSeconds = 60.0;
+    
+    void wakeUp()
+    {
+        numSilentSamples = 0;
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+};
+
+template<typename SampleType>
+bool AutoSleep::shouldSkipBlock(juce::AudioBuffer<SampleType>& buffer,
+                                const juce::MidiBuffer& midiMessages,
+                                int numInputChannels)
+{
+    const auto samplesBeforeSleep = silentSamplesBeforeSleep.load(std::memory_order_relaxed);
+    const auto numSamples = buffer.getNumSamples();
+    numInputChannels = juce::jmin(numInputChannels, buffer.getNumChannels());
+    
+    if (!enabled.load(std::memory_order_relaxed) || samplesBeforeSleep < 0 || numInputChannels <= 0)
+    {
+        wakeUp();
+        return false;
+    }
+    
+    auto isSilent = midiMessages.isEmpty();
+    
+    // getMagnitude 는 채널마다 벡터화된 findMinAndMax 한 번으로 끝남
+    for (int ch = 0; ch < numInputChannels && isSilent; ++ch)
+    {
+        isSilent = buffer.getMagnitude(ch, 0, numSamples) < (SampleType) silenceThreshold;
+    }
+    
+    if (!isSilent)
+    {
+        wakeUp();
+        return false;
+    }
+    
+    // 테일과 지연이 다 빠질 때까지는 계속 처리
+    if (numSilentSamples < samplesBeforeSleep)
+    {
+        numSilentSamples += numSamples;
+        return false;
+    }
+    
+    sleeping.store(true, std::memory_order_relaxed);
+    numSkippedBlocks.fetch_add(1, std::memory_order_relaxed);
+    buffer.clear();
+    return true;
+}
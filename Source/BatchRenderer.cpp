@@ -0,0 +1,302 @@
+#include "BatchRenderer.h"
+#include "PluginProcessor.h"
+
+class BatchRenderer::Worker : public juce::ThreadPoolJob
+{
+public:
+    explicit Worker(BatchRenderer& o) : juce::ThreadPoolJob("Batch render worker"), owner(o) {}
+    
+    // 취소로 시작하지 못하고 지워진 작업도 끝난 것으로 세야 isRunning 이 풀림
+    ~Worker() override
+    {
+        owner.workerFinished();
+    }
+
+    JobStatus runJob() override
+    {
+        while (!shouldExit())
+        {
+            const auto index = owner.nextFileIndex.fetch_add(1);
+            if (index >= owner.settings.inputFiles.size()) { break; }
+            
+            const auto& file = owner.settings.inputFiles.getReference(index);
+            juce::String error;
+            
+            if (!renderFile(file, owner.outputFiles.getReference(index), error))
+            {
+                owner.addError(file.getFileName() + ": " + error);
+            }
+            
+            ++owner.numFilesDone;
+        }
+        
+        if (instance != nullptr)
+        {
+            instance->releaseResources();
+            instance.reset();
+        }
+        
+        return jobHasFinished;
+    }
+    
+private:
+    BatchRenderer& owner;
+    std::unique_ptr<juce::AudioPluginInstance> instance;
+    double preparedSampleRate = 0.0;
+    
+    bool prepareInstance(double sampleRate, juce::String& error)
+    {
+        const auto blockSize = owner.settings.blockSize;
+        
+        if (instance == nullptr)
+        {
+            // 생성 자체는 메시지 스레드에서 일어나고, 이 워커는 완료될 때까지 대기함
+            instance = owner.pluginFormats.createPluginInstance(owner.pluginDescription,
+                                                                sampleRate, blockSize, error);
+            if (instance == nullptr)
+            {
+                if (error.isEmpty()) { error = "Unexpected error occurred"; }
+                return false;
+            }
+            
+            instance->enableAllBuses();
+            instance->setNonRealtime(true);
+            instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance->prepareToPlay(sampleRate, blockSize);
+            
+            if (!owner.innerState.isEmpty())
+            {
+                instance->setStateInformation(owner.innerState.getData(),
+                                              (int) owner.innerState.getSize());
+            }
+        }
+        else if (preparedSampleRate != sampleRate)
+        {
+            instance->releaseResources();
+            instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance->prepareToPlay(sampleRate, blockSize);
+        }
+        
+        instance->reset();
+        preparedSampleRate = sampleRate;
+        return true;
+    }
+    
+    bool renderFile(const juce::File& file, const juce::File& outputFile, juce::String& error)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(owner.audioFormats.createReaderFor(file));
+        if (reader == nullptr)
+        {
+            error = "Unsupported audio file";
+            return false;
+        }
+        
+        if (!prepareInstance(reader->sampleRate, error)) { return false; }
+        
+        outputFile.deleteFile();
+        
+        auto stream = outputFile.createOutputStream();
+        if (stream == nullptr)
+        {
+            error = "Cannot write " + outputFile.getFullPathName();
+            return false;
+        }
+        
+        const auto numFileChannels = (int) reader->numChannels;
+        
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(),
+                                                                                  reader->sampleRate,
+                                                                                  (unsigned int) numFileChannels,
+                                                                                  32, {}, 0));
+        if (writer == nullptr)
+        {
+            error = "Cannot create output writer";
+            return false;
+        }
+        stream.release();
+        
+        const auto blockSize = owner.settings.blockSize;
+        const auto numChannels = juce::jmax(numFileChannels,
+                                            instance->getTotalNumInputChannels(),
+                                            instance->getTotalNumOutputChannels());
+        
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midiMessages;
+        juce::HeapBlock<const float*> outputChannels((size_t) numFileChannels + 1, true);
+        
+        // 지연만큼 앞부분을 버리고, 입력이 끝난 뒤에는 테일 길이만큼 무음을 더 흘려보냄
+        const auto tailSeconds = juce::jlimit(0.0, maxTailSeconds, instance->getTailLengthSeconds());
+        const auto inputLength = reader->lengthInSamples;
+        const auto outputLength = inputLength + (juce::int64) (tailSeconds * reader->sampleRate);
+        auto samplesToSkip = (juce::int64) instance->getLatencySamples();
+        juce::int64 readPosition = 0;
+        juce::int64 numWritten = 0;
+        
+        while (numWritten < outputLength)
+        {
+            if (shouldExit())
+            {
+                error = "Cancelled";
+                return false;
+            }
+            
+            buffer.clear();
+            
+            const auto numToRead = (int) juce::jlimit((juce::int64) 0, (juce::int64) blockSize, inputLength - readPosition);
+            if (numToRead > 0)
+            {
+                reader->read(&buffer, 0, numToRead, readPosition, true, true);
+                readPosition += numToRead;
+            }
+            
+            instance->processBlock(buffer, midiMessages);
+            midiMessages.clear();
+            
+            const auto skipped = (int) juce::jmin((juce::int64) blockSize, samplesToSkip);
+            samplesToSkip -= skipped;
+            
+            const auto numToWrite = (int) juce::jmin((juce::int64) (blockSize - skipped), outputLength - numWritten);
+            if (numToWrite <= 0) { continue; }
+            
+            for (int ch = 0; ch < numFileChannels; ++ch)
+            {
+                outputChannels[ch] = buffer.getReadPointer(ch, skipped);
+            }
+            
+            if (!writer->writeFromFloatArrays(outputChannels, numFileChannels, numToWrite))
+            {
+                error = "Write failed";
+                return false;
+            }
+            
+            numWritten += numToWrite;
+        }
+        
+        return true;
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+};
+
+BatchRenderer::BatchRenderer(Settings settingsToUse)
+    : settings(std::move(settingsToUse)),
+      outputFiles(getOutputFiles(settings)),
+      threadPool(getNumWorkers(settings))
+{
+    pluginFormats.addDefaultFormats();
+    audioFormats.registerBasicFormats();
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    cancel();
+}
+
+int BatchRenderer::getNumWorkers(const Settings& s)
+{
+    const auto numCores = s.numWorkers > 0 ? s.numWorkers : juce::SystemStats::getNumCpus();
+    return juce::jlimit(1, juce::jmax(1, s.inputFiles.size()), numCores);
+}
+
+juce::Array<juce::File> BatchRenderer::getOutputFiles(const Settings& s)
+{
+    // 다른 폴더나 확장자에서 온 같은 이름의 파일이 서로 덮어쓰지 않도록 번호를 붙임
+    juce::Array<juce::File> result;
+    juce::StringArray usedNames;
+    
+    for (const auto& inputFile : s.inputFiles)
+    {
+        const auto baseName = inputFile.getFileNameWithoutExtension();
+        auto name = baseName;
+        
+        for (int suffix = 2; usedNames.contains(name, true); ++suffix)
+        {
+            name = baseName + " (" + juce::String(suffix) + ")";
+        }
+        
+        usedNames.add(name);
+        result.add(s.outputDirectory.getChildFile(name + ".wav"));
+    }
+    
+    return result;
+}
+
+void BatchRenderer::start()
+{
+    juce::String pluginPath;
+    juce::String error;
+    
+    if (VST3LoaderAudioProcessor::parseWrapperState(settings.wrapperState.getData(),
+                                                    (int) settings.wrapperState.getSize(),
+                                                    pluginPath, innerState) == nullptr
+        || !VST3LoaderAudioProcessor::findHostablePluginDescription(pluginFormats, pluginPath,
+                                                                    pluginDescription, error))
+    {
+        addError(error.isEmpty() ? juce::String("Invalid wrapper state") : error);
+        numActiveWorkers = 1;
+        workerFinished();
+        return;
+    }
+    
+    if (settings.outputDirectory.createDirectory().failed())
+    {
+        addError("Cannot create " + settings.outputDirectory.getFullPathName());
+        numActiveWorkers = 1;
+        workerFinished();
+        return;
+    }
+    
+    const auto numWorkers = getNumWorkers(settings);
+    numActiveWorkers = numWorkers;
+    
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        threadPool.addJob(new Worker(*this), true);
+    }
+}
+
+void BatchRenderer::cancel()
+{
+    threadPool.removeAllJobs(true, 10000);
+}
+
+bool BatchRenderer::isRunning() const
+{
+    return numActiveWorkers.load() > 0;
+}
+
+juce::String BatchRenderer::getStatusText() const
+{
+    const auto progress = juce::String(getNumFilesDone()) + "/" + juce::String(getNumFiles());
+    
+    if (isRunning()) { return "Rendering " + progress; }
+    
+    const auto numErrors = getErrors().size();
+    return "Rendered " + progress + (numErrors > 0 ? " (" + juce::String(numErrors) + " failed)" : juce::String());
+}
+
+juce::StringArray BatchRenderer::getErrors() const
+{
+    const juce::ScopedLock sl(errorLock);
+    return errors;
+}
+
+void BatchRenderer::addError(const juce::String& message)
+{
+    const juce::ScopedLock sl(errorLock);
+    errors.add(message);
+}
+
+void BatchRenderer::workerFinished()
+{
+    if (--numActiveWorkers > 0) { return; }
+    
+    juce::MessageManager::callAsync([weakThis = juce::WeakReference<BatchRenderer>(this)]()
+    {
+        if (weakThis != nullptr && weakThis->onFinished != nullptr)
+        {
+            weakThis->onFinished();
+        }
+    });
+}
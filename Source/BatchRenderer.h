@@ -0,0 +1,60 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 저장된 래퍼 상태로 여러 오디오 파일을 오프라인 렌더링
+// (워커 코어당 호스팅 인스턴스 하나, 파일은 큰 블록 단위로 스트리밍)
+class BatchRenderer
+{
+public:
+    struct Settings
+    {
+        juce::MemoryBlock wrapperState;
+        juce::Array<juce::File> inputFiles;
+        juce::File outputDirectory;
+        int blockSize = 8192;
+        int numWorkers = 0; // 0 = CPU 코어 수
+    };
+    
+    explicit BatchRenderer(Settings settingsToUse);
+    ~BatchRenderer();
+    
+    void start();
+    void cancel();
+    bool isRunning() const;
+    int getNumFilesDone() const { return numFilesDone.load(); }
+    int getNumFiles() const { return settings.inputFiles.size(); }
+    juce::String getStatusText() const;
+    juce::StringArray getErrors() const;
+    
+    // 메시지 스레드에서 호출됨
+    std::function<void()> onFinished;
+    
+private:
+    class Worker;
+    
+    Settings settings;
+    juce::AudioPluginFormatManager pluginFormats;
+    juce::AudioFormatManager audioFormats;
+    juce::PluginDescription pluginDescription;
+    juce::MemoryBlock innerState;
+    juce::Array<juce::File> outputFiles; // inputFiles 와 같은 순서
+    juce::ThreadPool threadPool;
+    
+    std::atomic<int> nextFileIndex { 0 };
+    std::atomic<int> numFilesDone { 0 };
+    std::atomic<int> numActiveWorkers { 0 };
+    
+    juce::CriticalSection errorLock;
+    juce::StringArray errors;
+    
+    static constexpr double maxTailSeconds = 30.0;
+    
+    void addError(const juce::String& message);
+    void workerFinished();
+    
+    static int getNumWorkers(const Settings& s);
+    static juce::Array<juce::File> getOutputFiles(const Settings& s);
+    
+    JUCE_DECLARE_WEAK_REFERENCEABLE (BatchRenderer)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchRenderer)
+};
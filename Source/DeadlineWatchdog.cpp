@@ -0,0 +1,145 @@
+#include "DeadlineWatchdog.h"
+#include "LoadProfiler.h"
+
+void DeadlineWatchdog::prepare(double newSampleRate, int newMaxBlockSize, int numChannels, int latencySamples)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    delaySamples = juce::jmax(0, latencySamples);
+    numChannels = juce::jmax(1, numChannels);
+    
+    dryDelayLine.setSize(numChannels, delaySamples + maxBlockSize);
+    dryDelayLine.clear();
+    dryBuffer.setSize(numChannels, maxBlockSize);
+    probeBuffer.setSize(numChannels, maxBlockSize);
+    probeMidi.ensureSize(midiBufferBytes);
+    delayWritePosition = 0;
+    
+    consecutiveOverruns = 0;
+    state.store(State::active);
+}
+
+void DeadlineWatchdog::setPluginName(const juce::String& name)
+{
+    const juce::ScopedLock sl(nameLock);
+    pluginName = name;
+}
+
+juce::String DeadlineWatchdog::getWarningText() const
+{
+    if (!isBypassing()) { return {}; }
+    
+    const auto since = juce::Time(bypassedSinceMilliseconds.load()).formatted("%H:%M:%S");
+    return "Plugin missed the block deadline - bypassed (dry) since " + since;
+}
+
+juce::File DeadlineWatchdog::getLogFile()
+{
+    return LoadProfiler::getLogDirectory().getChildFile("watchdog-" + juce::Time::getCurrentTime().formatted("%Y-%m-%d") + ".tsv");
+}
+
+void DeadlineWatchdog::pushDry(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    const auto delayLength = dryDelayLine.getNumSamples();
+    const auto readPosition = (delayWritePosition - delaySamples + delayLength) % delayLength;
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        // 쓰기를 먼저 해서 지연이 0 이어도 같은 코드로 처리됨
+        const auto firstWrite = juce::jmin(numSamples, delayLength - delayWritePosition);
+        dryDelayLine.copyFrom(ch, delayWritePosition, buffer, ch, 0, firstWrite);
+        dryDelayLine.copyFrom(ch, 0, buffer, ch, firstWrite, numSamples - firstWrite);
+        
+        const auto firstRead = juce::jmin(numSamples, delayLength - readPosition);
+        dryBuffer.copyFrom(ch, 0, dryDelayLine, ch, readPosition, firstRead);
+        dryBuffer.copyFrom(ch, firstRead, dryDelayLine, ch, 0, numSamples - firstRead);
+    }
+    
+    delayWritePosition = (delayWritePosition + numSamples) % delayLength;
+}
+
+void DeadlineWatchdog::copyDry(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) const
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (ch < numChannels)
+            buffer.copyFrom(ch, 0, dryBuffer, ch, 0, numSamples);
+        else
+            buffer.clear(ch, 0, numSamples);
+    }
+}
+
+void DeadlineWatchdog::crossfade(juce::AudioBuffer<float>& wet, int numChannels, int numSamples, bool towardsDry) const
+{
+    // 블록 하나에 걸친 선형 크로스페이드
+    const auto wetStart = towardsDry ? 1.0f : 0.0f;
+    const auto wetEnd = towardsDry ? 0.0f : 1.0f;
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        wet.applyGainRamp(ch, 0, numSamples, wetStart, wetEnd);
+        wet.addFromWithRamp(ch, 0, dryBuffer.getReadPointer(ch), numSamples, 1.0f - wetStart, 1.0f - wetEnd);
+    }
+}
+
+void DeadlineWatchdog::enterBypass(EventType type, double blockMilliseconds, double deadlineMilliseconds)
+{
+    samplesUntilProbe = probeIntervalSamples;
+    
+    if (type == bypassed)
+    {
+        numBypasses.fetch_add(1, std::memory_order_relaxed);
+        bypassedSinceMilliseconds.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+    }
+    
+    state.store(State::bypassed, std::memory_order_relaxed);
+    postEvent(type, blockMilliseconds, deadlineMilliseconds);
+}
+
+void DeadlineWatchdog::postEvent(EventType type, double blockMilliseconds, double deadlineMilliseconds)
+{
+    // 가득 차면 버림 (로그보다 오디오 스레드가 우선)
+    const auto scope = eventFifo.write(1);
+    if (scope.blockSize1 > 0)
+    {
+        events[(size_t) scope.startIndex1] = { type, juce::Time::currentTimeMillis(), blockMilliseconds,
+                                               deadlineMilliseconds, consecutiveOverruns };
+    }
+    
+    triggerAsyncUpdate();
+}
+
+void DeadlineWatchdog::handleAsyncUpdate()
+{
+    juce::String name;
+    {
+        const juce::ScopedLock sl(nameLock);
+        name = pluginName;
+    }
+    
+    const auto logFile = getLogFile();
+    if (!logFile.exists())
+    {
+        logFile.create();
+        logFile.appendText("time\tplugin\tevent\tblock_ms\tdeadline_ms\tconsecutive_overruns\n");
+    }
+    
+    static const char* eventNames[] = { "bypassed", "probe_failed", "restored" };
+    
+    while (eventFifo.getNumReady() > 0)
+    {
+        const auto scope = eventFifo.read(1);
+        if (scope.blockSize1 <= 0) { break; }
+        
+        const auto& event = events[(size_t) scope.startIndex1];
+        const juce::StringArray fields { juce::Time(event.timeMilliseconds).toISO8601(true),
+                                         name,
+                                         eventNames[event.type],
+                                         juce::String(event.blockMilliseconds, 3),
+                                         juce::String(event.deadlineMilliseconds, 3),
+                                         juce::String(event.consecutiveOverruns) };
+        logFile.appendText(fields.joinIntoString("\t") + "\n");
+    }
+    
+    if (onStateChanged != nullptr) { onStateChanged(); }
+}
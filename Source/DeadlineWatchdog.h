@@ -0,0 +1,199 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인의 블록 처리 시간을 마감 시간(블록 길이의 deadlineFraction)과 비교하는 감시자 (기본: 꺼짐)
+// 정해진 횟수만큼 연속으로 넘기면 그 블록 안에서 지연을 맞춘 원음으로 크로스페이드해 우회하고,
+// 잠시 뒤 입력 복사본으로 플러그인을 시험해서 계속 제시간이면 다시 크로스페이드해 되돌림
+class DeadlineWatchdog : private juce::AsyncUpdater
+{
+public:
+    enum EventType
+    {
+        bypassed,
+        probeFailed,
+        restored
+    };
+    
+    struct Event
+    {
+        EventType type;
+        juce::int64 timeMilliseconds;
+        double blockMilliseconds;
+        double deadlineMilliseconds;
+        int consecutiveOverruns;
+    };
+    
+    DeadlineWatchdog() = default;
+    ~DeadlineWatchdog() override { cancelPendingUpdate(); }
+    
+    // 메시지 스레드에서 호출
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, int latencySamples);
+    void setPluginName(const juce::String& name);
+    void setMaxConsecutiveOverruns(int numOverruns) { maxConsecutiveOverruns.store(juce::jmax(0, numOverruns)); }
+    int getMaxConsecutiveOverruns() const { return maxConsecutiveOverruns.load(); }
+    bool isBypassing() const { return state.load() != State::active; }
+    juce::int64 getNumBypasses() const { return numBypasses.load(); }
+    juce::String getWarningText() const;
+    
+    static juce::File getLogFile();
+    
+    // 우회/시험 실패/복귀가 기록된 뒤 메시지 스레드에서 불림
+    std::function<void()> onStateChanged;
+    
+    // 오디오 스레드에서 호출 (processPlugin 은 버퍼와 MIDI 를 받아 호스팅 플러그인을 부름)
+    template<typename ProcessFunction>
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, ProcessFunction&& processPlugin);
+    
+private:
+    enum class State
+    {
+        active,
+        bypassed,
+        probing
+    };
+    
+    std::atomic<State> state { State::active };
+    std::atomic<int> maxConsecutiveOverruns { 0 };
+    std::atomic<juce::int64> numBypasses { 0 };
+    std::atomic<juce::int64> bypassedSinceMilliseconds { 0 };
+    
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int consecutiveOverruns = 0;
+    int numProbeSuccesses = 0;
+    int samplesUntilProbe = 0;
+    int probeIntervalSamples = 0;
+    
+    // 플러그인 지연만큼 늦춘 원음
+    juce::AudioBuffer<float> dryDelayLine;
+    juce::AudioBuffer<float> dryBuffer;
+    juce::AudioBuffer<float> probeBuffer;
+    juce::MidiBuffer probeMidi;
+    int delaySamples = 0;
+    int delayWritePosition = 0;
+    
+    std::array<Event, 32> events {};
+    juce::AbstractFifo eventFifo { 32 };
+    juce::CriticalSection nameLock;
+    juce::String pluginName;
+    
+    // 래퍼와 호스트의 나머지 처리도 같은 블록 안에 끝나야 하므로 블록 길이 전체를 쓰지 않음
+    static constexpr double deadlineFraction = 0.8;
+    static constexpr double firstProbeDelaySeconds = 2.0;
+    static constexpr double maxProbeDelaySeconds = 30.0;
+    static constexpr int probeBlocksBeforeRestore = 16;
+    static constexpr int midiBufferBytes = 16384;
+    
+    void pushDry(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
+    void copyDry(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) const;
+    void crossfade(juce::AudioBuffer<float>& wet, int numChannels, int numSamples, bool towardsDry) const;
+    void enterBypass(EventType type, double blockMilliseconds, double deadlineMilliseconds);
+    void postEvent(EventType type, double blockMilliseconds, double deadlineMilliseconds);
+    
+    void handleAsyncUpdate() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeadlineWatchdog)
+};
+
+template<typename ProcessFunction>
+void DeadlineWatchdog::process(juce::AudioBuffer<float>& buffer,
+                               juce::MidiBuffer& midiMessages,
+                               ProcessFunction&& processPlugin)
+{
+    const auto numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), dryBuffer.getNumChannels());
+    
+    if (maxConsecutiveOverruns.load(std::memory_order_relaxed) <= 0 || numSamples > maxBlockSize || numSamples <= 0)
+    {
+        state.store(State::active, std::memory_order_relaxed);
+        processPlugin(buffer, midiMessages);
+        return;
+    }
+    
+    pushDry(buffer, numChannels, numSamples);
+    const auto deadlineMilliseconds = deadlineFraction * 1000.0 * numSamples / sampleRate;
+    
+    auto timed = [](auto&& function)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        function();
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+    };
+    
+    switch (state.load(std::memory_order_relaxed))
+    {
+        case State::active:
+        {
+            const auto elapsed = timed([&] { processPlugin(buffer, midiMessages); });
+            
+            if (elapsed <= deadlineMilliseconds)
+            {
+                consecutiveOverruns = 0;
+                return;
+            }
+            
+            if (++consecutiveOverruns < maxConsecutiveOverruns.load(std::memory_order_relaxed)) { return; }
+            
+            crossfade(buffer, numChannels, numSamples, true);
+            probeIntervalSamples = (int) (firstProbeDelaySeconds * sampleRate);
+            enterBypass(bypassed, elapsed, deadlineMilliseconds);
+            return;
+        }
+        
+        case State::bypassed:
+        {
+            copyDry(buffer, numChannels, numSamples);
+            
+            if ((samplesUntilProbe -= numSamples) <= 0)
+            {
+                numProbeSuccesses = 0;
+                state.store(State::probing, std::memory_order_relaxed);
+            }
+            return;
+        }
+        
+        case State::probing:
+        {
+            // 출력은 원음으로 두고, 입력 복사본으로 플러그인을 돌려 시간만 잼
+            const auto numProbeChannels = juce::jmin(buffer.getNumChannels(), probeBuffer.getNumChannels());
+            for (int ch = 0; ch < numProbeChannels; ++ch)
+            {
+                probeBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+            }
+            
+            juce::AudioBuffer<float> probe(probeBuffer.getArrayOfWritePointers(), numProbeChannels, numSamples);
+            probeMidi.clear();
+            probeMidi.addEvents(midiMessages, 0, numSamples, 0);
+            
+            const auto elapsed = timed([&] { processPlugin(probe, probeMidi); });
+            
+            if (elapsed > deadlineMilliseconds)
+            {
+                copyDry(buffer, numChannels, numSamples);
+                probeIntervalSamples = juce::jmin(probeIntervalSamples * 2, (int) (maxProbeDelaySeconds * sampleRate));
+                enterBypass(probeFailed, elapsed, deadlineMilliseconds);
+                return;
+            }
+            
+            if (++numProbeSuccesses < probeBlocksBeforeRestore)
+            {
+                copyDry(buffer, numChannels, numSamples);
+                return;
+            }
+            
+            // 원음에서 플러그인 출력으로 크로스페이드
+            for (int ch = 0; ch < numProbeChannels; ++ch)
+            {
+                buffer.copyFrom(ch, 0, probeBuffer, ch, 0, numSamples);
+            }
+            
+            crossfade(buffer, numChannels, numSamples, false);
+            midiMessages.clear();
+            midiMessages.addEvents(probeMidi, 0, -1, 0);
+            consecutiveOverruns = 0;
+            state.store(State::active, std::memory_order_relaxed);
+            postEvent(restored, elapsed, deadlineMilliseconds);
+            return;
+        }
+    }
+}
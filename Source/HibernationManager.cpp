@@ -0,0 +1,210 @@
+#include "HibernationManager.h"
+#include "LoadProfiler.h"
+
+HibernationManager::HibernationManager()
+{
+    memoryBudgetBytes.store((juce::int64) settings->getInt(budgetKey, 0) * 1024 * 1024);
+    startTimer(checkIntervalMs);
+}
+
+HibernationManager::~HibernationManager()
+{
+    stopTimer();
+}
+
+void HibernationManager::setMemoryBudgetBytes(juce::int64 budgetBytes)
+{
+    memoryBudgetBytes.store(juce::jmax((juce::int64) 0, budgetBytes));
+    settings->set(budgetKey, (int) (getMemoryBudgetBytes() / (1024 * 1024)));
+}
+
+juce::String HibernationManager::getStatusText() const
+{
+    if (getMemoryBudgetBytes() <= 0) { return "off"; }
+    
+    int numHibernating = 0;
+    juce::int64 totalSavedBytes = 0;
+    double lastWakeMilliseconds = 0.0;
+    
+    {
+        const juce::ScopedLock sl(lock);
+        for (auto* client : clients)
+        {
+            if (client->isHibernating())
+            {
+                ++numHibernating;
+                totalSavedBytes += client->getSavedBytes();
+            }
+            
+            lastWakeMilliseconds = juce::jmax(lastWakeMilliseconds, client->getLastWakeMilliseconds());
+        }
+    }
+    
+    auto status = juce::String(numHibernating) + " hibernating, ~" + juce::File::descriptionOfSizeInBytes(totalSavedBytes) + " saved";
+    
+    if (lastWakeMilliseconds > 0.0)
+    {
+        status = status + ", slowest wake-up " + juce::String(juce::roundToInt(lastWakeMilliseconds)) + " ms";
+    }
+    
+    return status;
+}
+
+void HibernationManager::addClient(Client* client)
+{
+    const juce::ScopedLock sl(lock);
+    clients.addIfNotAlreadyThere(client);
+}
+
+void HibernationManager::removeClient(Client* client)
+{
+    const juce::ScopedLock sl(lock);
+    clients.removeFirstMatchingValue(client);
+}
+
+void HibernationManager::timerCallback()
+{
+    const auto budgetBytes = getMemoryBudgetBytes();
+    if (budgetBytes <= 0 || LoadProfiler::getResidentMemoryBytes() <= budgetBytes) { return; }
+    
+    // 내려놓은 인스턴스는 회수기가 나중에 지우므로 상주 메모리가 바로 줄지 않음
+    // 한 번에 가장 오래 쉰 인스턴스 하나만 재우고 다음 검사에서 다시 봄
+    const juce::ScopedLock sl(lock);
+    
+    Client* idlest = nullptr;
+    auto longestIdleMs = (juce::uint32) idleTimeoutMs;
+    
+    for (auto* client : clients)
+    {
+        if (!client->isAllowed() || client->isHibernating()) { continue; }
+        
+        const auto idleMs = client->getIdleMilliseconds();
+        if (idleMs >= longestIdleMs && client->canHibernate != nullptr && client->canHibernate())
+        {
+            idlest = client;
+            longestIdleMs = idleMs;
+        }
+    }
+    
+    if (idlest != nullptr && idlest->hibernate != nullptr)
+    {
+        idlest->hibernate();
+    }
+}
+
+HibernationManager::Client::Client()
+{
+    manager->addClient(this);
+}
+
+HibernationManager::Client::~Client()
+{
+    manager->removeClient(this);
+    cancelPendingUpdate();
+    awakeEvent.signal();
+}
+
+void HibernationManager::Client::noteActivity()
+{
+    lastActivityMs.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+    
+    // 다시 로드에 실패했으면 블록마다 다시 시도하지 않음 (에디터를 열거나 트랙을 다시 켜면 시도)
+    if (hibernating.load() && !wakeFailed.load() && !waking.exchange(true))
+    {
+        triggerAsyncUpdate();
+    }
+}
+
+void HibernationManager::Client::requestWakeUp()
+{
+    if (hibernating.load() && !waking.exchange(true))
+    {
+        wakeFailed.store(false);
+        triggerAsyncUpdate();
+    }
+}
+
+bool HibernationManager::Client::waitUntilAwake(int timeoutMs)
+{
+    if (!hibernating.load()) { return true; }
+    
+    requestWakeUp();
+    
+    // 로드는 메시지 스레드에서 끝나므로 메시지 스레드가 기다리면 끝나지 않음
+    if (juce::MessageManager::existsAndIsCurrentThread()) { return false; }
+    
+    awakeEvent.wait((double) timeoutMs);
+    return !hibernating.load();
+}
+
+void HibernationManager::Client::setHibernating(juce::int64 estimatedSavedBytes)
+{
+    awakeEvent.reset();
+    savedBytes.store(estimatedSavedBytes);
+    wakeFailed.store(false);
+    waking.store(false);
+    hibernating.store(true);
+}
+
+void HibernationManager::Client::noteLoadFinished(bool succeeded)
+{
+    lastActivityMs.store(juce::Time::getMillisecondCounter());
+    
+    if (!hibernating.load()) { return; }
+    
+    if (succeeded)
+    {
+        lastWakeMilliseconds.store(juce::Time::getMillisecondCounterHiRes() - wakeStartMs);
+        savedBytes.store(0);
+        hibernating.store(false);
+    }
+    else
+    {
+        wakeFailed.store(true);
+    }
+    
+    waking.store(false);
+    awakeEvent.signal();
+}
+
+void HibernationManager::Client::cancel()
+{
+    cancelPendingUpdate();
+    hibernating.store(false);
+    waking.store(false);
+    savedBytes.store(0);
+    awakeEvent.signal();
+}
+
+juce::String HibernationManager::Client::getStatusText() const
+{
+    if (hibernating.load())
+    {
+        return "hibernating, ~" + juce::File::descriptionOfSizeInBytes(getSavedBytes()) + " saved";
+    }
+    
+    const auto wakeMilliseconds = getLastWakeMilliseconds();
+    if (wakeMilliseconds > 0.0)
+    {
+        return "last woke up in " + juce::String(juce::roundToInt(wakeMilliseconds)) + " ms";
+    }
+    
+    return "awake";
+}
+
+juce::uint32 HibernationManager::Client::getIdleMilliseconds() const
+{
+    return juce::Time::getMillisecondCounter() - lastActivityMs.load(std::memory_order_relaxed);
+}
+
+void HibernationManager::Client::handleAsyncUpdate()
+{
+    if (!hibernating.load() || wakeUp == nullptr)
+    {
+        waking.store(false);
+        return;
+    }
+    
+    wakeStartMs = juce::Time::getMillisecondCounterHiRes();
+    wakeUp();
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <JuceHeader.h>
+#include "WrapperSettings.h"
+
+// 프로세스 상주 메모리가 예산을 넘으면 오래 쉬고 있는 래퍼 인스턴스의 호스팅 플러그인을 상태만 남기고 내려놓는 공용 관리자 (모든 래퍼 인스턴스가 공유)
+// 재워둔 인스턴스는 입력이나 MIDI 가 들어오거나 트랙이 다시 켜지면 백그라운드에서 다시 로드하고, 알린 지연은 그동안 바꾸지 않음
+class HibernationManager : private juce::Timer
+{
+public:
+    HibernationManager();
+    ~HibernationManager() override;
+    
+    // 0 이면 끔 (프로세스 공용이므로 세션이 아니라 WrapperSettings 에 MB 단위로 저장)
+    void setMemoryBudgetBytes(juce::int64 budgetBytes);
+    juce::int64 getMemoryBudgetBytes() const { return memoryBudgetBytes.load(); }
+    
+    juce::String getStatusText() const;
+    
+    // 래퍼 인스턴스마다 하나씩 두고, 재우기와 깨우기는 콜백으로 래퍼에 맡김
+    class Client;
+    
+    static constexpr int idleTimeoutMs = 60000;
+    
+private:
+    mutable juce::CriticalSection lock;
+    juce::Array<Client*> clients;
+    std::atomic<juce::int64> memoryBudgetBytes { 0 };
+    juce::SharedResourcePointer<WrapperSettings> settings;
+    
+    static constexpr int checkIntervalMs = 2000;
+    static constexpr const char* budgetKey = "hibernation_budget_mb";
+    
+    void addClient(Client* client);
+    void removeClient(Client* client);
+    void timerCallback() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HibernationManager)
+};
+
+class HibernationManager::Client : private juce::AsyncUpdater
+{
+public:
+    Client();
+    ~Client() override;
+    
+    // 메시지 스레드에서 부름
+    std::function<bool()> canHibernate;
+    std::function<bool()> hibernate; // 상태를 받아두고 setHibernating 을 부른 뒤 인스턴스를 내려놓음
+    std::function<void()> wakeUp;    // 다시 로드를 시작하고, 로드가 끝나면 래퍼가 noteLoadFinished 를 부름
+    
+    void setAllowed(bool shouldAllow) { allowed.store(shouldAllow); }
+    bool isAllowed() const { return allowed.load(); }
+    
+    // 오디오 스레드에서 호출: 입력이나 MIDI 가 있으면 활동으로 기록 (재워둔 상태면 깨움)
+    template<typename SampleType>
+    void noteBlock(const juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages, int numInputChannels)
+    {
+        // 최근에 활동을 기록했으면 입력을 다시 살펴보지 않음 (쉬는 시간은 이 정도 해상도면 충분)
+        const auto now = juce::Time::getMillisecondCounter();
+        if (!hibernating.load(std::memory_order_relaxed)
+            && now - lastActivityMs.load(std::memory_order_relaxed) < (juce::uint32) activityResolutionMs)
+        {
+            return;
+        }
+        
+        auto hasActivity = !midiMessages.isEmpty();
+        for (int ch = 0; !hasActivity && ch < numInputChannels && ch < buffer.getNumChannels(); ++ch)
+        {
+            hasActivity = buffer.getMagnitude(ch, 0, buffer.getNumSamples()) > (SampleType) 0;
+        }
+        
+        if (hasActivity) { noteActivity(); }
+    }
+    
+    // 아무 스레드에서나 호출
+    void noteActivity();
+    void requestWakeUp();
+    
+    // 오프라인 렌더링 스레드에서 호출: 마감이 없으므로 다시 로드될 때까지 기다림 (메시지 스레드에서 부르면 기다리지 않음)
+    bool waitUntilAwake(int timeoutMs);
+    
+    // 래퍼가 호출
+    void setHibernating(juce::int64 estimatedSavedBytes);
+    void noteLoadFinished(bool succeeded);
+    void cancel();
+    
+    bool isHibernating() const { return hibernating.load(); }
+    juce::int64 getSavedBytes() const { return savedBytes.load(); }
+    double getLastWakeMilliseconds() const { return lastWakeMilliseconds.load(); }
+    juce::String getStatusText() const;
+    
+private:
+    friend class HibernationManager;
+    
+    juce::SharedResourcePointer<HibernationManager> manager;
+    std::atomic<bool> allowed { true };
+    std::atomic<bool> hibernating { false };
+    std::atomic<bool> waking { false };
+    std::atomic<bool> wakeFailed { false };
+    std::atomic<juce::uint32> lastActivityMs { juce::Time::getMillisecondCounter() };
+    std::atomic<juce::int64> savedBytes { 0 };
+    std::atomic<double> lastWakeMilliseconds { 0.0 };
+    double wakeStartMs = 0.0;
+    juce::WaitableEvent awakeEvent { true };
+    
+    static constexpr int activityResolutionMs = 1000;
+    
+    juce::uint32 getIdleMilliseconds() const;
+    void handleAsyncUpdate() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Client)
+};
@@ -0,0 +1,132 @@
+#include "HostedPlayHead.h"
+
+void HostedPlayHead::prepare(double hostSampleRate, int internalRateFactor)
+{
+    sampleRate = hostSampleRate > 0.0 ? hostSampleRate : 44100.0;
+    rateFactor = juce::jmax(1, internalRateFactor);
+    inputDelaySamples = 0;
+    update();
+}
+
+void HostedPlayHead::capture(juce::AudioPlayHead* hostPlayHead)
+{
+    captured = hostPlayHead != nullptr ? hostPlayHead->getPosition() : juce::nullopt;
+    offsetSamples = 0;
+    update();
+}
+
+void HostedPlayHead::advance(int numSamples)
+{
+    if (numSamples <= 0 || !captured.hasValue()) { return; }
+    
+    offsetSamples += numSamples;
+    update();
+}
+
+void HostedPlayHead::setInputDelay(int numSamples)
+{
+    if (numSamples == inputDelaySamples) { return; }
+    
+    inputDelaySamples = numSamples;
+    update();
+}
+
+juce::Optional<juce::AudioPlayHead::PositionInfo> HostedPlayHead::getPosition() const
+{
+    // 쓰는 중이거나 읽는 사이에 바뀌었으면 다시 읽음 (쓰는 쪽은 값 하나를 복사하는 동안만 홀수로 둠)
+    for (;;)
+    {
+        const auto before = sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0) { continue; }
+        
+        const auto position = current;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        if (sequence.load(std::memory_order_relaxed) == before) { return position; }
+    }
+}
+
+void HostedPlayHead::publish(const juce::Optional<PositionInfo>& position)
+{
+    const auto before = sequence.load(std::memory_order_relaxed);
+    sequence.store(before + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    current = position;
+    sequence.store(before + 2, std::memory_order_release);
+}
+
+void HostedPlayHead::update()
+{
+    if (!captured.hasValue())
+    {
+        publish(juce::nullopt);
+        return;
+    }
+    
+    auto position = offsetPosition(*captured, offsetSamples - inputDelaySamples, sampleRate);
+    
+    // 내부 레이트로 돌리는 플러그인에는 그 레이트의 샘플 위치를 알려줌
+    if (rateFactor > 1)
+    {
+        if (const auto timeInSamples = position.getTimeInSamples())
+        {
+            position.setTimeInSamples(*timeInSamples / rateFactor);
+        }
+    }
+    
+    publish(position);
+}
+
+juce::AudioPlayHead::PositionInfo HostedPlayHead::offsetPosition(const PositionInfo& position,
+                                                                 juce::int64 offsetSamples,
+                                                                 double sampleRate)
+{
+    auto result = position;
+    if (offsetSamples == 0 || !position.getIsPlaying() || sampleRate <= 0.0) { return result; }
+    
+    const auto offsetSeconds = (double) offsetSamples / sampleRate;
+    
+    if (const auto timeInSamples = position.getTimeInSamples())
+    {
+        result.setTimeInSamples(*timeInSamples + (int64_t) offsetSamples);
+    }
+    
+    if (const auto timeInSeconds = position.getTimeInSeconds())
+    {
+        result.setTimeInSeconds(*timeInSeconds + offsetSeconds);
+    }
+    
+    if (const auto hostTimeNs = position.getHostTimeNs())
+    {
+        result.setHostTimeNs(*hostTimeNs + (uint64_t) (int64_t) (offsetSeconds * 1.0e9));
+    }
+    
+    const auto bpm = position.getBpm();
+    const auto ppqPosition = position.getPpqPosition();
+    if (!bpm.hasValue() || !ppqPosition.hasValue()) { return result; }
+    
+    const auto ppq = *ppqPosition + offsetSeconds * *bpm / 60.0;
+    result.setPpqPosition(ppq);
+    
+    // 조각이 마디선을 넘어가거나 입력 지연만큼 되돌려서 이전 마디로 가면 마지막 마디 시작과 마디 수도 옮김
+    // (루프 끝에서 되감기는 호스트가 블록을 나눠서 알려줌)
+    const auto barStart = position.getPpqPositionOfLastBarStart();
+    const auto timeSignature = position.getTimeSignature();
+    if (!barStart.hasValue() || !timeSignature.hasValue() || timeSignature->denominator <= 0) { return result; }
+    
+    const auto barLength = timeSignature->numerator * 4.0 / timeSignature->denominator;
+    if (barLength <= 0.0) { return result; }
+    
+    const auto numBarsCrossed = (juce::int64) std::floor((ppq - *barStart) / barLength);
+    if (numBarsCrossed != 0)
+    {
+        result.setPpqPositionOfLastBarStart(*barStart + (double) numBarsCrossed * barLength);
+        
+        if (const auto barCount = position.getBarCount())
+        {
+            result.setBarCount(*barCount + (int64_t) numBarsCrossed);
+        }
+    }
+    
+    return result;
+}
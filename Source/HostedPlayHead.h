@@ -0,0 +1,44 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인을 로드할 때 한 번 넘겨두는 래퍼 소유의 플레이헤드
+// 호스트 블록마다 호스트 플레이헤드를 한 번만 읽어두고, 플러그인이 블록 안에서 getPosition 을 여러 번 불러도 찍어둔 값만 돌려줌
+// MIDI 학습처럼 래퍼가 블록을 나눠 부르면 이미 처리한 샘플만큼 위치를 옮기고, 내부 레이트로 돌리면 샘플 위치를 내부 레이트로 바꿈
+// 찍는 쪽은 블록을 처리하는 스레드 하나 (innerMutex 로 오디오 스레드와 미리 렌더링 스레드가 번갈아 씀) 이고,
+// 플러그인은 에디터나 타이머에서도 getPosition 을 부르므로 찍은 값은 시퀀스 락으로 내보냄 (쓰는 쪽은 기다리지 않음)
+class HostedPlayHead : public juce::AudioPlayHead
+{
+public:
+    HostedPlayHead() = default;
+    
+    // 메시지 스레드에서 호출 (블록 처리와 동시에 호출하면 안 됨)
+    void prepare(double hostSampleRate, int internalRateFactor);
+    
+    // 블록을 처리하는 스레드에서 호출: 호스트 블록마다 한 번 찍고, 호스팅 플러그인을 부를 때마다 처리한 샘플 수 (호스트 레이트) 만큼 옮김
+    void capture(juce::AudioPlayHead* hostPlayHead);
+    void advance(int numSamples);
+    
+    // 블록을 처리하는 스레드에서 호출: 플러그인이 받는 입력이 호스트 블록보다 이만큼 (호스트 레이트) 앞선 것일 때 위치를 되돌림
+    // 내부 레이트 변환기의 내림 필터 지연과 지난 블록에서 넘어온 샘플 수 (변환기를 거치지 않으면 0)
+    void setInputDelay(int numSamples);
+    
+    // 아무 스레드에서나 호출
+    juce::Optional<PositionInfo> getPosition() const override;
+    
+    // 재생 중일 때만 옮김 (멈춰 있으면 호스트도 위치를 그대로 알려줌)
+    static PositionInfo offsetPosition(const PositionInfo& position, juce::int64 offsetSamples, double sampleRate);
+    
+private:
+    juce::Optional<PositionInfo> captured;
+    juce::Optional<PositionInfo> current;
+    std::atomic<juce::uint32> sequence { 0 }; // 홀수이면 current 를 쓰는 중
+    juce::int64 offsetSamples = 0;
+    int inputDelaySamples = 0;
+    double sampleRate = 44100.0;
+    int rateFactor = 1;
+    
+    void update();
+    void publish(const juce::Optional<PositionInfo>& position);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HostedPlayHead)
+};
@@ -0,0 +1,50 @@
+#include "InstanceReclaimer.h"
+
+InstanceReclaimer::InstanceReclaimer()
+{
+    // 스레드가 대기열을 함께 가지고 스스로 끝나므로 회수기는 스레드를 들고 있지 않음
+    if (!juce::Thread::launch(juce::Thread::Priority::low, [q = queue]() { run(q); }))
+    {
+        jassertfalse;
+    }
+}
+
+InstanceReclaimer::~InstanceReclaimer()
+{
+    // 회수 스레드가 VST3 인스턴스를 지우는 중이면 메시지 스레드를 기다리고 있을 수 있으므로 멈추기를 기다리지 않음
+    // 종료만 알리고 남은 것은 여기서 지움 (회수 스레드는 지우던 것만 마치면 종료 요청을 보고 끝남)
+    queue->shouldExit.store(true);
+    queue->wakeUp.signal();
+    reclaimNow();
+}
+
+void InstanceReclaimer::reclaimNow()
+{
+    while (queue->reclaimOne()) {}
+}
+
+bool InstanceReclaimer::Queue::reclaimOne()
+{
+    std::shared_ptr<void> object;
+    {
+        const juce::ScopedLock sl(lock);
+        if (pending.empty()) { return false; }
+        
+        object = std::move(pending.front());
+        pending.pop_front();
+    }
+    
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    object.reset();
+    lastReclaimMilliseconds.store(juce::Time::getMillisecondCounterHiRes() - start);
+    --numUnfinished;
+    return true;
+}
+
+void InstanceReclaimer::run(std::shared_ptr<Queue> queue)
+{
+    while (!queue->shouldExit.load())
+    {
+        if (!queue->reclaimOne()) { queue->wakeUp.wait(-1); }
+    }
+}
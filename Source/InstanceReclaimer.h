@@ -0,0 +1,56 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 오디오 경로에서 떼어낸 호스팅 인스턴스를 락 밖에서 나중에 지우는 프로세스 공용 회수기 (모든 래퍼 인스턴스가 공유)
+// 래퍼는 innerMutex 안에서 포인터만 바꾸고 삭제는 여기로 넘기므로, 큰 샘플 기반 플러그인을 닫아도 오디오 스레드가 기다리지 않음
+// 삭제는 낮은 우선순위의 회수 스레드에서 넘긴 순서대로 하나씩 하므로 메시지 스레드도 닫기를 기다리지 않음
+// (JUCE 가 메시지 스레드로 넘겨서 하는 VST3 정리 단계만 그쪽에서 돌고, 그동안 기다리는 것은 회수 스레드)
+// 그래서 소멸자는 회수 스레드를 기다리지 않음: 남은 객체는 호출한 스레드에서 지우고, 회수 스레드는 지우던 것만 마치고 끝남
+// (대기열은 회수 스레드도 함께 가지므로 회수기가 먼저 사라져도 됨)
+class InstanceReclaimer
+{
+public:
+    InstanceReclaimer();
+    ~InstanceReclaimer();
+    
+    // 아무 스레드에서나 호출: 오디오 스레드가 더 이상 볼 수 없는 객체를 넘김
+    template<typename ObjectType>
+    void reclaim(std::unique_ptr<ObjectType> object)
+    {
+        if (object == nullptr) { return; }
+        
+        {
+            const juce::ScopedLock sl(queue->lock);
+            queue->pending.push_back(std::shared_ptr<ObjectType>(std::move(object)));
+            ++queue->numUnfinished;
+        }
+        
+        queue->wakeUp.signal();
+    }
+    
+    // 호출한 스레드에서 남은 객체를 지금 모두 지움
+    void reclaimNow();
+    
+    // 아직 지우지 않았거나 지우는 중인 객체 수
+    int getNumPending() const { return queue->numUnfinished.load(); }
+    double getLastReclaimMilliseconds() const { return queue->lastReclaimMilliseconds.load(); }
+    
+private:
+    struct Queue
+    {
+        juce::CriticalSection lock;
+        std::deque<std::shared_ptr<void>> pending;
+        std::atomic<int> numUnfinished { 0 };
+        std::atomic<double> lastReclaimMilliseconds { 0.0 };
+        std::atomic<bool> shouldExit { false };
+        juce::WaitableEvent wakeUp;
+        
+        bool reclaimOne();
+    };
+    
+    std::shared_ptr<Queue> queue = std::make_shared<Queue>();
+    
+    static void run(std::shared_ptr<Queue> queue);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InstanceReclaimer)
+};
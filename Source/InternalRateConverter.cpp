@@ -0,0 +1,397 @@
+#include "InternalRateConverter.h"
+
+// 높은 레이트와 그 절반 레이트 사이를 오가는 2배 단
+// 필터 길이가 홀수인 선형 위상 FIR 을 짝/홀 위상으로 나눠서, 출력 블록 전체에 계수 하나씩 곱해 더함
+// 차단 주파수가 정확히 1/4 이라 하프밴드 필터가 되므로, 절반 가까이 되는 0 계수는 건너뜀
+class InternalRateConverter::Stage
+{
+public:
+    Stage(double highSampleRate, int maxHighBlockSize, int numChannels)
+    {
+        const auto kernel = designKernel(highSampleRate);
+        numTaps = (int) kernel.size();
+        half = (numTaps - 1) / 2;
+        
+        for (int i = 0; i < numTaps; ++i)
+        {
+            if (std::abs(kernel[(size_t) i]) > 1.0e-9f)
+            {
+                (i % 2 == 0 ? evenTaps : oddTaps).push_back({ i / 2, kernel[(size_t) i] });
+            }
+        }
+        
+        const auto maxLowBlockSize = maxHighBlockSize / 2 + 1;
+        decimatorEven.setSize(numChannels, half + maxLowBlockSize);
+        decimatorOdd.setSize(numChannels, half + maxLowBlockSize);
+        interpolatorHistory.setSize(numChannels, half + maxLowBlockSize);
+        phaseOutputs.setSize(2, maxLowBlockSize);
+        carry.resize((size_t) numChannels);
+        reset();
+    }
+    
+    void reset()
+    {
+        decimatorEven.clear();
+        decimatorOdd.clear();
+        interpolatorHistory.clear();
+        hasCarry = false;
+    }
+    
+    // 내리고 올리는 두 필터의 지연 합 (이 단의 높은 레이트 기준)
+    int getLatencySamples() const { return numTaps - 1; }
+    
+    // 내리는 필터만의 지연: 출력 j 는 입력 2j 보다 이만큼 앞선 샘플을 중심으로 거른 값
+    int getDecimationLatencySamples() const { return half; }
+    
+    int decimate(const float* const* input, int numChannels, int numSamples, float* const* output)
+    {
+        const auto numPending = numSamples + (hasCarry ? 1 : 0);
+        const auto numOutput = numPending / 2;
+        const auto nextHasCarry = (numPending % 2) != 0;
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* even = decimatorEven.getWritePointer(ch);
+            auto* odd = decimatorOdd.getWritePointer(ch);
+            const auto* source = input[ch];
+            
+            // 새 샘플을 짝/홀 위상으로 나눠 히스토리 뒤에 붙임 (지난 블록의 남은 한 샘플부터)
+            int position = 0;
+            for (int j = 0; j < numOutput; ++j)
+            {
+                even[half + j] = (j == 0 && hasCarry) ? carry[(size_t) ch] : source[position++];
+                odd[half + j] = source[position++];
+            }
+            
+            if (nextHasCarry) { carry[(size_t) ch] = source[numSamples - 1]; }
+            
+            auto* destination = output[ch];
+            juce::FloatVectorOperations::clear(destination, numOutput);
+            
+            for (const auto& tap : evenTaps)
+            {
+                juce::FloatVectorOperations::addWithMultiply(destination, even + tap.offset, tap.coefficient, numOutput);
+            }
+            
+            for (const auto& tap : oddTaps)
+            {
+                juce::FloatVectorOperations::addWithMultiply(destination, odd + tap.offset, tap.coefficient, numOutput);
+            }
+            
+            std::memmove(even, even + numOutput, sizeof(float) * (size_t) half);
+            std::memmove(odd, odd + numOutput, sizeof(float) * (size_t) half);
+        }
+        
+        hasCarry = nextHasCarry;
+        return numOutput;
+    }
+    
+    void interpolate(const float* const* input, int numChannels, int numSamples, float* const* output)
+    {
+        auto* evenOutput = phaseOutputs.getWritePointer(0);
+        auto* oddOutput = phaseOutputs.getWritePointer(1);
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* history = interpolatorHistory.getWritePointer(ch);
+            juce::FloatVectorOperations::copy(history + half, input[ch], numSamples);
+            juce::FloatVectorOperations::clear(evenOutput, numSamples);
+            juce::FloatVectorOperations::clear(oddOutput, numSamples);
+            
+            // 0 을 끼워 넣고 거른 것과 같음: 짝수 출력은 짝수 계수만, 홀수 출력은 홀수 계수만 씀 (이득 2 배)
+            for (const auto& tap : evenTaps)
+            {
+                juce::FloatVectorOperations::addWithMultiply(evenOutput, history + half - tap.offset, 2.0f * tap.coefficient, numSamples);
+            }
+            
+            for (const auto& tap : oddTaps)
+            {
+                juce::FloatVectorOperations::addWithMultiply(oddOutput, history + half - tap.offset, 2.0f * tap.coefficient, numSamples);
+            }
+            
+            auto* destination = output[ch];
+            for (int j = 0; j < numSamples; ++j)
+            {
+                destination[2 * j] = evenOutput[j];
+                destination[2 * j + 1] = oddOutput[j];
+            }
+            
+            std::memmove(history, history + numSamples, sizeof(float) * (size_t) half);
+        }
+    }
+    
+private:
+    struct Tap
+    {
+        int offset;
+        float coefficient;
+    };
+    
+    int numTaps = 0;
+    int half = 0;
+    std::vector<Tap> evenTaps;
+    std::vector<Tap> oddTaps;
+    juce::AudioBuffer<float> decimatorEven;
+    juce::AudioBuffer<float> decimatorOdd;
+    juce::AudioBuffer<float> interpolatorHistory;
+    juce::AudioBuffer<float> phaseOutputs;
+    std::vector<float> carry;
+    bool hasCarry = false;
+    
+    static constexpr double passbandEdgeHz = 20000.0;
+    static constexpr double stopbandAttenuationDb = 100.0;
+    
+    // 카이저 창 sinc. 20 kHz 까지 통과시키고, 접힌 성분이 통과 대역에 닿기 전(낮은 레이트 - 20 kHz)부터 막음
+    static std::vector<float> designKernel(double highSampleRate)
+    {
+        const auto lowSampleRate = highSampleRate / 2.0;
+        const auto passband = juce::jmin(passbandEdgeHz, 0.45 * lowSampleRate);
+        const auto stopband = lowSampleRate - passband;
+        const auto transition = (stopband - passband) / highSampleRate;
+        const auto cutoff = 0.5 * (passband + stopband) / highSampleRate;
+        
+        auto numTaps = (int) std::ceil((stopbandAttenuationDb - 8.0) / (2.285 * juce::MathConstants<double>::twoPi * transition)) + 1;
+        numTaps = juce::jlimit(15, 255, numTaps | 1);
+        
+        const auto beta = 0.1102 * (stopbandAttenuationDb - 8.7);
+        const auto centre = (numTaps - 1) / 2;
+        
+        std::vector<float> kernel((size_t) numTaps);
+        double sum = 0.0;
+        
+        for (int i = 0; i < numTaps; ++i)
+        {
+            const auto n = i - centre;
+            const auto x = juce::MathConstants<double>::twoPi * cutoff * n;
+            const auto sinc = n == 0 ? 2.0 * cutoff : std::sin(x) / (juce::MathConstants<double>::pi * n);
+            const auto ratio = (double) n / centre;
+            const auto window = besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+            
+            kernel[(size_t) i] = (float) (sinc * window);
+            sum += sinc * window;
+        }
+        
+        // DC 이득을 1 로 맞춤
+        for (auto& coefficient : kernel)
+        {
+            coefficient = (float) (coefficient / sum);
+        }
+        
+        return kernel;
+    }
+    
+    static double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50 && term > 1.0e-12 * sum; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+};
+
+InternalRateConverter::InternalRateConverter() {}
+
+InternalRateConverter::~InternalRateConverter() {}
+
+int InternalRateConverter::getFactorForRate(double sampleRate)
+{
+    auto result = 1;
+    while (result < 4 && sampleRate / (result * 2) >= 44000.0)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+void InternalRateConverter::prepare(double sampleRate, int maxHostBlockSize, int numChannels, int newFactor)
+{
+    hostSampleRate = sampleRate;
+    factor = juce::jlimit(1, 4, newFactor);
+    numChannels = juce::jlimit(1, maxChannels, numChannels);
+    
+    stages.clear();
+    levelBuffers.clear();
+    
+    // 블록 크기가 배율로 나눠떨어지지 않아도 되도록 남는 샘플은 다음 블록으로 넘기고,
+    // 그만큼(배율 - 1)을 출력 FIFO 에 미리 채워둠
+    latencySamples = factor - 1;
+    decimationLatencySamples = 0;
+    
+    auto stageSampleRate = sampleRate;
+    auto stageBlockSize = maxHostBlockSize;
+    auto hostSamplesPerStageSample = 1;
+    
+    for (auto remaining = factor; remaining > 1; remaining /= 2)
+    {
+        auto* stage = stages.add(new Stage(stageSampleRate, stageBlockSize, numChannels));
+        latencySamples += stage->getLatencySamples() * hostSamplesPerStageSample;
+        decimationLatencySamples += stage->getDecimationLatencySamples() * hostSamplesPerStageSample;
+        
+        stageBlockSize = stageBlockSize / 2 + 1;
+        levelBuffers.add(new juce::AudioBuffer<float>(numChannels, stageBlockSize + 1));
+        
+        stageSampleRate /= 2.0;
+        hostSamplesPerStageSample *= 2;
+    }
+    
+    if (levelBuffers.isEmpty())
+    {
+        levelBuffers.add(new juce::AudioBuffer<float>(numChannels, maxHostBlockSize));
+    }
+    
+    maxInternalBlockSize = stageBlockSize;
+    outputFifo.setSize(numChannels, maxHostBlockSize + 2 * factor);
+    internalMidi.ensureSize(midiBufferBytes);
+    reset();
+}
+
+void InternalRateConverter::reset()
+{
+    for (auto* stage : stages)
+    {
+        stage->reset();
+    }
+    
+    outputFifo.clear();
+    fifoNumReady = factor - 1;
+    numCarriedSamples = 0;
+}
+
+int InternalRateConverter::downsample(const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    const float* const* input = buffer.getArrayOfReadPointers();
+    auto numSamples = buffer.getNumSamples();
+    
+    for (int i = 0; i < stages.size(); ++i)
+    {
+        auto& destination = *levelBuffers.getUnchecked(i);
+        numSamples = stages.getUnchecked(i)->decimate(input, numChannels, numSamples, destination.getArrayOfWritePointers());
+        input = destination.getArrayOfReadPointers();
+    }
+    
+    return numSamples;
+}
+
+void InternalRateConverter::upsample(int numInternalSamples, int numChannels)
+{
+    auto numSamples = numInternalSamples;
+    
+    for (int i = stages.size(); --i >= 0;)
+    {
+        float* destination[maxChannels] = {};
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            destination[ch] = i == 0 ? outputFifo.getWritePointer(ch) + fifoNumReady
+                                     : levelBuffers.getUnchecked(i - 1)->getWritePointer(ch);
+        }
+        
+        stages.getUnchecked(i)->interpolate(levelBuffers.getUnchecked(i)->getArrayOfReadPointers(),
+                                            numChannels, numSamples, destination);
+        numSamples *= 2;
+    }
+    
+    fifoNumReady += numSamples;
+}
+
+void InternalRateConverter::popFromFifo(juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    const auto numSamples = buffer.getNumSamples();
+    jassert(fifoNumReady >= numSamples);
+    
+    const auto available = juce::jmin(numSamples, fifoNumReady);
+    const auto remaining = fifoNumReady - available;
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* fifo = outputFifo.getWritePointer(ch);
+        buffer.copyFrom(ch, 0, fifo, available);
+        if (available < numSamples) { buffer.clear(ch, available, numSamples - available); }
+        std::memmove(fifo, fifo + available, sizeof(float) * (size_t) remaining);
+    }
+    
+    fifoNumReady = remaining;
+}
+
+std::vector<InternalRateConverter::BenchmarkResult> InternalRateConverter::measure(const std::vector<double>& hostSampleRates,
+                                                                                   int blockSize,
+                                                                                   int numChannels)
+{
+    std::vector<BenchmarkResult> results;
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiMessages;
+    auto passThrough = [](juce::AudioBuffer<float>&, juce::MidiBuffer&) {};
+    
+    for (const auto sampleRate : hostSampleRates)
+    {
+        InternalRateConverter converter;
+        const auto rateFactor = getFactorForRate(sampleRate);
+        converter.prepare(sampleRate, blockSize, numChannels, rateFactor);
+        
+        // 사인파를 통과시켜 지연 이후의 RMS 비를 dB 로 잼
+        auto measureGainDb = [&](double frequency)
+        {
+            converter.reset();
+            const auto numBlocks = (int) std::ceil(sampleRate / blockSize);
+            const auto skipSamples = converter.getLatencySamples() + blockSize;
+            double inputEnergy = 0.0, outputEnergy = 0.0;
+            
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto n = block * blockSize + i;
+                    const auto value = (float) std::sin(juce::MathConstants<double>::twoPi * frequency * n / sampleRate);
+                    for (int ch = 0; ch < numChannels; ++ch) { buffer.setSample(ch, i, value); }
+                    if (n >= skipSamples) { inputEnergy += (double) value * value; }
+                }
+                
+                converter.process(buffer, midiMessages, passThrough);
+                
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto value = buffer.getSample(0, i);
+                    if (block * blockSize + i >= skipSamples) { outputEnergy += (double) value * value; }
+                }
+            }
+            
+            return 10.0 * std::log10(juce::jmax(1.0e-20, outputEnergy) / juce::jmax(1.0e-20, inputEnergy));
+        };
+        
+        BenchmarkResult result { sampleRate, rateFactor, converter.getLatencySamples(), 0.0, 0.0, 0.0 };
+        
+        if (rateFactor > 1)
+        {
+            for (const auto frequency : { 100.0, 1000.0, 10000.0, 18000.0 })
+            {
+                result.passbandErrorDb = juce::jmax(result.passbandErrorDb, std::abs(measureGainDb(frequency)));
+            }
+            
+            // 내부 나이퀴스트보다 4 kHz 높은 톤이 얼마나 막히는지
+            result.aliasRejectionDb = -measureGainDb(converter.getInternalSampleRate() / 2.0 + 4000.0);
+        }
+        
+        juce::Random random;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < blockSize; ++i) { buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f); }
+        }
+        
+        const auto numIterations = juce::jmax(1, (int) (10.0 * sampleRate / blockSize));
+        const auto start = juce::Time::getHighResolutionTicks();
+        
+        for (int i = 0; i < numIterations; ++i)
+        {
+            converter.process(buffer, midiMessages, passThrough);
+        }
+        
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+        result.nanosecondsPerChannelSample = elapsed / ((double) numIterations * blockSize * numChannels);
+        results.push_back(result);
+    }
+    
+    return results;
+}
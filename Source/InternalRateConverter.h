@@ -0,0 +1,117 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 높은 샘플레이트 세션에서 호스팅 플러그인을 낮은 내부 레이트로 돌리기 위한 다운/업 샘플러
+// 2배 선형 위상 FIR 단을 이어서 1/2 또는 1/4 로 내리고, 같은 필터로 다시 올림
+// 필터는 폴리페이즈로 나눠 FloatVectorOperations 로 계산함
+class InternalRateConverter
+{
+public:
+    InternalRateConverter();
+    ~InternalRateConverter();
+    
+    // 내부 레이트가 44.1 kHz 아래로 내려가지 않는 가장 큰 배율 (1, 2, 4)
+    static int getFactorForRate(double hostSampleRate);
+    
+    // 메시지 스레드에서 호출 (factor 가 1 이면 꺼짐)
+    void prepare(double hostSampleRate, int maxHostBlockSize, int numChannels, int factor);
+    void reset();
+    
+    bool isActive() const { return factor > 1; }
+    int getFactor() const { return factor; }
+    double getInternalSampleRate() const { return hostSampleRate / factor; }
+    int getMaxInternalBlockSize() const { return maxInternalBlockSize; }
+    
+    // 필터 지연과 블록 정렬용 FIFO 지연의 합 (호스트 레이트 기준)
+    int getLatencySamples() const { return latencySamples; }
+    
+    // process 전에 호출: 다음 내부 블록의 첫 샘플이 호스트 블록 시작보다 몇 샘플 (호스트 레이트) 앞선 입력인지
+    // 내림 필터의 지연과, 배율로 나눠떨어지지 않아 지난 블록에서 넘어온 샘플 수의 합
+    int getInputDelaySamples() const { return decimationLatencySamples + numCarriedSamples; }
+    
+    // 오디오 스레드에서 호출: 내린 버퍼와 MIDI 로 processInternal 을 부르고 결과를 다시 올려 buffer 에 씀
+    template<typename ProcessFunction>
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, ProcessFunction&& processInternal);
+    
+    struct BenchmarkResult
+    {
+        double hostSampleRate;
+        int factor;
+        int latencySamples;
+        double nanosecondsPerChannelSample;
+        double passbandErrorDb;
+        double aliasRejectionDb;
+    };
+    
+    static std::vector<BenchmarkResult> measure(const std::vector<double>& hostSampleRates,
+                                                int blockSize = 512,
+                                                int numChannels = 2);
+    
+    static constexpr int maxChannels = 32;
+    
+private:
+    class Stage;
+    
+    juce::OwnedArray<Stage> stages;
+    juce::OwnedArray<juce::AudioBuffer<float>> levelBuffers; // i 번째는 1/2^(i+1) 레이트, 마지막이 내부 버퍼
+    juce::AudioBuffer<float> outputFifo;
+    juce::MidiBuffer internalMidi;
+    
+    double hostSampleRate = 44100.0;
+    int factor = 1;
+    int maxInternalBlockSize = 0;
+    int latencySamples = 0;
+    int decimationLatencySamples = 0;
+    int numCarriedSamples = 0;
+    int fifoNumReady = 0;
+    
+    static constexpr int midiBufferBytes = 16384;
+    
+    int downsample(const juce::AudioBuffer<float>& buffer, int numChannels);
+    void upsample(int numInternalSamples, int numChannels);
+    void popFromFifo(juce::AudioBuffer<float>& buffer, int numChannels);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InternalRateConverter)
+};
+
+template<typename ProcessFunction>
+void InternalRateConverter::process(juce::AudioBuffer<float>& buffer,
+                                    juce::MidiBuffer& midiMessages,
+                                    ProcessFunction&& processInternal)
+{
+    if (!isActive())
+    {
+        processInternal(buffer, midiMessages);
+        return;
+    }
+    
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), levelBuffers.getLast()->getNumChannels());
+    const auto numSamples = buffer.getNumSamples();
+    const auto numInternalSamples = downsample(buffer, numChannels);
+    numCarriedSamples = (numCarriedSamples + numSamples) % factor;
+    
+    // 호스트 블록이 배율보다 작으면 이번에는 내부 샘플이 없을 수 있음 (MIDI 는 그대로 통과)
+    if (numInternalSamples > 0)
+    {
+        internalMidi.clear();
+        for (const auto metadata : midiMessages)
+        {
+            internalMidi.addEvent(metadata.data, metadata.numBytes,
+                                  juce::jmin(numInternalSamples - 1, metadata.samplePosition / factor));
+        }
+        
+        juce::AudioBuffer<float> internalBlock(levelBuffers.getLast()->getArrayOfWritePointers(),
+                                               numChannels, numInternalSamples);
+        processInternal(internalBlock, internalMidi);
+        
+        midiMessages.clear();
+        for (const auto metadata : internalMidi)
+        {
+            midiMessages.addEvent(metadata.data, metadata.numBytes,
+                                  juce::jmin(numSamples - 1, metadata.samplePosition * factor));
+        }
+    }
+    
+    upsample(numInternalSamples, numChannels);
+    popFromFifo(buffer, numChannels);
+}
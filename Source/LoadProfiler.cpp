@@ -0,0 +1,144 @@
+#include "LoadProfiler.h"
+
+#if JUCE_MAC
+ #include <mach/mach.h>
+#endif
+
+double LoadProfiler::Report::getTotalMilliseconds() const
+{
+    return std::accumulate(phaseMilliseconds.begin(), phaseMilliseconds.end(), 0.0);
+}
+
+juce::String LoadProfiler::Report::getSummary() const
+{
+    if (pluginPath.isEmpty()) { return {}; }
+    
+    const auto megabytes = (double) residentBytesDelta / (1024.0 * 1024.0);
+    return "Loaded in " + juce::String(juce::roundToInt(getTotalMilliseconds())) + " ms, "
+         + (megabytes >= 0.0 ? "+" : "") + juce::String(megabytes, 1) + " MB";
+}
+
+juce::String LoadProfiler::Report::toLogLine() const
+{
+    juce::StringArray fields;
+    fields.add(juce::Time::getCurrentTime().toISO8601(true));
+    fields.add(pluginName);
+    fields.add(pluginPath);
+    
+    for (const auto milliseconds : phaseMilliseconds)
+    {
+        fields.add(juce::String(milliseconds, 1));
+    }
+    
+    fields.add(juce::String(getTotalMilliseconds(), 1));
+    fields.add(juce::String(residentBytesDelta));
+    return fields.joinIntoString("\t");
+}
+
+void LoadProfiler::start(const juce::String& pluginPath)
+{
+    current = Report();
+    current.pluginPath = pluginPath;
+    currentPhase = -1;
+    startResidentBytes = getResidentMemoryBytes();
+}
+
+void LoadProfiler::beginPhase(Phase phase)
+{
+    currentPhase = (int) phase;
+    phaseStartMilliseconds = juce::Time::getMillisecondCounterHiRes();
+}
+
+void LoadProfiler::endPhase()
+{
+    if (currentPhase < 0) { return; }
+    
+    current.phaseMilliseconds[(size_t) currentPhase] += juce::Time::getMillisecondCounterHiRes() - phaseStartMilliseconds;
+    currentPhase = -1;
+}
+
+void LoadProfiler::addPhaseMilliseconds(Phase phase, double milliseconds)
+{
+    current.phaseMilliseconds[(size_t) phase] += milliseconds;
+}
+
+LoadProfiler::Report LoadProfiler::finish(const juce::String& pluginName)
+{
+    endPhase();
+    
+    // 같은 프로세스에서 다른 인스턴스가 동시에 로드하면 그 메모리도 포함될 수 있음
+    current.pluginName = pluginName;
+    current.residentBytesDelta = getResidentMemoryBytes() - startResidentBytes;
+    
+    static juce::CriticalSection logMutex;
+    const juce::ScopedLock sl(logMutex);
+    
+    const auto logFile = getSessionLogFile();
+    if (!logFile.exists())
+    {
+        juce::StringArray header { "time", "plugin", "path" };
+        for (int phase = 0; phase < numPhases; ++phase)
+        {
+            header.add(getPhaseName((Phase) phase) + "_ms");
+        }
+        header.addArray({ "total_ms", "resident_delta_bytes" });
+        
+        logFile.create();
+        logFile.appendText(header.joinIntoString("\t") + "\n");
+    }
+    
+    logFile.appendText(current.toLogLine() + "\n");
+    return current;
+}
+
+juce::String LoadProfiler::getPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case describe:      return "describe";
+        case instantiate:   return "instantiate";
+        case layout:        return "layout";
+        case prepare:       return "prepare";
+        case restoreState:  return "restore_state";
+        case numPhases:     break;
+    }
+    
+    return {};
+}
+
+juce::int64 LoadProfiler::getResidentMemoryBytes()
+{
+   #if JUCE_MAC
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) == KERN_SUCCESS)
+    {
+        return (juce::int64) info.resident_size;
+    }
+   #endif
+   
+    return 0;
+}
+
+juce::File LoadProfiler::getLogDirectory()
+{
+    // ~/Library/Logs/VST3 Loader
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("Logs")
+               .getChildFile("VST3 Loader");
+}
+
+juce::File LoadProfiler::getSessionLogFile()
+{
+    // 호스트 프로세스 하나가 세션 하나: 처음 로드할 때 파일 이름을 정함
+    static const auto sessionLogFile = []()
+    {
+        const auto directory = getLogDirectory();
+        directory.createDirectory();
+        return directory.getNonexistentChildFile("load-" + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"),
+                                                 ".tsv", false);
+    }();
+    
+    return sessionLogFile;
+}
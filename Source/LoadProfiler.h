@@ -0,0 +1,61 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인 로드의 단계별 시간과 상주 메모리 증가량을 기록
+// 모든 단계는 메시지 스레드에서 차례로 불림
+class LoadProfiler
+{
+public:
+    enum Phase
+    {
+        describe,       // 모듈 로드와 스캔 포함 (JUCE 가 findAllTypesForFile 에서 모듈을 엶)
+        instantiate,
+        layout,
+        prepare,
+        restoreState,
+        numPhases
+    };
+    
+    struct Report
+    {
+        juce::String pluginName;
+        juce::String pluginPath;
+        std::array<double, numPhases> phaseMilliseconds {};
+        juce::int64 residentBytesDelta = 0;
+        
+        double getTotalMilliseconds() const;
+        juce::String getSummary() const;
+        juce::String toLogLine() const;
+    };
+    
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase(LoadProfiler& p, Phase phase) : profiler(p) { profiler.beginPhase(phase); }
+        ~ScopedPhase() { profiler.endPhase(); }
+    
+    private:
+        LoadProfiler& profiler;
+        
+        JUCE_DECLARE_NON_COPYABLE (ScopedPhase)
+    };
+    
+    void start(const juce::String& pluginPath);
+    void beginPhase(Phase phase);
+    void endPhase();
+    void addPhaseMilliseconds(Phase phase, double milliseconds);
+    
+    // 세션 로그에 한 줄 남기고 결과를 돌려줌
+    Report finish(const juce::String& pluginName);
+    
+    static juce::String getPhaseName(Phase phase);
+    static juce::int64 getResidentMemoryBytes();
+    static juce::File getLogDirectory();
+    static juce::File getSessionLogFile();
+    
+private:
+    Report current;
+    int currentPhase = -1;
+    double phaseStartMilliseconds = 0.0;
+    juce::int64 startResidentBytes = 0;
+};
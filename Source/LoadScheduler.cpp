@@ -0,0 +1,177 @@
+#include "LoadScheduler.h"
+#include "PluginProcessor.h"
+
+LoadScheduler::LoadScheduler()
+    : prefetchPool(juce::ThreadPoolOptions{}.withThreadName("VST3 Loader prefetch")
+                                            .withNumberOfThreads(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))),
+      describePool(juce::ThreadPoolOptions{}.withThreadName("VST3 Loader describe")
+                                            .withNumberOfThreads(1))
+{
+}
+
+LoadScheduler::~LoadScheduler()
+{
+    stopTimer();
+    prefetchPool.removeAllJobs(true, 10000);
+    describePool.removeAllJobs(true, 10000);
+}
+
+void LoadScheduler::requestDescription(const void* owner, const juce::String& pluginPath,
+                                       PriorityFunction priority, DescriptionCallback callback)
+{
+    const juce::ScopedLock sl(lock);
+    
+    requests.push_back({ owner, pluginPath, std::move(priority), std::move(callback), ++requestCounter });
+    ++numRequestedInBatch;
+    
+    // 같은 경로는 한 번만 스캔하고, 실패했거나 파일이 바뀌었으면 다시 스캔
+    const auto modificationTime = juce::File(pluginPath).getLastModificationTime();
+    const auto cached = descriptions.find(pluginPath);
+    
+    if (cached == descriptions.end()
+        || (cached->second.isDone && (!cached->second.found || cached->second.modificationTime != modificationTime)))
+    {
+        descriptions[pluginPath] = CachedDescription();
+        descriptions[pluginPath].modificationTime = modificationTime;
+        startDescribing(pluginPath);
+    }
+    
+    juce::WeakReference<LoadScheduler> weakThis(this);
+    juce::MessageManager::callAsync([weakThis]()
+    {
+        if (weakThis != nullptr && !weakThis->isTimerRunning()) { weakThis->startTimer(dispatchIntervalMs); }
+    });
+}
+
+void LoadScheduler::prefetchBundle(const juce::File& bundle)
+{
+    // 모듈 로드가 차례로 도는 동안 디스크를 기다리지 않도록 실행 파일과 모듈 정보를 미리 읽어 캐시에 올림 (파일 읽기만 하므로 병렬로 해도 안전)
+    // 번들 안의 큰 샘플 리소스까지 읽지 않도록 모듈 로드가 실제로 여는 파일만 읽음
+    juce::Array<juce::File> files;
+    for (const auto& entry : juce::RangedDirectoryIterator(bundle.getChildFile("Contents/MacOS"), false, "*", juce::File::findFiles))
+    {
+        files.add(entry.getFile());
+    }
+    files.add(bundle.getChildFile("Contents/Resources/moduleinfo.json"));
+    files.add(bundle.getChildFile("Contents/Info.plist"));
+    
+    juce::HeapBlock<char> chunk(prefetchChunkBytes);
+    
+    for (const auto& file : files)
+    {
+        juce::FileInputStream stream(file);
+        if (!stream.openedOk()) { continue; }
+        
+        while (stream.read(chunk.get(), prefetchChunkBytes) > 0) {}
+    }
+}
+
+void LoadScheduler::startDescribing(const juce::String& pluginPath)
+{
+    prefetchPool.addJob([this, pluginPath]()
+    {
+        prefetchBundle(juce::File(pluginPath));
+        describe(pluginPath);
+    });
+}
+
+void LoadScheduler::describe(const juce::String& pluginPath)
+{
+    describePool.addJob([this, pluginPath]()
+    {
+        juce::AudioPluginFormatManager formatManager;
+        formatManager.addDefaultFormats();
+        
+        juce::PluginDescription description;
+        juce::String error;
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        const auto found = VST3LoaderAudioProcessor::findHostablePluginDescription(formatManager, pluginPath,
+                                                                                   description, error);
+        
+        const juce::ScopedLock sl(lock);
+        auto& cached = descriptions[pluginPath];
+        cached.isDone = true;
+        cached.found = found;
+        cached.description = description;
+        cached.error = error;
+        cached.describeMilliseconds = juce::Time::getMillisecondCounterHiRes() - start;
+    });
+}
+
+void LoadScheduler::cancel(const void* owner)
+{
+    const juce::ScopedLock sl(lock);
+    
+    const auto numBefore = requests.size();
+    requests.erase(std::remove_if(requests.begin(), requests.end(), [owner](const Request& r) { return r.owner == owner; }),
+                   requests.end());
+    numCompletedInBatch += (int) (numBefore - requests.size());
+}
+
+void LoadScheduler::timerCallback()
+{
+    // 준비된 요청은 앞의 것이 끝나면 바로 이어서 넘기되, 틱마다 시간 예산을 넘으면 다음 틱으로 미뤄 UI 이벤트가 끼어들게 함
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    
+    while (dispatchNext())
+    {
+        if (juce::Time::getMillisecondCounterHiRes() - start >= dispatchBudgetMs) { return; }
+    }
+}
+
+bool LoadScheduler::dispatchNext()
+{
+    Request next;
+    CachedDescription result;
+    {
+        const juce::ScopedLock sl(lock);
+        
+        if (requests.empty())
+        {
+            numRequestedInBatch = 0;
+            numCompletedInBatch = 0;
+            stopTimer();
+            return false;
+        }
+        
+        // 설명이 준비된 요청 중 우선순위가 가장 높고, 같으면 먼저 들어온 것
+        auto best = requests.end();
+        int bestPriority = 0;
+        
+        for (auto it = requests.begin(); it != requests.end(); ++it)
+        {
+            if (!descriptions[it->pluginPath].isDone) { continue; }
+            
+            const auto priority = it->priority != nullptr ? it->priority() : 0;
+            if (best == requests.end() || priority > bestPriority || (priority == bestPriority && it->order < best->order))
+            {
+                best = it;
+                bestPriority = priority;
+            }
+        }
+        
+        if (best == requests.end()) { return false; }
+        
+        next = std::move(*best);
+        requests.erase(best);
+        result = descriptions[next.pluginPath];
+        ++numCompletedInBatch;
+    }
+    
+    next.callback(result.found, result.description, result.error, result.describeMilliseconds);
+    return true;
+}
+
+bool LoadScheduler::isBusy() const
+{
+    const juce::ScopedLock sl(lock);
+    return !requests.empty();
+}
+
+juce::String LoadScheduler::getProgressText() const
+{
+    const juce::ScopedLock sl(lock);
+    if (requests.empty() || numRequestedInBatch <= 1) { return {}; }
+    
+    return "Loading plugins " + juce::String(numCompletedInBatch) + "/" + juce::String(numRequestedInBatch);
+}
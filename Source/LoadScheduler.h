@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 세션을 열 때 여러 래퍼 인스턴스의 로드를 조율하는 프로세스 공용 스케줄러
+// - 플러그인 설명 찾기는 경로마다 한 번만 함. 번들 파일을 읽어 디스크 캐시에 올리는 단계는 코어 수만큼 병렬로,
+//   모듈 로드와 스캔은 백그라운드 스레드 하나에서 차례로 함 (JUCE 의 VST3 모듈 로드는 스레드 안전하지 않음)
+// - 메시지 스레드에서 해야 하는 나머지 단계는 우선순위 순으로 틱마다 시간 예산만큼 넘기고, 틱 사이에 UI 이벤트가 처리되게 함
+class LoadScheduler : private juce::Timer
+{
+public:
+    using DescriptionCallback = std::function<void(bool found, const juce::PluginDescription&, const juce::String& error,
+                                                   double describeMilliseconds)>;
+    using PriorityFunction = std::function<int()>;
+    
+    LoadScheduler();
+    ~LoadScheduler() override;
+    
+    // 아무 스레드에서나 호출 가능. 콜백은 메시지 스레드에서 불림
+    void requestDescription(const void* owner, const juce::String& pluginPath,
+                            PriorityFunction priority, DescriptionCallback callback);
+    void cancel(const void* owner);
+    
+    bool isBusy() const;
+    juce::String getProgressText() const;
+    
+private:
+    struct CachedDescription
+    {
+        bool isDone = false;
+        bool found = false;
+        juce::PluginDescription description;
+        juce::String error;
+        juce::Time modificationTime;
+        double describeMilliseconds = 0.0;
+    };
+    
+    struct Request
+    {
+        const void* owner;
+        juce::String pluginPath;
+        PriorityFunction priority;
+        DescriptionCallback callback;
+        juce::int64 order;
+    };
+    
+    juce::CriticalSection lock;
+    std::map<juce::String, CachedDescription> descriptions;
+    std::vector<Request> requests;
+    juce::ThreadPool prefetchPool;
+    juce::ThreadPool describePool;
+    juce::int64 requestCounter = 0;
+    int numRequestedInBatch = 0;
+    int numCompletedInBatch = 0;
+    
+    static constexpr int dispatchIntervalMs = 1;
+    static constexpr double dispatchBudgetMs = 10.0;
+    static constexpr int prefetchChunkBytes = 1 << 20;
+    
+    static void prefetchBundle(const juce::File& bundle);
+    void startDescribing(const juce::String& pluginPath);
+    void describe(const juce::String& pluginPath);
+    bool dispatchNext();
+    void timerCallback() override;
+    
+    JUCE_DECLARE_WEAK_REFERENCEABLE (LoadScheduler)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoadScheduler)
+};
@@ -0,0 +1,500 @@
+#include "MidiLearn.h"
+
+juce::String MidiLearn::Mapping::getDescription() const
+{
+    return juce::String(isNrpn ? "NRPN " : "CC ") + juce::String(controller)
+         + (channel == 0 ? juce::String(" (any channel)") : " ch " + juce::String(channel))
+         + " -> " + parameterName;
+}
+
+MidiLearn::MidiLearn()
+{
+    nrpnNumbers.fill(-1);
+    nrpnValues.fill(0);
+    changes.reserve(maxChangesPerBlock);
+    passedMidi.ensureSize(midiBufferBytes);
+    sliceMidi.ensureSize(midiBufferBytes);
+    outputMidi.ensureSize(midiBufferBytes);
+}
+
+MidiLearn::~MidiLearn()
+{
+    cancelPendingUpdate();
+    stopTimer();
+    if (instance != nullptr) { instance->removeListener(this); }
+}
+
+void MidiLearn::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    publishTable();
+}
+
+void MidiLearn::setInstance(juce::AudioPluginInstance* newInstance)
+{
+    if (instance != nullptr) { instance->removeListener(this); }
+    instance = newInstance;
+    if (instance != nullptr) { instance->addListener(this); }
+    
+    cancelLearning();
+    setParameters(instance != nullptr ? instance->getParameters() : juce::Array<juce::AudioProcessorParameter*>());
+}
+
+void MidiLearn::setParameters(const juce::Array<juce::AudioProcessorParameter*>& newParameters)
+{
+    parameters = newParameters;
+    publishTable();
+}
+
+void MidiLearn::setPluginPath(const juce::String& pluginPath)
+{
+    // 연결은 파라미터 번호로 저장하므로 다른 플러그인을 열면 버림
+    {
+        const juce::ScopedLock sl(mappingsLock);
+        if (pluginPath == mappingsPluginPath) { return; }
+        
+        mappings.clear();
+        mappingsPluginPath = pluginPath;
+    }
+    
+    publishTable();
+}
+
+std::vector<MidiLearn::Mapping> MidiLearn::getMappings() const
+{
+    const juce::ScopedLock sl(mappingsLock);
+    return mappings;
+}
+
+void MidiLearn::addMapping(const Mapping& mapping)
+{
+    {
+        const juce::ScopedLock sl(mappingsLock);
+        
+        // 같은 컨트롤러는 한 파라미터에만 연결
+        mappings.erase(std::remove_if(mappings.begin(), mappings.end(), [&](const Mapping& existing)
+        {
+            return existing.channel == mapping.channel && existing.controller == mapping.controller && existing.isNrpn == mapping.isNrpn;
+        }), mappings.end());
+        
+        mappings.push_back(mapping);
+    }
+    
+    publishTable();
+}
+
+void MidiLearn::removeMapping(int index)
+{
+    {
+        const juce::ScopedLock sl(mappingsLock);
+        if (!juce::isPositiveAndBelow(index, (int) mappings.size())) { return; }
+        mappings.erase(mappings.begin() + index);
+    }
+    
+    publishTable();
+}
+
+void MidiLearn::clearMappings()
+{
+    {
+        const juce::ScopedLock sl(mappingsLock);
+        mappings.clear();
+    }
+    
+    publishTable();
+}
+
+void MidiLearn::startLearning()
+{
+    learnParameter.store(-1);
+    hasLearnedController.store(false);
+    learnState.store(LearnState::waitingForParameter);
+    
+    // 오디오 스레드가 연결이 없을 때도 이벤트를 보도록 빈 표라도 내보냄
+    publishTable();
+}
+
+void MidiLearn::cancelLearning()
+{
+    learnState.store(LearnState::idle);
+    learnParameter.store(-1);
+}
+
+juce::String MidiLearn::getLearnStatus() const
+{
+    switch (learnState.load())
+    {
+        case LearnState::waitingForParameter:
+            return "move a plugin control";
+        
+        case LearnState::waitingForController:
+            if (auto* parameter = parameters[learnParameter.load()])
+            {
+                return "move a MIDI controller for " + parameter->getName(64);
+            }
+            return "move a MIDI controller";
+        
+        case LearnState::idle:
+            break;
+    }
+    
+    return {};
+}
+
+std::unique_ptr<juce::XmlElement> MidiLearn::createXml() const
+{
+    const juce::ScopedLock sl(mappingsLock);
+    if (mappings.empty()) { return nullptr; }
+    
+    auto xml = std::make_unique<juce::XmlElement>(xmlTag);
+    
+    for (const auto& mapping : mappings)
+    {
+        auto* element = xml->createNewChildElement("mapping");
+        element->setAttribute("channel", mapping.channel);
+        element->setAttribute("controller", mapping.controller);
+        element->setAttribute("nrpn", mapping.isNrpn);
+        element->setAttribute("parameter", mapping.parameterIndex);
+        element->setAttribute("name", mapping.parameterName);
+    }
+    
+    return xml;
+}
+
+void MidiLearn::restoreFromXml(const juce::XmlElement* xml, const juce::String& pluginPath)
+{
+    {
+        const juce::ScopedLock sl(mappingsLock);
+        mappings.clear();
+        mappingsPluginPath = pluginPath;
+        
+        if (xml != nullptr)
+        {
+            for (auto* element : xml->getChildWithTagNameIterator("mapping"))
+            {
+                Mapping mapping;
+                mapping.channel = juce::jlimit(0, 16, element->getIntAttribute("channel"));
+                mapping.controller = element->getIntAttribute("controller");
+                mapping.isNrpn = element->getBoolAttribute("nrpn");
+                mapping.parameterIndex = element->getIntAttribute("parameter", -1);
+                mapping.parameterName = element->getStringAttribute("name");
+                mappings.push_back(mapping);
+            }
+        }
+    }
+    
+    publishTable();
+}
+
+float MidiLearn::Target::quantise(float newValue) const
+{
+    if (numSteps == 0) { return newValue; }
+    
+    const auto maxStep = (float) (numSteps - 1);
+    return std::round(newValue * maxStep) / maxStep;
+}
+
+int MidiLearn::Table::findNrpnTarget(int channelIndex, int number) const
+{
+    const auto key = channelIndex << 14 | number;
+    const auto it = std::lower_bound(nrpnTargets.begin(), nrpnTargets.end(), std::make_pair(key, -1));
+    return it != nrpnTargets.end() && it->first == key ? it->second : -1;
+}
+
+void MidiLearn::publishTable()
+{
+    auto table = std::make_unique<Table>();
+    table->generation = nextGeneration++;
+    table->controllerTargets.fill(-1);
+    std::map<int, int> nrpnTargets;
+    
+    auto getTarget = [&](juce::AudioProcessorParameter* parameter)
+    {
+        for (size_t i = 0; i < table->targets.size(); ++i)
+        {
+            if (table->targets[i].parameter == parameter) { return (int) i; }
+        }
+        
+        Target target;
+        target.parameter = parameter;
+        target.value.reset(sampleRate, smoothingSeconds);
+        target.value.setCurrentAndTargetValue(parameter->getValue());
+        target.notifiedValue = parameter->getValue();
+        
+        const auto numSteps = parameter->getNumSteps();
+        target.numSteps = numSteps > 1 && numSteps < juce::AudioProcessor::getDefaultNumParameterSteps() ? numSteps : 0;
+        table->targets.push_back(std::move(target));
+        return (int) table->targets.size() - 1;
+    };
+    
+    {
+        const juce::ScopedLock sl(mappingsLock);
+        
+        // 모든 채널 연결을 먼저 채우고 채널을 지정한 연결이 덮어씀
+        for (const auto specificChannel : { false, true })
+        {
+            for (const auto& mapping : mappings)
+            {
+                auto* parameter = parameters[mapping.parameterIndex];
+                if (parameter == nullptr || (mapping.channel != 0) != specificChannel) { continue; }
+                
+                const auto target = getTarget(parameter);
+                
+                for (int channelIndex = 0; channelIndex < 16; ++channelIndex)
+                {
+                    if (mapping.channel != 0 && mapping.channel != channelIndex + 1) { continue; }
+                    
+                    if (mapping.isNrpn)
+                        nrpnTargets[channelIndex << 14 | (mapping.controller & 0x3fff)] = target;
+                    else
+                        table->controllerTargets[(size_t) (channelIndex * 128 + (mapping.controller & 0x7f))] = (juce::int16) target;
+                }
+            }
+        }
+    }
+    
+    table->nrpnTargets.assign(nrpnTargets.begin(), nrpnTargets.end());
+    
+    latestTable.store(tables.add(table.release()), std::memory_order_release);
+    releaseRetiredTables();
+}
+
+void MidiLearn::releaseRetiredTables()
+{
+    // 오디오 스레드가 쓰기 시작한 표보다 오래된 표는 다시 읽히지 않음
+    if (auto* inUse = tableInUse.load(std::memory_order_acquire))
+    {
+        const auto generationInUse = inUse->generation;
+        
+        for (int i = tables.size(); --i >= 0;)
+        {
+            if (tables.getUnchecked(i)->generation < generationInUse) { tables.remove(i); }
+        }
+    }
+    
+    if (tables.size() > 1)
+        startTimer(1000);
+    else
+        stopTimer();
+}
+
+bool MidiLearn::translateEvent(const Table& table, const juce::uint8* data, int numBytes, int sampleOffset)
+{
+    if (numBytes != 3 || (data[0] & 0xf0) != 0xb0) { return false; }
+    
+    const auto channelIndex = data[0] & 0x0f;
+    const auto controller = (int) data[1];
+    const auto value = (int) data[2];
+    auto& nrpnNumber = nrpnNumbers[(size_t) channelIndex];
+    auto& nrpnValue = nrpnValues[(size_t) channelIndex];
+    
+    // NRPN 번호(99, 98)와 RPN 선택(101, 100)은 그대로 보내고, 연결된 NRPN 의 데이터 입력(6, 38)만 뺌
+    switch (controller)
+    {
+        case 99:
+            nrpnNumber = value << 7;
+            return false;
+        
+        case 98:
+            nrpnNumber = (nrpnNumber < 0 ? 0 : (nrpnNumber & 0x3f80)) | value;
+            return false;
+        
+        case 101:
+        case 100:
+            nrpnNumber = -1;
+            return false;
+        
+        case 6:
+        case 38:
+        {
+            if (nrpnNumber < 0) { return false; }
+            
+            nrpnValue = controller == 6 ? value << 7 : ((nrpnValue & 0x3f80) | value);
+            learnFromEvent(channelIndex, nrpnNumber, true);
+            
+            const auto target = table.findNrpnTarget(channelIndex, nrpnNumber);
+            if (target < 0) { return false; }
+            
+            addChange(sampleOffset, target, (float) nrpnValue / 16383.0f);
+            return true;
+        }
+        
+        default:
+            break;
+    }
+    
+    learnFromEvent(channelIndex, controller, false);
+    
+    const auto target = (int) table.controllerTargets[(size_t) (channelIndex * 128 + controller)];
+    if (target < 0) { return false; }
+    
+    addChange(sampleOffset, target, (float) value / 127.0f);
+    return true;
+}
+
+void MidiLearn::addChange(int sampleOffset, int target, float value)
+{
+    // 표가 차면 마지막 변경을 덮어씀 (같은 블록 안의 이전 값은 어차피 스무딩으로 지나감)
+    if ((int) changes.size() < maxChangesPerBlock)
+        changes.push_back({ sampleOffset, target, value });
+    else
+        changes.back() = { sampleOffset, target, value };
+}
+
+void MidiLearn::learnFromEvent(int channelIndex, int controller, bool isNrpn)
+{
+    if (learnState.load(std::memory_order_relaxed) != LearnState::waitingForController) { return; }
+    
+    learnedChannel.store(channelIndex + 1);
+    learnedController.store(controller);
+    learnedIsNrpn.store(isNrpn);
+    hasLearnedController.store(true);
+    learnState.store(LearnState::idle);
+    triggerAsyncUpdate();
+}
+
+void MidiLearn::audioProcessorParameterChanged(juce::AudioProcessor*, int parameterIndex, float)
+{
+    // 연결된 컨트롤러나 호스트 자동화로 바뀐 값은 학습 대상이 아님
+    if (learnState.load(std::memory_order_relaxed) == LearnState::idle || isNotifyingHost) { return; }
+    if (!juce::MessageManager::existsAndIsCurrentThread()) { return; }
+    
+    selectLearnParameter(parameterIndex);
+}
+
+void MidiLearn::audioProcessorParameterChangeGestureBegin(juce::AudioProcessor*, int parameterIndex)
+{
+    if (learnState.load(std::memory_order_relaxed) == LearnState::idle) { return; }
+    if (!juce::MessageManager::existsAndIsCurrentThread()) { return; }
+    
+    selectLearnParameter(parameterIndex);
+}
+
+void MidiLearn::selectLearnParameter(int parameterIndex)
+{
+    if (learnParameter.load() == parameterIndex) { return; }
+    
+    learnParameter.store(parameterIndex);
+    learnState.store(LearnState::waitingForController);
+    if (onMappingsChanged != nullptr) { onMappingsChanged(); }
+}
+
+void MidiLearn::notifyHost()
+{
+    // 오디오 스레드가 setValue 로 바꾼 값을 호스트와 연결된 멀티 모노, 배치 인스턴스에 알림
+    auto* table = latestTable.load(std::memory_order_acquire);
+    if (table == nullptr) { return; }
+    
+    const juce::ScopedValueSetter<bool> notifying(isNotifyingHost, true);
+    
+    for (auto& target : table->targets)
+    {
+        const auto value = target.parameter->getValue();
+        if (value == target.notifiedValue) { continue; }
+        
+        target.notifiedValue = value;
+        target.parameter->sendValueChangedMessageToListeners(value);
+    }
+}
+
+void MidiLearn::handleAsyncUpdate()
+{
+    if (hasChangedParameters.exchange(false, std::memory_order_acquire)) { notifyHost(); }
+    if (!hasLearnedController.exchange(false)) { return; }
+    
+    const auto parameterIndex = learnParameter.exchange(-1);
+    auto* parameter = parameters[parameterIndex];
+    if (parameter == nullptr) { return; }
+    
+    Mapping mapping;
+    mapping.channel = learnedChannel.load();
+    mapping.controller = learnedController.load();
+    mapping.isNrpn = learnedIsNrpn.load();
+    mapping.parameterIndex = parameterIndex;
+    mapping.parameterName = parameter->getName(64);
+    addMapping(mapping);
+    
+    if (onMappingsChanged != nullptr) { onMappingsChanged(); }
+}
+
+void MidiLearn::timerCallback()
+{
+    releaseRetiredTables();
+}
+
+std::vector<MidiLearn::ThroughputResult> MidiLearn::measureThroughput(const std::vector<int>& blockSizes,
+                                                                      int numMappings,
+                                                                      int numIterations)
+{
+    std::vector<ThroughputResult> results;
+    
+    // NRPN 용 컨트롤러를 뺀 CC 를 채널마다 차례로 씀
+    juce::Array<int> controllers;
+    for (int controller = 0; controller < 128; ++controller)
+    {
+        if (controller != 6 && controller != 38 && (controller < 98 || controller > 101)) { controllers.add(controller); }
+    }
+    
+    juce::OwnedArray<juce::AudioParameterFloat> ownedParameters;
+    juce::Array<juce::AudioProcessorParameter*> parameters;
+    MidiLearn midiLearn;
+    midiLearn.prepare(48000.0);
+    
+    for (int i = 0; i < numMappings; ++i)
+    {
+        parameters.add(ownedParameters.add(new juce::AudioParameterFloat(juce::ParameterID("p" + juce::String(i), 1),
+                                                                          "Parameter " + juce::String(i),
+                                                                          0.0f, 1.0f, 0.0f)));
+    }
+    
+    midiLearn.setParameters(parameters);
+    
+    for (int i = 0; i < numMappings; ++i)
+    {
+        Mapping mapping;
+        mapping.channel = 1 + (i / controllers.size()) % 16;
+        mapping.controller = controllers[i % controllers.size()];
+        mapping.parameterIndex = i;
+        midiLearn.addMapping(mapping);
+    }
+    
+    for (const auto blockSize : blockSizes)
+    {
+        // 샘플마다 연결된 CC 하나, 16 샘플마다 그대로 지나가는 노트 하나
+        juce::MidiBuffer templateMidi;
+        for (int s = 0; s < blockSize; ++s)
+        {
+            const auto i = s % numMappings;
+            templateMidi.addEvent(juce::MidiMessage::controllerEvent(1 + (i / controllers.size()) % 16,
+                                                                     controllers[i % controllers.size()],
+                                                                     (s * 7) % 128), s);
+            if (s % 16 == 0) { templateMidi.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100), s); }
+        }
+        
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        buffer.clear();
+        juce::MidiBuffer midiMessages;
+        midiMessages.ensureSize(midiBufferBytes);
+        juce::int64 numSlices = 0;
+        
+        const auto start = juce::Time::getHighResolutionTicks();
+        
+        for (int iteration = 0; iteration < numIterations; ++iteration)
+        {
+            midiMessages.clear();
+            midiMessages.addEvents(templateMidi, 0, -1, 0);
+            
+            midiLearn.process(buffer, midiMessages, [&](juce::AudioBuffer<float>& slice, juce::MidiBuffer&)
+            {
+                slice.applyGain(0.5f);
+                ++numSlices;
+            });
+        }
+        
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+        const auto numEvents = (double) numIterations * blockSize;
+        results.push_back({ blockSize, blockSize, elapsed / numEvents, (double) numSlices / numIterations });
+    }
+    
+    return results;
+}
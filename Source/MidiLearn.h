@@ -0,0 +1,280 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인 파라미터에 MIDI 컨트롤러(CC, NRPN)를 연결하는 MIDI 학습 표
+// 연결 표는 메시지 스레드에서 새로 만들어 원자 포인터로 내보내고, 오디오 스레드는 락이나 할당 없이 읽기만 함
+// 연결된 이벤트는 MIDI 버퍼에서 빼고, 값이 실제로 바뀌는 위치에서만 블록을 나눠 호출해서 (최대 sliceSamples 오차로) 그 샘플부터 부드럽게 바뀌게 함
+// 오디오 스레드는 setValue 만 부르고, 호스트와 다른 리스너에는 메시지 스레드에서 알림
+class MidiLearn : private juce::AudioProcessorListener,
+                  private juce::AsyncUpdater,
+                  private juce::Timer
+{
+public:
+    struct Mapping
+    {
+        int channel = 0; // 1-16, 0 이면 모든 채널
+        int controller = 0; // CC 0-127 또는 NRPN 0-16383
+        bool isNrpn = false;
+        int parameterIndex = -1;
+        juce::String parameterName;
+        
+        juce::String getDescription() const;
+    };
+    
+    MidiLearn();
+    ~MidiLearn() override;
+    
+    // 메시지 스레드에서 호출
+    void prepare(double sampleRate);
+    void setInstance(juce::AudioPluginInstance* instance);
+    void setParameters(const juce::Array<juce::AudioProcessorParameter*>& parameters);
+    void setPluginPath(const juce::String& pluginPath);
+    
+    std::vector<Mapping> getMappings() const;
+    void addMapping(const Mapping& mapping);
+    void removeMapping(int index);
+    void clearMappings();
+    
+    // 학습: 플러그인의 컨트롤을 움직인 다음 MIDI 컨트롤러를 움직이면 둘을 연결함
+    void startLearning();
+    void cancelLearning();
+    bool isLearning() const { return learnState.load() != LearnState::idle; }
+    juce::String getLearnStatus() const;
+    std::function<void()> onMappingsChanged;
+    
+    std::unique_ptr<juce::XmlElement> createXml() const;
+    void restoreFromXml(const juce::XmlElement* xml, const juce::String& pluginPath);
+    
+    // 오디오 스레드에서 호출 (processPlugin 은 나눈 버퍼와 MIDI 를 받아 호스팅 플러그인을 부름)
+    template<typename SampleType, typename ProcessFunction>
+    void process(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages, ProcessFunction&& processPlugin);
+    
+    struct ThroughputResult
+    {
+        int blockSize;
+        int eventsPerBlock;
+        double nanosecondsPerEvent;
+        double slicesPerBlock;
+    };
+    
+    // 샘플마다 연결된 CC 가 오는 빽빽한 스트림에서 이벤트당 처리 비용 (VST3LoaderHost --midi-learn-benchmark)
+    static std::vector<ThroughputResult> measureThroughput(const std::vector<int>& blockSizes,
+                                                           int numMappings = 64,
+                                                           int numIterations = 2000);
+    
+    static constexpr const char* xmlTag = "midi_learn";
+    static constexpr int sliceSamples = 64;
+    static constexpr double smoothingSeconds = 0.005;
+    
+private:
+    struct Target
+    {
+        juce::AudioProcessorParameter* parameter = nullptr;
+        juce::SmoothedValue<float> value;
+        int numSteps = 0; // 단계가 있는 파라미터면 단계 수, 연속이면 0
+        bool needsUpdate = false;
+        float notifiedValue = 0.0f; // 메시지 스레드 전용
+        
+        float quantise(float newValue) const;
+    };
+    
+    // 한 번 내보낸 뒤에는 대상의 스무딩 상태만 오디오 스레드가 바꿈
+    struct Table
+    {
+        juce::uint32 generation = 0;
+        std::vector<Target> targets;
+        std::array<juce::int16, 16 * 128> controllerTargets;
+        std::vector<std::pair<int, int>> nrpnTargets; // (채널 << 14 | 번호, 대상), 정렬됨
+        
+        int findNrpnTarget(int channelIndex, int number) const;
+    };
+    
+    struct Change
+    {
+        int sampleOffset;
+        int target;
+        float value;
+    };
+    
+    enum class LearnState
+    {
+        idle,
+        waitingForParameter,
+        waitingForController
+    };
+    
+    // getStateInformation 은 다른 스레드에서도 불릴 수 있어 연결 목록만 따로 보호
+    juce::CriticalSection mappingsLock;
+    std::vector<Mapping> mappings;
+    juce::String mappingsPluginPath;
+    
+    // 메시지 스레드 전용
+    juce::Array<juce::AudioProcessorParameter*> parameters;
+    juce::AudioPluginInstance* instance = nullptr;
+    juce::OwnedArray<Table> tables;
+    juce::uint32 nextGeneration = 1;
+    double sampleRate = 44100.0;
+    
+    std::atomic<Table*> latestTable { nullptr };
+    std::atomic<Table*> tableInUse { nullptr };
+    
+    std::atomic<LearnState> learnState { LearnState::idle };
+    std::atomic<int> learnParameter { -1 };
+    std::atomic<int> learnedChannel { 0 };
+    std::atomic<int> learnedController { 0 };
+    std::atomic<bool> learnedIsNrpn { false };
+    std::atomic<bool> hasLearnedController { false };
+    std::atomic<bool> hasChangedParameters { false };
+    bool isNotifyingHost = false;
+    
+    // 오디오 스레드 전용
+    std::array<int, 16> nrpnNumbers;
+    std::array<int, 16> nrpnValues;
+    std::vector<Change> changes;
+    juce::MidiBuffer passedMidi;
+    juce::MidiBuffer sliceMidi;
+    juce::MidiBuffer outputMidi;
+    
+    static constexpr int maxChangesPerBlock = 1024;
+    static constexpr int midiBufferBytes = 16384;
+    
+    void publishTable();
+    void releaseRetiredTables();
+    void notifyHost();
+    
+    // 이벤트가 연결된 컨트롤러면 변경을 기록하고 true 를 돌려줌
+    bool translateEvent(const Table& table, const juce::uint8* data, int numBytes, int sampleOffset);
+    void addChange(int sampleOffset, int target, float value);
+    void learnFromEvent(int channelIndex, int controller, bool isNrpn);
+    
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int parameterIndex, float) override;
+    void audioProcessorParameterChangeGestureBegin(juce::AudioProcessor*, int parameterIndex) override;
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+    void selectLearnParameter(int parameterIndex);
+    
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiLearn)
+};
+
+template<typename SampleType, typename ProcessFunction>
+void MidiLearn::process(juce::AudioBuffer<SampleType>& buffer,
+                        juce::MidiBuffer& midiMessages,
+                        ProcessFunction&& processPlugin)
+{
+    // 내보낸 표는 더 새 표를 쓰기 시작했다고 알린 뒤에만 메시지 스레드가 지움
+    auto* table = latestTable.load(std::memory_order_acquire);
+    if (table != tableInUse.load(std::memory_order_relaxed)) { tableInUse.store(table, std::memory_order_release); }
+    
+    if (table == nullptr || (table->targets.empty() && learnState.load(std::memory_order_relaxed) == LearnState::idle))
+    {
+        processPlugin(buffer, midiMessages);
+        return;
+    }
+    
+    const auto numSamples = buffer.getNumSamples();
+    changes.clear();
+    
+    if (!midiMessages.isEmpty())
+    {
+        passedMidi.clear();
+        
+        for (const auto metadata : midiMessages)
+        {
+            if (!translateEvent(*table, metadata.data, metadata.numBytes, metadata.samplePosition))
+            {
+                passedMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+            }
+        }
+        
+        midiMessages.clear();
+        midiMessages.addEvents(passedMidi, 0, -1, 0);
+    }
+    
+    auto isSmoothing = false;
+    for (const auto& target : table->targets)
+    {
+        isSmoothing |= target.needsUpdate || target.value.isSmoothing();
+    }
+    
+    if (changes.empty() && !isSmoothing)
+    {
+        processPlugin(buffer, midiMessages);
+        return;
+    }
+    
+    // 값이 실제로 바뀌는 위치에서만 블록을 나눠서 호출 (같은 값이 다시 오거나 단계 파라미터가 같은 단계에 머물면 이어서 처리)
+    outputMidi.clear();
+    size_t nextChange = 0;
+    auto sliceStart = 0;
+    auto hasChanged = false;
+    
+    auto processSlice = [&](int sliceEnd)
+    {
+        const auto length = sliceEnd - sliceStart;
+        if (length <= 0) { return; }
+        
+        juce::AudioBuffer<SampleType> slice(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), sliceStart, length);
+        sliceMidi.clear();
+        sliceMidi.addEvents(midiMessages, sliceStart, length, -sliceStart);
+        
+        processPlugin(slice, sliceMidi);
+        outputMidi.addEvents(sliceMidi, 0, length, sliceStart);
+        sliceStart = sliceEnd;
+    };
+    
+    for (int position = 0; position < numSamples;)
+    {
+        for (; nextChange < changes.size() && changes[nextChange].sampleOffset <= position; ++nextChange)
+        {
+            auto& target = table->targets[(size_t) changes[nextChange].target];
+            target.value.setTargetValue(changes[nextChange].value);
+            target.needsUpdate = true;
+        }
+        
+        auto end = numSamples;
+        isSmoothing = false;
+        
+        for (auto& target : table->targets)
+        {
+            if (!target.needsUpdate && !target.value.isSmoothing()) { continue; }
+            
+            const auto value = target.quantise(target.value.getCurrentValue());
+            if (value != target.parameter->getValue())
+            {
+                // 앞부분은 이전 값으로 먼저 처리해야 이 위치부터 새 값이 적용됨
+                processSlice(position);
+                target.parameter->setValue(value);
+                hasChanged = true;
+            }
+            
+            target.needsUpdate = target.value.isSmoothing();
+            isSmoothing |= target.needsUpdate;
+        }
+        
+        if (isSmoothing) { end = juce::jmin(end, position + sliceSamples); }
+        if (nextChange < changes.size())
+        {
+            end = juce::jmin(end, juce::jmax(position + sliceSamples, changes[nextChange].sampleOffset));
+        }
+        
+        for (auto& target : table->targets)
+        {
+            target.value.skip(end - position);
+        }
+        
+        position = end;
+    }
+    
+    processSlice(numSamples);
+    
+    midiMessages.clear();
+    midiMessages.addEvents(outputMidi, 0, -1, 0);
+    
+    if (hasChanged)
+    {
+        hasChangedParameters.store(true, std::memory_order_release);
+        triggerAsyncUpdate();
+    }
+}
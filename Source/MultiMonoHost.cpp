@@ -0,0 +1,156 @@
+#include "MultiMonoHost.h"
+
+MultiMonoHost::MultiMonoHost(juce::AudioPluginFormatManager& manager,
+                             juce::AudioPluginInstance& primaryInstance)
+    : formatManager(manager), primary(primaryInstance)
+{
+    primary.addListener(this);
+}
+
+MultiMonoHost::~MultiMonoHost()
+{
+    primary.removeListener(this);
+    workerPool.stop();
+    releaseResources();
+}
+
+bool MultiMonoHost::setMonoLayout(juce::AudioPluginInstance& instance)
+{
+    auto layout = instance.getBusesLayout();
+    
+    for (auto& bus : layout.inputBuses)  { bus = juce::AudioChannelSet::disabled(); }
+    for (auto& bus : layout.outputBuses) { bus = juce::AudioChannelSet::disabled(); }
+    
+    if (!layout.inputBuses.isEmpty())  { layout.inputBuses.getReference(0) = juce::AudioChannelSet::mono(); }
+    if (!layout.outputBuses.isEmpty()) { layout.outputBuses.getReference(0) = juce::AudioChannelSet::mono(); }
+    
+    return instance.checkBusesLayoutSupported(layout) && instance.setBusesLayout(layout);
+}
+
+std::unique_ptr<juce::AudioPluginInstance> MultiMonoHost::createChannelInstance(juce::String& error)
+{
+    auto instance = formatManager.createPluginInstance(primary.getPluginDescription(),
+                                                       preparedSampleRate > 0.0 ? preparedSampleRate : 44100.0,
+                                                       preparedBlockSize > 0 ? preparedBlockSize : 512,
+                                                       error);
+    if (instance == nullptr) { return nullptr; }
+    
+    if (!setMonoLayout(*instance))
+    {
+        error = "Plugin does not support a mono layout";
+        return nullptr;
+    }
+    
+    // 새 채널은 기본 인스턴스와 같은 상태에서 시작
+    juce::MemoryBlock state;
+    primary.getStateInformation(state);
+    if (!state.isEmpty())
+    {
+        instance->setStateInformation(state.getData(), (int) state.getSize());
+    }
+    
+    instance->setNonRealtime(primary.isNonRealtime());
+    
+    // 기본 인스턴스와 같은 래퍼 플레이헤드를 씀 (블록마다 바꾸지 않음)
+    instance->setPlayHead(primary.getPlayHead());
+    
+    if (preparedBlockSize > 0)
+    {
+        instance->setRateAndBufferSizeDetails(preparedSampleRate, preparedBlockSize);
+        instance->prepareToPlay(preparedSampleRate, preparedBlockSize);
+    }
+    
+    return instance;
+}
+
+bool MultiMonoHost::setNumChannels(int numChannels, juce::String& error)
+{
+    numChannels = juce::jmax(1, numChannels);
+    
+    while (instances.size() > numChannels - 1)
+    {
+        instances.getLast()->releaseResources();
+        instances.removeLast();
+        instanceMidiBuffers.removeLast();
+    }
+    
+    while (instances.size() < numChannels - 1)
+    {
+        auto instance = createChannelInstance(error);
+        if (instance == nullptr) { return false; }
+        
+        instances.add(instance.release());
+        instanceMidiBuffers.add(new juce::MidiBuffer())->ensureSize(midiBufferBytes);
+    }
+    
+    startWorkers();
+    return true;
+}
+
+void MultiMonoHost::prepare(double sampleRate, int samplesPerBlock)
+{
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+    
+    for (auto* instance : instances)
+    {
+        instance->releaseResources();
+        instance->setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+        instance->prepareToPlay(sampleRate, samplesPerBlock);
+    }
+    
+    startWorkers();
+}
+
+void MultiMonoHost::startWorkers()
+{
+    // 호출한 오디오 스레드도 한 채널을 맡으므로 작업자는 채널 수 - 1 개까지만 필요
+    const auto numWorkers = juce::jmin(instances.size(), juce::SystemStats::getNumCpus() - 1);
+    
+    if (numWorkers != workerPool.getNumWorkers())
+    {
+        workerPool.start(juce::jmax(0, numWorkers), preparedBlockSize, preparedSampleRate);
+    }
+}
+
+void MultiMonoHost::releaseResources()
+{
+    for (auto* instance : instances)
+    {
+        instance->releaseResources();
+    }
+}
+
+void MultiMonoHost::reset()
+{
+    for (auto* instance : instances)
+    {
+        instance->reset();
+    }
+}
+
+void MultiMonoHost::setParametersLinked(bool shouldLink)
+{
+    parametersLinked.store(shouldLink);
+}
+
+void MultiMonoHost::setNonRealtime(bool isNonRealtime)
+{
+    for (auto* instance : instances)
+    {
+        instance->setNonRealtime(isNonRealtime);
+    }
+}
+
+void MultiMonoHost::audioProcessorParameterChanged(juce::AudioProcessor*, int parameterIndex, float newValue)
+{
+    if (!parametersLinked.load()) { return; }
+    
+    for (auto* instance : instances)
+    {
+        if (auto* parameter = instance->getParameters()[parameterIndex])
+        {
+            parameter->setValue(newValue);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <JuceHeader.h>
+#include "RealtimeWorkerPool.h"
+
+// 모노 전용 플러그인을 채널마다 한 인스턴스씩 돌리는 멀티 모노 모드
+// 0번 채널은 래퍼가 가진 기본 인스턴스(에디터/상태 담당)를 그대로 쓰고,
+// 나머지 채널 인스턴스는 여기서 소유하며 블록마다 작업자 풀에서 병렬로 처리함
+class MultiMonoHost : private juce::AudioProcessorListener
+{
+public:
+    MultiMonoHost(juce::AudioPluginFormatManager& formatManager,
+                  juce::AudioPluginInstance& primaryInstance);
+    ~MultiMonoHost() override;
+    
+    // 메시지 스레드에서 호출
+    bool setNumChannels(int numChannels, juce::String& error);
+    void prepare(double sampleRate, int samplesPerBlock);
+    void releaseResources();
+    void reset();
+    void setParametersLinked(bool shouldLink);
+    void setNonRealtime(bool isNonRealtime);
+    int getNumChannels() const { return instances.size() + 1; }
+    
+    // 오디오 스레드에서 호출
+    template<typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer,
+                 juce::MidiBuffer& midiMessages,
+                 bool isActive);
+    
+    static bool setMonoLayout(juce::AudioPluginInstance& instance);
+    
+private:
+    template<typename SampleType>
+    struct BlockContext
+    {
+        MultiMonoHost* owner;
+        juce::AudioBuffer<SampleType>* buffer;
+        juce::MidiBuffer* midiMessages;
+        bool isActive;
+    };
+    
+    juce::AudioPluginFormatManager& formatManager;
+    juce::AudioPluginInstance& primary;
+    juce::OwnedArray<juce::AudioPluginInstance> instances;
+    juce::OwnedArray<juce::MidiBuffer> instanceMidiBuffers;
+    RealtimeWorkerPool workerPool;
+    std::atomic<bool> parametersLinked { true };
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+    
+    static constexpr int midiBufferBytes = 16384;
+    
+    template<typename SampleType>
+    static void processChannel(void* context, int channel);
+    
+    std::unique_ptr<juce::AudioPluginInstance> createChannelInstance(juce::String& error);
+    void startWorkers();
+    
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int parameterIndex, float newValue) override;
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiMonoHost)
+};
+
+template<typename SampleType>
+void MultiMonoHost::process(juce::AudioBuffer<SampleType>& buffer,
+                            juce::MidiBuffer& midiMessages,
+                            bool isActive)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), getNumChannels());
+    
+    for (int i = 0; i < numChannels - 1; ++i)
+    {
+        auto& channelMidi = *instanceMidiBuffers.getUnchecked(i);
+        channelMidi.clear();
+        channelMidi.addEvents(midiMessages, 0, buffer.getNumSamples(), 0);
+    }
+    
+    BlockContext<SampleType> context { this, &buffer, &midiMessages, isActive };
+    workerPool.run(numChannels, &MultiMonoHost::processChannel<SampleType>, &context);
+}
+
+template<typename SampleType>
+void MultiMonoHost::processChannel(void* context, int channel)
+{
+    auto& block = *static_cast<BlockContext<SampleType>*>(context);
+    auto& owner = *block.owner;
+    
+    // 채널 하나를 가리키는 모노 버퍼 (복사 없음)
+    SampleType* channelData[] = { block.buffer->getWritePointer(channel) };
+    juce::AudioBuffer<SampleType> monoBuffer(channelData, 1, block.buffer->getNumSamples());
+    
+    auto& instance = channel == 0 ? owner.primary : *owner.instances.getUnchecked(channel - 1);
+    auto& midiMessages = channel == 0 ? *block.midiMessages : *owner.instanceMidiBuffers.getUnchecked(channel - 1);
+    
+    if (block.isActive)
+        instance.processBlock(monoBuffer, midiMessages);
+    else
+        instance.processBlockBypassed(monoBuffer, midiMessages);
+}
@@ -0,0 +1,437 @@
+#include "OutOfProcessHost.h"
+
+class OutOfProcessHost::ProcessReaper : private juce::Thread
+{
+public:
+    ProcessReaper() : juce::Thread("Out-of-process host reaper")
+    {
+        startThread(juce::Thread::Priority::low);
+    }
+    
+    ~ProcessReaper() override
+    {
+        // 이 스레드는 다른 스레드를 기다리지 않으므로 메시지 스레드에서 멈춰도 됨
+        stopThread(quitTimeoutMs * 2);
+        
+        for (auto& entry : processes)
+        {
+            entry.process->kill();
+        }
+    }
+    
+    void add(std::unique_ptr<juce::ChildProcess> process)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            processes.push_back({ std::move(process), juce::Time::getMillisecondCounter() + (juce::uint32) quitTimeoutMs });
+        }
+        
+        notify();
+    }
+    
+private:
+    struct Entry
+    {
+        std::unique_ptr<juce::ChildProcess> process;
+        juce::uint32 deadline;
+    };
+    
+    juce::CriticalSection lock;
+    std::vector<Entry> processes;
+    
+    static constexpr int pollIntervalMs = 50;
+    
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            bool isEmpty;
+            {
+                const juce::ScopedLock sl(lock);
+                const auto now = juce::Time::getMillisecondCounter();
+                
+                processes.erase(std::remove_if(processes.begin(), processes.end(), [now](Entry& entry)
+                {
+                    if (!entry.process->isRunning()) { return true; }
+                    if (now < entry.deadline) { return false; }
+                    
+                    entry.process->kill();
+                    return true;
+                }), processes.end());
+                
+                isEmpty = processes.empty();
+            }
+            
+            wait(isEmpty ? -1 : pollIntervalMs);
+        }
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessReaper)
+};
+
+OutOfProcessHost::OutOfProcessHost(const juce::PluginDescription& description, const juce::MemoryBlock& innerState)
+    : pluginDescription(description),
+      lastKnownState(innerState)
+{
+}
+
+OutOfProcessHost::~OutOfProcessHost()
+{
+    stopTimer();
+    
+    const juce::ScopedLock sl(workerLock);
+    stopWorker(true);
+}
+
+juce::File OutOfProcessHost::getHelperExecutable()
+{
+    // VST3 Loader.component/Contents/MacOS/VST3 Loader -> Contents/Helpers/VST3LoaderHost.app
+    const auto pluginBinary = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+    return pluginBinary.getParentDirectory()
+                       .getSiblingFile("Helpers")
+                       .getChildFile("VST3LoaderHost.app/Contents/MacOS/VST3LoaderHost");
+}
+
+bool OutOfProcessHost::prepare(double sampleRate, int maxBlockSize)
+{
+    // 호스트가 prepareToPlay 를 메시지 스레드 밖에서 불러도 감시 타이머의 재시작과 겹치지 않게 함
+    const juce::ScopedLock workerSl(workerLock);
+    
+    if (childProcess != nullptr && preparedSampleRate == sampleRate && preparedBlockSize == maxBlockSize)
+    {
+        reset();
+        return true;
+    }
+    
+    stopWorker(true);
+    
+    // 이전 작업자가 끝날 때까지 기다리지 않으므로, 그 작업자가 보는 공유 메모리는 두고 새로 만듦
+    {
+        const juce::ScopedLock sl(stateLock);
+        transport.reset();
+        transport = SharedAudioTransport::create(maxBlockSize);
+        
+        if (transport == nullptr)
+        {
+            lastError = "Cannot create shared memory";
+            return false;
+        }
+    }
+    
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = maxBlockSize;
+    outputFifo.setSize(SharedAudioTransport::maxChannels, 2 * maxBlockSize);
+    
+    for (auto& dryBuffer : dryBuffers)
+    {
+        dryBuffer.setSize(SharedAudioTransport::maxChannels, maxBlockSize);
+    }
+    
+    lastRequestSequence = transport->getHeader().requestSequence.load();
+    reset();
+    
+    numFailedLaunches = 0;
+    if (!launchWorker()) { return false; }
+    
+    startTimer(watchdogIntervalMs);
+    return true;
+}
+
+void OutOfProcessHost::reset()
+{
+    // 최대 블록 크기만큼 무음을 미리 채워서 한 블록 늦게 도착하는 결과를 항상 받을 수 있게 함
+    outputFifo.clear();
+    fifoReadPosition = 0;
+    fifoNumReady = preparedBlockSize;
+    fifoNumChannels = 0;
+    pendingSequence = 0;
+}
+
+int OutOfProcessHost::getLatencySamples() const
+{
+    const auto pluginLatency = transport == nullptr ? 0 : transport->getHeader().pluginLatencySamples.load();
+    return preparedBlockSize + pluginLatency;
+}
+
+bool OutOfProcessHost::isWorkerReady() const
+{
+    return transport != nullptr && transport->getHeader().workerReady.load() != 0;
+}
+
+void OutOfProcessHost::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool isActive)
+{
+    const auto numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), SharedAudioTransport::maxChannels);
+    
+    if (transport == nullptr || numSamples > preparedBlockSize)
+    {
+        buffer.clear();
+        ++numFallbackBlocks;
+        return;
+    }
+    
+    auto& header = transport->getHeader();
+    const auto sequence = ++lastRequestSequence;
+    auto& slot = transport->getSlot(sequence);
+    auto& dryBuffer = dryBuffers[sequence & 1];
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        juce::FloatVectorOperations::copy(transport->getChannel(sequence, ch), buffer.getReadPointer(ch), numSamples);
+        dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    }
+    
+    slot.numChannels = numChannels;
+    slot.numSamples = numSamples;
+    slot.isActive = isActive ? 1 : 0;
+    slot.numMidiBytes = SharedAudioTransport::writeMidi(midiMessages, transport->getMidiData(sequence),
+                                                        SharedAudioTransport::maxMidiBytes);
+    slot.requestSequence.store(sequence, std::memory_order_release);
+    header.requestSequence.store(sequence, std::memory_order_release);
+    
+    if (header.workerReady.load(std::memory_order_acquire) != 0)
+    {
+        transport->postRequest();
+    }
+    
+    midiMessages.clear();
+    
+    if (pendingSequence != 0)
+    {
+        collectPendingBlock(midiMessages);
+    }
+    
+    pendingSequence = sequence;
+    pendingNumSamples = numSamples;
+    pendingNumChannels = numChannels;
+    
+    popFromFifo(buffer, numSamples);
+}
+
+void OutOfProcessHost::collectPendingBlock(juce::MidiBuffer& midiMessages)
+{
+    auto& slot = transport->getSlot(pendingSequence);
+    const float* channels[SharedAudioTransport::maxChannels] = {};
+    
+    if (slot.completedSequence.load(std::memory_order_acquire) == pendingSequence)
+    {
+        lastCompletedSequence.store(pendingSequence);
+        
+        for (int ch = 0; ch < pendingNumChannels; ++ch)
+        {
+            channels[ch] = transport->getChannel(pendingSequence, ch);
+        }
+        
+        pushToFifo(channels, pendingNumChannels, pendingNumSamples);
+        SharedAudioTransport::readMidi(transport->getMidiData(pendingSequence), slot.numMidiBytes,
+                                       midiMessages, pendingNumSamples);
+        return;
+    }
+    
+    // 작업자가 죽었거나 늦음: 같은 지연으로 원음 또는 무음을 내보냄
+    ++numFallbackBlocks;
+    
+    if (fallback.load() == Fallback::dry)
+    {
+        const auto& dryBuffer = dryBuffers[pendingSequence & 1];
+        for (int ch = 0; ch < pendingNumChannels; ++ch)
+        {
+            channels[ch] = dryBuffer.getReadPointer(ch);
+        }
+        pushToFifo(channels, pendingNumChannels, pendingNumSamples);
+    }
+    else
+    {
+        pushToFifo(nullptr, 0, pendingNumSamples);
+    }
+}
+
+void OutOfProcessHost::pushToFifo(const float* const* channels, int numChannels, int numSamples)
+{
+    const auto fifoSize = outputFifo.getNumSamples();
+    const auto writePosition = (fifoReadPosition + fifoNumReady) % fifoSize;
+    numSamples = juce::jmin(numSamples, fifoSize - fifoNumReady);
+    
+    const auto firstPart = juce::jmin(numSamples, fifoSize - writePosition);
+    const auto secondPart = numSamples - firstPart;
+    
+    for (int ch = 0; ch < juce::jmax(numChannels, fifoNumChannels); ++ch)
+    {
+        if (channels != nullptr && ch < numChannels)
+        {
+            outputFifo.copyFrom(ch, writePosition, channels[ch], firstPart);
+            outputFifo.copyFrom(ch, 0, channels[ch] + firstPart, secondPart);
+        }
+        else
+        {
+            outputFifo.clear(ch, writePosition, firstPart);
+            outputFifo.clear(ch, 0, secondPart);
+        }
+    }
+    
+    fifoNumChannels = juce::jmax(numChannels, fifoNumChannels);
+    fifoNumReady += numSamples;
+}
+
+void OutOfProcessHost::popFromFifo(juce::AudioBuffer<float>& destination, int numSamples)
+{
+    const auto fifoSize = outputFifo.getNumSamples();
+    const auto available = juce::jmin(numSamples, fifoNumReady);
+    const auto firstPart = juce::jmin(available, fifoSize - fifoReadPosition);
+    const auto secondPart = available - firstPart;
+    
+    for (int ch = 0; ch < destination.getNumChannels(); ++ch)
+    {
+        if (ch >= fifoNumChannels)
+        {
+            destination.clear(ch, 0, numSamples);
+            continue;
+        }
+        
+        destination.copyFrom(ch, 0, outputFifo, ch, fifoReadPosition, firstPart);
+        destination.copyFrom(ch, firstPart, outputFifo, ch, 0, secondPart);
+        
+        if (available < numSamples)
+        {
+            destination.clear(ch, available, numSamples - available);
+        }
+    }
+    
+    fifoReadPosition = (fifoReadPosition + available) % fifoSize;
+    fifoNumReady -= available;
+}
+
+bool OutOfProcessHost::launchWorker()
+{
+    const auto helper = getHelperExecutable();
+    if (!helper.existsAsFile())
+    {
+        lastError = "Out-of-process host not found";
+        return false;
+    }
+    
+    auto& header = transport->getHeader();
+    header.shouldQuit.store(0);
+    header.workerReady.store(0);
+    wasWorkerReady = false;
+    numStalledChecks = 0;
+    
+    if (!writeLaunchData())
+    {
+        lastError = "Plugin state is too large for the out-of-process host";
+        return false;
+    }
+    
+    const juce::StringArray args { helper.getFullPathName(),
+                                   "--oop-worker",
+                                   "--shm", transport->getName(),
+                                   "--rate", juce::String(preparedSampleRate),
+                                   "--block", juce::String(preparedBlockSize) };
+    
+    childProcess = std::make_unique<juce::ChildProcess>();
+    if (!childProcess->start(args, 0))
+    {
+        childProcess.reset();
+        lastError = "Cannot start out-of-process host";
+        return false;
+    }
+    
+    return true;
+}
+
+void OutOfProcessHost::stopWorker(bool isGraceful)
+{
+    if (transport != nullptr)
+    {
+        auto& header = transport->getHeader();
+        header.workerReady.store(0);
+        header.shouldQuit.store(1);
+        transport->postRequest();
+    }
+    
+    if (childProcess == nullptr) { return; }
+    
+    // 정상 종료는 백그라운드에서 기다리고, 죽었거나 멈춘 작업자는 기다릴 이유가 없으므로 바로 끝냄
+    if (isGraceful)
+    {
+        processReaper->add(std::move(childProcess));
+    }
+    else
+    {
+        childProcess->kill();
+        childProcess.reset();
+    }
+}
+
+void OutOfProcessHost::timerCallback()
+{
+    const juce::ScopedLock workerSl(workerLock);
+    if (transport == nullptr) { return; }
+    
+    const auto ready = isWorkerReady();
+    const auto requested = transport->getHeader().requestSequence.load();
+    const auto completed = lastCompletedSequence.load();
+    const auto isRunning = childProcess != nullptr && childProcess->isRunning();
+    
+    // 요청은 계속 들어오는데 완료가 멈춰 있으면 작업자가 멈춘 것으로 판단
+    if (ready && requested != lastCheckedRequest && completed == lastCheckedCompletion)
+        ++numStalledChecks;
+    else
+        numStalledChecks = 0;
+    
+    lastCheckedRequest = requested;
+    lastCheckedCompletion = completed;
+    
+    if (!isRunning || numStalledChecks >= maxStalledChecks)
+    {
+        // 같은 공유 메모리로 다시 띄우므로 이전 작업자는 새 작업자가 뜨기 전에 확실히 끝냄
+        stopWorker(false);
+        
+        if (++numFailedLaunches > maxFailedLaunches)
+        {
+            lastError = "Out-of-process host keeps crashing";
+            stopTimer();
+            return;
+        }
+        
+        ++numRestarts;
+        launchWorker();
+        return;
+    }
+    
+    if (ready && !wasWorkerReady)
+    {
+        numFailedLaunches = 0;
+        if (onWorkerReady != nullptr) { onWorkerReady(); }
+    }
+    
+    wasWorkerReady = ready;
+}
+
+bool OutOfProcessHost::getState(juce::MemoryBlock& destData)
+{
+    const juce::ScopedLock sl(stateLock);
+    
+    // 작업자가 메시지 스레드에서 상태를 공유 메모리에 써줄 때까지 세마포어로 기다림
+    // 응답이 없거나 상태가 너무 크면 마지막으로 받은 상태를 돌려줌 (재시작할 때도 이 상태로 띄움)
+    juce::MemoryBlock state;
+    if (isWorkerReady() && transport->requestState(state, stateTimeoutMs))
+    {
+        lastKnownState = std::move(state);
+    }
+    
+    destData = lastKnownState;
+    return true;
+}
+
+bool OutOfProcessHost::writeLaunchData()
+{
+    const juce::ScopedLock sl(stateLock);
+    
+    juce::XmlElement xml("worker");
+    xml.addChildElement(pluginDescription.createXml().release());
+    xml.createNewChildElement("inner_state")->addTextElement(lastKnownState.toBase64Encoding());
+    
+    const auto text = xml.toString();
+    return transport->writeState(text.toRawUTF8(), text.getNumBytesAsUTF8());
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SharedAudioTransport.h"
+
+// 호스팅 플러그인을 자식 프로세스(VST3LoaderHost)에서 실행하는 래퍼 쪽 프록시
+// 오디오 스레드는 블록을 공유 메모리에 쓰고 이전 블록의 결과만 가져가므로 절대 기다리지 않음
+// (그 대가로 최대 블록 크기만큼의 지연이 추가됨)
+class OutOfProcessHost : private juce::Timer
+{
+public:
+    enum class Fallback
+    {
+        silence,
+        dry
+    };
+    
+    OutOfProcessHost(const juce::PluginDescription& description, const juce::MemoryBlock& innerState);
+    ~OutOfProcessHost() override;
+    
+    bool prepare(double sampleRate, int maxBlockSize);
+    void reset();
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool isActive);
+    
+    int getLatencySamples() const;
+    bool getState(juce::MemoryBlock& destData);
+    bool isWorkerReady() const;
+    juce::String getLastError() const { return lastError; }
+    
+    int getNumRestarts() const { return numRestarts.load(); }
+    juce::int64 getNumFallbackBlocks() const { return numFallbackBlocks.load(); }
+    void setFallback(Fallback newFallback) { fallback.store(newFallback); }
+    
+    // 작업자가 (재)시작되어 플러그인 지연을 알게 되었을 때 메시지 스레드에서 호출됨
+    std::function<void()> onWorkerReady;
+    
+    static juce::File getHelperExecutable();
+    
+private:
+    // 끝내라고 알린 작업자 프로세스가 스스로 끝날 때까지 백그라운드에서 기다리고, 시간 안에 안 끝나면 강제로 끝냄 (프로세스 공용)
+    class ProcessReaper;
+    
+    juce::PluginDescription pluginDescription;
+    juce::CriticalSection stateLock; // transport 교체와 상태 요청/실행 정보 쓰기를 묶음
+    juce::CriticalSection workerLock; // prepare (오디오 설정 스레드) 와 감시 타이머 (메시지 스레드) 의 작업자 재시작을 묶음
+    juce::SharedResourcePointer<ProcessReaper> processReaper;
+    juce::MemoryBlock lastKnownState;
+    std::unique_ptr<SharedAudioTransport> transport;
+    std::unique_ptr<juce::ChildProcess> childProcess;
+    juce::String lastError;
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+    
+    // 오디오 스레드 전용
+    juce::uint64 lastRequestSequence = 0;
+    juce::uint64 pendingSequence = 0;
+    int pendingNumSamples = 0;
+    int pendingNumChannels = 0;
+    juce::AudioBuffer<float> outputFifo;
+    int fifoReadPosition = 0;
+    int fifoNumReady = 0;
+    int fifoNumChannels = 0;
+    juce::AudioBuffer<float> dryBuffers[2];
+    
+    std::atomic<Fallback> fallback { Fallback::dry };
+    std::atomic<int> numRestarts { 0 };
+    std::atomic<juce::int64> numFallbackBlocks { 0 };
+    std::atomic<juce::uint64> lastCompletedSequence { 0 };
+    
+    // 메시지 스레드 감시용
+    bool wasWorkerReady = false;
+    juce::uint64 lastCheckedRequest = 0;
+    juce::uint64 lastCheckedCompletion = 0;
+    int numStalledChecks = 0;
+    int numFailedLaunches = 0;
+    
+    static constexpr int watchdogIntervalMs = 500;
+    static constexpr int maxStalledChecks = 4;
+    static constexpr int maxFailedLaunches = 10;
+    static constexpr int stateTimeoutMs = 2000;
+    static constexpr int quitTimeoutMs = 1000;
+    
+    bool launchWorker();
+    void stopWorker(bool isGraceful);
+    bool writeLaunchData();
+    void collectPendingBlock(juce::MidiBuffer& midiMessages);
+    void pushToFifo(const float* const* channels, int numChannels, int numSamples);
+    void popFromFifo(juce::AudioBuffer<float>& destination, int numSamples);
+    void timerCallback() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessHost)
+};
@@ -0,0 +1,39 @@
+#include "OutputSanitizer.h"
+
+std::vector<OutputSanitizer::ScanCostResult> OutputSanitizer::measureScanCost(const std::vector<int>& blockSizes,
+                                                                            int numChannels,
+                                                                            int numIterations)
+{
+    std::vector<ScanCostResult> results;
+    const auto maxBlockSize = blockSizes.empty() ? 0 : *std::max_element(blockSizes.begin(), blockSizes.end());
+    
+    juce::AudioBuffer<float> buffer(numChannels, maxBlockSize);
+    juce::Random random;
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int i = 0; i < maxBlockSize; ++i)
+        {
+            buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+    
+    OutputSanitizer sanitizer;
+    
+    for (const auto blockSize : blockSizes)
+    {
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, blockSize);
+        const auto start = juce::Time::getHighResolutionTicks();
+        
+        for (int i = 0; i < numIterations; ++i)
+        {
+            sanitizer.process(block, numChannels);
+        }
+        
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+        const auto numChannelSamples = (double) numIterations * numChannels * juce::jmax(1, blockSize);
+        results.push_back({ blockSize, elapsed / numChannelSamples });
+    }
+    
+    return results;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인 출력의 NaN/Inf 를 한 번의 스캔으로 찾아서 0 으로 바꿈
+// 문제 블록이 연속으로 이어지면 메시지 스레드에서 플러그인을 리셋하도록 알림
+class OutputSanitizer : private juce::AsyncUpdater
+{
+public:
+    OutputSanitizer() = default;
+    ~OutputSanitizer() override { cancelPendingUpdate(); }
+    
+    // 메시지 스레드에서 불림
+    std::function<void()> onRepeatedFaults;
+    
+    void setResetOnRepeatedFaults(bool shouldReset) { resetOnRepeatedFaults.store(shouldReset); }
+    bool isResetOnRepeatedFaults() const { return resetOnRepeatedFaults.load(); }
+    juce::int64 getNumIncidents() const { return numIncidents.load(); }
+    
+    // 오디오 스레드에서 호출
+    template<typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    
+    template<typename SampleType>
+    static bool containsNonFinite(const SampleType* data, int numSamples);
+    
+    struct ScanCostResult
+    {
+        int blockSize;
+        double nanosecondsPerChannelSample;
+    };
+    
+    static std::vector<ScanCostResult> measureScanCost(const std::vector<int>& blockSizes,
+                                                       int numChannels = 2,
+                                                       int numIterations = 20000);
+    
+private:
+    std::atomic<bool> resetOnRepeatedFaults { false };
+    std::atomic<juce::int64> numIncidents { 0 };
+    int consecutiveFaultyBlocks = 0; // 정상 블록이 하나라도 나오면 0 으로 돌아감
+    
+    static constexpr int faultyBlocksBeforeReset = 8;
+    
+    // 지수 비트가 전부 1 이면 NaN 또는 Inf. 정수 연산만 쓰므로 fast-math 에서도 동작함
+    template<typename SampleType>
+    static bool isNonFinite(SampleType sample)
+    {
+        using Bits = std::conditional_t<sizeof(SampleType) == 4, juce::uint32, juce::uint64>;
+        constexpr Bits exponentMask = sizeof(SampleType) == 4 ? (Bits) 0x7f800000u : (Bits) 0x7ff0000000000000ull;
+        
+        Bits bits;
+        std::memcpy(&bits, &sample, sizeof(Bits));
+        return (bits & exponentMask) == exponentMask;
+    }
+    
+    void handleAsyncUpdate() override
+    {
+        if (onRepeatedFaults != nullptr) { onRepeatedFaults(); }
+    }
+};
+
+template<typename SampleType>
+bool OutputSanitizer::containsNonFinite(const SampleType* data, int numSamples)
+{
+    // 분기 없이 OR 로만 모으므로 컴파일러가 한 번의 벡터 루프로 만듦
+    auto found = 0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        found |= isNonFinite(data[i]) ? 1 : 0;
+    }
+    
+    return found != 0;
+}
+
+template<typename SampleType>
+void OutputSanitizer::process(juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    const auto numSamples = buffer.getNumSamples();
+    auto isFaulty = false;
+    
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch)
+    {
+        auto* data = buffer.getWritePointer(ch);
+        if (!containsNonFinite(data, numSamples)) { continue; }
+        
+        isFaulty = true;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (isNonFinite(data[i])) { data[i] = 0; }
+        }
+    }
+    
+    if (!isFaulty)
+    {
+        consecutiveFaultyBlocks = 0;
+        return;
+    }
+    
+    numIncidents.fetch_add(1, std::memory_order_relaxed);
+    
+    if (++consecutiveFaultyBlocks >= faultyBlocksBeforeReset)
+    {
+        consecutiveFaultyBlocks = 0;
+        if (resetOnRepeatedFaults.load(std::memory_order_relaxed)) { triggerAsyncUpdate(); }
+    }
+}
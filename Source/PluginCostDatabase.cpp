@@ -0,0 +1,333 @@
+#include "PluginCostDatabase.h"
+
+double PluginCostDatabase::Entry::getAverageLoad() const
+{
+    double processMilliseconds = 0.0;
+    double audioMilliseconds = 0.0;
+    
+    for (const auto& cost : blockCosts)
+    {
+        processMilliseconds += cost.processMilliseconds;
+        audioMilliseconds += cost.audioMilliseconds;
+    }
+    
+    return audioMilliseconds > 0.0 ? processMilliseconds / audioMilliseconds : 0.0;
+}
+
+double PluginCostDatabase::Entry::getWorstLoad() const
+{
+    double worstLoad = 0.0;
+    for (const auto& cost : blockCosts)
+    {
+        worstLoad = juce::jmax(worstLoad, cost.worstLoad);
+    }
+    
+    return worstLoad;
+}
+
+juce::String PluginCostDatabase::Entry::getDetails() const
+{
+    juce::StringArray lines;
+    
+    if (hasLoadCost())
+    {
+        lines.add("Load " + juce::String(juce::roundToInt(loadMilliseconds)) + " ms, "
+                  + juce::String((double) residentBytes / (1024.0 * 1024.0), 1) + " MB (" + juce::String(numLoads) + " loads)");
+    }
+    
+    for (const auto& cost : blockCosts)
+    {
+        lines.add(juce::String(cost.blockSize) + " samples: avg " + juce::String(cost.getAverageMilliseconds(), 3)
+                  + " ms, worst " + juce::String(cost.worstMilliseconds, 3) + " ms ("
+                  + juce::String(cost.worstLoad * 100.0, 1) + "% of block)");
+    }
+    
+    return lines.joinIntoString("\n");
+}
+
+PluginCostDatabase::PluginCostDatabase()
+{
+    entries = readEntries(getDatabaseFile());
+}
+
+PluginCostDatabase::~PluginCostDatabase()
+{
+    stopTimer();
+    save();
+}
+
+void PluginCostDatabase::recordLoad(const juce::String& pluginPath, const juce::String& pluginName,
+                                    double loadMilliseconds, juce::int64 residentBytes)
+{
+    if (pluginPath.isEmpty()) { return; }
+    
+    Entry entry;
+    entry.pluginPath = pluginPath;
+    entry.pluginName = pluginName;
+    entry.numLoads = 1;
+    entry.loadMilliseconds = loadMilliseconds;
+    entry.residentBytes = residentBytes;
+    add(entry);
+}
+
+void PluginCostDatabase::recordBlocks(const juce::String& pluginPath, const BlockCost& cost)
+{
+    if (pluginPath.isEmpty() || cost.numBlocks <= 0) { return; }
+    
+    Entry entry;
+    entry.pluginPath = pluginPath;
+    entry.blockCosts.push_back(cost);
+    add(entry);
+}
+
+void PluginCostDatabase::add(const Entry& added)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        mergeEntry(entries[added.pluginPath], added);
+        mergeEntry(pendingEntries[added.pluginPath], added);
+    }
+    
+    markDirty();
+}
+
+void PluginCostDatabase::mergeEntry(Entry& entry, const Entry& added)
+{
+    entry.pluginPath = added.pluginPath;
+    if (added.pluginName.isNotEmpty()) { entry.pluginName = added.pluginName; }
+    
+    // 로드 시간과 메모리는 디스크 캐시나 공유 라이브러리 상태에 따라 흔들리므로 로드 횟수로 가중한 평균을 씀
+    if (added.numLoads > 0)
+    {
+        const auto n = (double) entry.numLoads;
+        const auto m = (double) added.numLoads;
+        entry.loadMilliseconds = (entry.loadMilliseconds * n + added.loadMilliseconds * m) / (n + m);
+        entry.residentBytes = (juce::int64) (((double) entry.residentBytes * n + (double) added.residentBytes * m) / (n + m));
+        entry.numLoads += added.numLoads;
+    }
+    
+    for (const auto& cost : added.blockCosts)
+    {
+        auto it = std::find_if(entry.blockCosts.begin(), entry.blockCosts.end(),
+                               [&](const BlockCost& c) { return c.blockSize == cost.blockSize; });
+        
+        if (it == entry.blockCosts.end())
+        {
+            entry.blockCosts.push_back(cost);
+            std::sort(entry.blockCosts.begin(), entry.blockCosts.end(),
+                      [](const BlockCost& a, const BlockCost& b) { return a.blockSize < b.blockSize; });
+        }
+        else
+        {
+            it->numBlocks += cost.numBlocks;
+            it->processMilliseconds += cost.processMilliseconds;
+            it->audioMilliseconds += cost.audioMilliseconds;
+            it->worstMilliseconds = juce::jmax(it->worstMilliseconds, cost.worstMilliseconds);
+            it->worstLoad = juce::jmax(it->worstLoad, cost.worstLoad);
+        }
+    }
+}
+
+bool PluginCostDatabase::getEntry(const juce::String& pluginPath, Entry& result) const
+{
+    const juce::ScopedLock sl(lock);
+    
+    const auto it = entries.find(pluginPath);
+    if (it == entries.end()) { return false; }
+    
+    result = it->second;
+    return true;
+}
+
+std::map<juce::String, PluginCostDatabase::Entry> PluginCostDatabase::getEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    return entries;
+}
+
+juce::File PluginCostDatabase::getDatabaseFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("Application Support/VST3 Loader/PluginCosts.xml");
+}
+
+std::map<juce::String, PluginCostDatabase::Entry> PluginCostDatabase::readEntries(const juce::File& file)
+{
+    std::map<juce::String, Entry> result;
+    
+    const auto xml = juce::XmlDocument::parse(file);
+    if (xml == nullptr || !xml->hasTagName("plugin_costs")) { return result; }
+    
+    for (auto* pluginXml : xml->getChildWithTagNameIterator("plugin"))
+    {
+        Entry entry;
+        entry.pluginPath = pluginXml->getStringAttribute("path");
+        entry.pluginName = pluginXml->getStringAttribute("name");
+        entry.numLoads = pluginXml->getIntAttribute("loads");
+        entry.loadMilliseconds = pluginXml->getDoubleAttribute("load_ms");
+        entry.residentBytes = pluginXml->getStringAttribute("resident_bytes").getLargeIntValue();
+        
+        for (auto* blockXml : pluginXml->getChildWithTagNameIterator("block"))
+        {
+            BlockCost cost;
+            cost.blockSize = blockXml->getIntAttribute("size");
+            cost.numBlocks = blockXml->getStringAttribute("blocks").getLargeIntValue();
+            cost.processMilliseconds = blockXml->getDoubleAttribute("process_ms");
+            cost.audioMilliseconds = blockXml->getDoubleAttribute("audio_ms");
+            cost.worstMilliseconds = blockXml->getDoubleAttribute("worst_ms");
+            cost.worstLoad = blockXml->getDoubleAttribute("worst_load");
+            
+            if (cost.blockSize > 0 && cost.numBlocks > 0) { entry.blockCosts.push_back(cost); }
+        }
+        
+        if (entry.pluginPath.isNotEmpty()) { result[entry.pluginPath] = std::move(entry); }
+    }
+    
+    return result;
+}
+
+void PluginCostDatabase::save()
+{
+    std::map<juce::String, Entry> added;
+    
+    {
+        const juce::ScopedLock sl(lock);
+        if (pendingEntries.empty()) { return; }
+        added.swap(pendingEntries);
+    }
+    
+    // 다른 호스트 프로세스가 그 사이에 저장한 값을 덮어쓰지 않도록 디스크의 파일을 다시 읽어 이번 변경분만 더함
+    const juce::InterProcessLock::ScopedLockType processLock(fileLock);
+    const auto file = getDatabaseFile();
+    auto merged = readEntries(file);
+    
+    for (const auto& [path, entry] : added)
+    {
+        mergeEntry(merged[path], entry);
+    }
+    
+    juce::XmlElement xml("plugin_costs");
+    
+    for (const auto& [path, entry] : merged)
+    {
+        auto* pluginXml = xml.createNewChildElement("plugin");
+        pluginXml->setAttribute("path", entry.pluginPath);
+        pluginXml->setAttribute("name", entry.pluginName);
+        pluginXml->setAttribute("loads", entry.numLoads);
+        pluginXml->setAttribute("load_ms", entry.loadMilliseconds);
+        pluginXml->setAttribute("resident_bytes", juce::String(entry.residentBytes));
+        
+        for (const auto& cost : entry.blockCosts)
+        {
+            auto* blockXml = pluginXml->createNewChildElement("block");
+            blockXml->setAttribute("size", cost.blockSize);
+            blockXml->setAttribute("blocks", juce::String(cost.numBlocks));
+            blockXml->setAttribute("process_ms", cost.processMilliseconds);
+            blockXml->setAttribute("audio_ms", cost.audioMilliseconds);
+            blockXml->setAttribute("worst_ms", cost.worstMilliseconds);
+            blockXml->setAttribute("worst_load", cost.worstLoad);
+        }
+    }
+    
+    // writeTo 는 임시 파일에 쓴 뒤 바꿔치므로 다른 호스트 프로세스가 반쯤 쓴 파일을 읽지 않음
+    file.getParentDirectory().createDirectory();
+    xml.writeTo(file);
+    
+    // 다른 프로세스가 더한 값도 브라우저에 보이도록 합친 결과에 그 사이 새로 더한 값을 얹어 바꿈
+    const juce::ScopedLock sl(lock);
+    entries = std::move(merged);
+    
+    for (const auto& [path, entry] : pendingEntries)
+    {
+        mergeEntry(entries[path], entry);
+    }
+}
+
+void PluginCostDatabase::markDirty()
+{
+    // 블록 측정이 몰려 들어와도 파일은 한 번만 씀
+    if (!isTimerRunning()) { startTimer(saveDelayMs); }
+}
+
+void PluginCostDatabase::timerCallback()
+{
+    stopTimer();
+    save();
+}
+
+PluginCostDatabase::Meter::~Meter()
+{
+    stopTimer();
+    flush();
+}
+
+void PluginCostDatabase::Meter::setPlugin(const juce::String& newPluginPath)
+{
+    flush();
+    measuring.store(false);
+    
+    // 오디오 스레드가 이전 플러그인으로 더한 값이 새 플러그인에 섞이지 않게 버림
+    for (auto& bucket : buckets)
+    {
+        bucket.numBlocks.store(0);
+        bucket.processMicroseconds.store(0);
+        bucket.audioMicroseconds.store(0);
+        bucket.worstMicroseconds.store(0);
+        bucket.worstLoadPermille.store(0);
+    }
+    
+    pluginPath = newPluginPath;
+    
+    if (pluginPath.isEmpty())
+    {
+        stopTimer();
+        return;
+    }
+    
+    measuring.store(true);
+    startTimer(flushIntervalMs);
+}
+
+void PluginCostDatabase::Meter::addBlock(int numSamples, double sampleRate, double milliseconds)
+{
+    if (numSamples <= 0 || sampleRate <= 0.0) { return; }
+    
+    const auto order = juce::jlimit(0, numBuckets - 1, juce::roundToInt(std::ceil(std::log2((double) numSamples))) - minBlockSizeOrder);
+    auto& bucket = buckets[(size_t) order];
+    
+    const auto processMicroseconds = (juce::int64) (milliseconds * 1000.0);
+    const auto audioMilliseconds = numSamples * 1000.0 / sampleRate;
+    const auto loadPermille = juce::roundToInt(milliseconds / audioMilliseconds * 1000.0);
+    
+    bucket.numBlocks.fetch_add(1, std::memory_order_relaxed);
+    bucket.processMicroseconds.fetch_add(processMicroseconds, std::memory_order_relaxed);
+    bucket.audioMicroseconds.fetch_add((juce::int64) (audioMilliseconds * 1000.0), std::memory_order_relaxed);
+    
+    auto worst = bucket.worstMicroseconds.load(std::memory_order_relaxed);
+    while (processMicroseconds > worst
+           && !bucket.worstMicroseconds.compare_exchange_weak(worst, processMicroseconds, std::memory_order_relaxed)) {}
+    
+    auto worstLoad = bucket.worstLoadPermille.load(std::memory_order_relaxed);
+    while (loadPermille > worstLoad
+           && !bucket.worstLoadPermille.compare_exchange_weak(worstLoad, loadPermille, std::memory_order_relaxed)) {}
+}
+
+void PluginCostDatabase::Meter::flush()
+{
+    if (pluginPath.isEmpty()) { return; }
+    
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        auto& bucket = buckets[(size_t) i];
+        
+        BlockCost cost;
+        cost.blockSize = 1 << (i + minBlockSizeOrder);
+        cost.numBlocks = bucket.numBlocks.exchange(0);
+        cost.processMilliseconds = (double) bucket.processMicroseconds.exchange(0) / 1000.0;
+        cost.audioMilliseconds = (double) bucket.audioMicroseconds.exchange(0) / 1000.0;
+        cost.worstMilliseconds = (double) bucket.worstMicroseconds.exchange(0) / 1000.0;
+        cost.worstLoad = (double) bucket.worstLoadPermille.exchange(0) / 1000.0;
+        
+        database->recordBlocks(pluginPath, cost);
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 플러그인별 로드 시간, 로드 후 상주 메모리 증가량, 블록 크기별 평균/최악 처리 시간을 모아두는 로컬 데이터베이스 (모든 래퍼 인스턴스가 공유)
+// ~/Library/Application Support/VST3 Loader/PluginCosts.xml 에 저장하고, 브라우저가 로드하기 전에 보여줌
+class PluginCostDatabase : private juce::Timer
+{
+public:
+    struct BlockCost
+    {
+        int blockSize = 0; // 2의 거듭제곱으로 올림
+        juce::int64 numBlocks = 0;
+        double processMilliseconds = 0.0;
+        double audioMilliseconds = 0.0;
+        double worstMilliseconds = 0.0;
+        double worstLoad = 0.0; // 블록 길이 대비 처리 시간
+        
+        double getAverageMilliseconds() const { return numBlocks > 0 ? processMilliseconds / (double) numBlocks : 0.0; }
+    };
+    
+    struct Entry
+    {
+        juce::String pluginPath;
+        juce::String pluginName;
+        int numLoads = 0;
+        double loadMilliseconds = 0.0; // 로드마다의 평균
+        juce::int64 residentBytes = 0;
+        std::vector<BlockCost> blockCosts;
+        
+        bool hasLoadCost() const { return numLoads > 0; }
+        bool hasCpuCost() const { return !blockCosts.empty(); }
+        
+        // 모든 블록 크기에서 처리 시간 / 오디오 길이, 최악 블록의 처리 시간 / 블록 길이
+        double getAverageLoad() const;
+        double getWorstLoad() const;
+        juce::String getDetails() const;
+    };
+    
+    PluginCostDatabase();
+    ~PluginCostDatabase() override;
+    
+    void recordLoad(const juce::String& pluginPath, const juce::String& pluginName,
+                    double loadMilliseconds, juce::int64 residentBytes);
+    void recordBlocks(const juce::String& pluginPath, const BlockCost& cost);
+    
+    bool getEntry(const juce::String& pluginPath, Entry& result) const;
+    std::map<juce::String, Entry> getEntries() const;
+    
+    static juce::File getDatabaseFile();
+    
+    // 오디오 스레드에서 호스팅 플러그인의 블록 시간을 모으고, 메시지 스레드에서 주기적으로 데이터베이스에 넘김
+    class Meter;
+    
+private:
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries;
+    std::map<juce::String, Entry> pendingEntries; // 마지막 저장 뒤에 이 프로세스에서 더한 값
+    juce::InterProcessLock fileLock { "VST3LoaderPluginCosts" };
+    
+    static constexpr int saveDelayMs = 2000;
+    
+    static std::map<juce::String, Entry> readEntries(const juce::File& file);
+    static void mergeEntry(Entry& entry, const Entry& added);
+    void add(const Entry& added);
+    void save();
+    void markDirty();
+    void timerCallback() override;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginCostDatabase)
+};
+
+class PluginCostDatabase::Meter : private juce::Timer
+{
+public:
+    Meter() = default;
+    ~Meter() override;
+    
+    // 메시지 스레드에서 호출: 이전 플러그인의 측정을 넘기고 새 플러그인으로 바꿈 (빈 문자열이면 측정하지 않음)
+    void setPlugin(const juce::String& pluginPath);
+    void flush();
+    
+    // 오디오 스레드에서 호출
+    bool isMeasuring() const { return measuring.load(std::memory_order_relaxed); }
+    void addBlock(int numSamples, double sampleRate, double milliseconds);
+    
+private:
+    struct Bucket
+    {
+        std::atomic<juce::int64> numBlocks { 0 };
+        std::atomic<juce::int64> processMicroseconds { 0 };
+        std::atomic<juce::int64> audioMicroseconds { 0 };
+        std::atomic<juce::int64> worstMicroseconds { 0 };
+        std::atomic<int> worstLoadPermille { 0 };
+    };
+    
+    static constexpr int minBlockSizeOrder = 5; // 32
+    static constexpr int numBuckets = 8;        // 32 ~ 4096
+    static constexpr int flushIntervalMs = 10000;
+    
+    juce::SharedResourcePointer<PluginCostDatabase> database;
+    juce::String pluginPath;
+    std::atomic<bool> measuring { false };
+    std::array<Bucket, numBuckets> buckets;
+    
+    void timerCallback() override { flush(); }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Meter)
+};
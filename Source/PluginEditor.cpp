@@ -4,15 +4,9 @@
 VST3LoaderAudioProcessorEditor::VST3LoaderAudioProcessorEditor (VST3LoaderAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
-    pluginListBox = std::make_unique<VST3ListBox>();
-    pluginListBox->onPluginSelected = [this](const juce::String& path)
-    {
-        loadPlugin(path);
-    };
-    
     audioProcessor.addChangeListener(this);
-    addAndMakeVisible(pluginListBox.get());
     
+    // 플러그인 목록은 디스크를 읽으므로 필요할 때만 만듦 (processorStateChanged)
     addAndMakeVisible(pluginListBoxCover);
     
     // 버튼 스타일링
@@ -28,24 +22,61 @@ VST3LoaderAudioProcessorEditor::VST3LoaderAudioProcessorEditor (VST3LoaderAudioP
     closePluginButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xffFFDFB9));
     closePluginButton.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
     
+    batchRenderButton.setButtonText("Batch Render...");
+    batchRenderButton.addListener(this);
+    batchRenderButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xffA4193D));
+    batchRenderButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xffFFDFB9));
+    batchRenderButton.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    
+    optionsButton.setButtonText("Options");
+    optionsButton.addListener(this);
+    optionsButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2a2a2a));
+    optionsButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xffFFDFB9));
+    optionsButton.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    
+    openEditorButton.setButtonText("Open Editor");
+    openEditorButton.addListener(this);
+    openEditorButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xffA4193D));
+    openEditorButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xffFFDFB9));
+    openEditorButton.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    
     statusLabel.setJustificationType(juce::Justification::centred);
     statusLabel.setColour(juce::Label::textColourId, juce::Colour(0xffFFDFB9));
     statusLabel.setColour(juce::Label::backgroundColourId, juce::Colour(0xff1a1a1a));
     
     addAndMakeVisible(loadPluginButton);
     addAndMakeVisible(closePluginButton);
+    addAndMakeVisible(batchRenderButton);
+    addAndMakeVisible(optionsButton);
     addAndMakeVisible(statusLabel);
+    addChildComponent(openEditorButton);
     
     setHostedPluginEditorIfNeeded();
     processorStateChanged(false);
     
-    startTimer(500);
+    startTimer(timerIntervalMs);
 }
 
 VST3LoaderAudioProcessorEditor::~VST3LoaderAudioProcessorEditor()
 {
     audioProcessor.removeChangeListener(this);
+    audioProcessor.setEditorShowing(false);
     stopTimer();
+    releaseHostedPluginEditor();
+}
+
+void VST3LoaderAudioProcessorEditor::createPluginListBoxIfNeeded()
+{
+    if (pluginListBox != nullptr) { return; }
+    
+    pluginListBox = std::make_unique<VST3ListBox>();
+    pluginListBox->onPluginSelected = [this](const juce::String& path)
+    {
+        loadPlugin(path);
+    };
+    
+    addAndMakeVisible(pluginListBox.get(), 0);
+    pluginListBox->setBounds(0, 0, getEditorWidth(), browserHeight);
 }
 
 void VST3LoaderAudioProcessorEditor::loadPlugin(const juce::String& filePath)
@@ -67,6 +98,239 @@ void VST3LoaderAudioProcessorEditor::closePlugin()
     processorStateChanged(false);
 }
 
+void VST3LoaderAudioProcessorEditor::reloadPlugin()
+{
+    releaseHostedPluginEditor();
+    setLoadingState();
+    
+    threadPool.addJob([this]()
+    {
+        audioProcessor.reloadHostedPlugin();
+    });
+}
+
+void VST3LoaderAudioProcessorEditor::showOptionsMenu()
+{
+    juce::PopupMenu menu;
+    const auto isLoaded = audioProcessor.isHostedPluginLoaded();
+    
+    // 실행 방식이 바뀌는 옵션은 로드된 플러그인을 현재 상태로 다시 불러옴
+    menu.addItem("Run plugin out of process", true, audioProcessor.isOutOfProcessMode(), [this, isLoaded]()
+    {
+        audioProcessor.setOutOfProcessMode(!audioProcessor.isOutOfProcessMode());
+        if (isLoaded) { reloadPlugin(); }
+    });
+    
+    menu.addItem("Multi-mono (one instance per channel)", true, audioProcessor.isMultiMonoMode(), [this, isLoaded]()
+    {
+        audioProcessor.setMultiMonoMode(!audioProcessor.isMultiMonoMode());
+        if (isLoaded) { reloadPlugin(); }
+    });
+    
+    menu.addItem("Link multi-mono parameters", audioProcessor.isMultiMonoMode(),
+                 audioProcessor.areMultiMonoParametersLinked(), [this]()
+    {
+        audioProcessor.setMultiMonoParametersLinked(!audioProcessor.areMultiMonoParametersLinked());
+    });
+    
+    menu.addItem("Reduced internal rate at 88.2 kHz and above",
+                 !audioProcessor.isMultiMonoMode() && !audioProcessor.isOutOfProcessMode(),
+                 audioProcessor.isReducedRateMode(), [this, isLoaded]()
+    {
+        audioProcessor.setReducedRateMode(!audioProcessor.isReducedRateMode());
+        if (isLoaded) { reloadPlugin(); }
+    });
+    
+    const auto numSkippedBlocks = audioProcessor.getNumSkippedBlocks();
+    menu.addItem("Sleep on silent input (" + juce::String(numSkippedBlocks) + " blocks skipped)", true,
+                 audioProcessor.isAutoSleepEnabled(), [this]()
+    {
+        audioProcessor.setAutoSleepEnabled(!audioProcessor.isAutoSleepEnabled());
+    });
+    
+    juce::PopupMenu renderAheadMenu;
+    const auto currentRenderAhead = audioProcessor.getRenderAheadBlocks();
+    
+    for (const auto numBlocks : { 0, 1, 2, 4, 8 })
+    {
+        const auto name = numBlocks == 0 ? juce::String("Off") : juce::String(numBlocks) + (numBlocks == 1 ? " block" : " blocks");
+        renderAheadMenu.addItem(name, true, numBlocks == currentRenderAhead, [this, isLoaded, numBlocks]()
+        {
+            audioProcessor.setRenderAheadBlocks(numBlocks);
+            if (isLoaded) { reloadPlugin(); }
+        });
+    }
+    
+    menu.addSubMenu("Render ahead", renderAheadMenu, !audioProcessor.isOutOfProcessMode());
+    
+    const auto numOutputFaults = audioProcessor.getNumOutputFaults();
+    menu.addItem("Reset plugin after repeated NaN/Inf (" + juce::String(numOutputFaults) + " blocks fixed)", true,
+                 audioProcessor.isResetOnRepeatedFaults(), [this]()
+    {
+        audioProcessor.setResetOnRepeatedFaults(!audioProcessor.isResetOnRepeatedFaults());
+    });
+    
+    juce::PopupMenu watchdogMenu;
+    const auto currentMaxOverruns = audioProcessor.getMaxConsecutiveOverruns();
+    
+    for (const auto numOverruns : { 0, 2, 3, 5, 10 })
+    {
+        const auto name = numOverruns == 0 ? juce::String("Off") : "After " + juce::String(numOverruns) + " late blocks";
+        watchdogMenu.addItem(name, true, numOverruns == currentMaxOverruns, [this, numOverruns]()
+        {
+            audioProcessor.setMaxConsecutiveOverruns(numOverruns);
+        });
+    }
+    
+    menu.addSubMenu("Bypass plugin when it misses the deadline", watchdogMenu,
+                    !audioProcessor.isOutOfProcessMode() && audioProcessor.getRenderAheadBlocks() == 0);
+    
+    // 같은 그룹을 고른 트랙들은 플러그인 하나를 넓은 채널 호출로 함께 씀
+    juce::PopupMenu batchGroupMenu;
+    const auto currentBatchGroup = audioProcessor.getBatchGroup();
+    
+    for (int group = 0; group <= maxBatchGroups; ++group)
+    {
+        const auto groupId = group == 0 ? juce::String() : juce::String(group);
+        const auto name = group == 0 ? juce::String("Off") : "Group " + groupId;
+        batchGroupMenu.addItem(name, true, groupId == currentBatchGroup, [this, isLoaded, groupId]()
+        {
+            audioProcessor.setBatchGroup(groupId);
+            if (isLoaded) { reloadPlugin(); }
+        });
+    }
+    
+    menu.addSubMenu("Share one instance across tracks (" + audioProcessor.getBatchStatus() + ")", batchGroupMenu,
+                    !audioProcessor.isOutOfProcessMode() && !audioProcessor.isMultiMonoMode()
+                    && audioProcessor.getRenderAheadBlocks() == 0 && !audioProcessor.isReducedRateMode());
+    
+    juce::PopupMenu midiLearnMenu;
+    const auto mappings = audioProcessor.getMidiMappings();
+    
+    if (audioProcessor.isMidiLearning())
+        midiLearnMenu.addItem("Cancel learning", [this]() { audioProcessor.cancelMidiLearn(); processorStateChanged(false); });
+    else
+        midiLearnMenu.addItem("Learn (move a plugin control, then a MIDI controller)", isLoaded, false, [this]()
+        {
+            audioProcessor.startMidiLearn();
+            processorStateChanged(false);
+        });
+    
+    if (!mappings.empty())
+    {
+        midiLearnMenu.addSeparator();
+        
+        // 누르면 그 연결을 지움
+        for (int i = 0; i < (int) mappings.size(); ++i)
+        {
+            midiLearnMenu.addItem("Remove " + mappings[(size_t) i].getDescription(), [this, i]() { audioProcessor.removeMidiMapping(i); });
+        }
+        
+        midiLearnMenu.addItem("Remove all", [this]() { audioProcessor.clearMidiMappings(); });
+    }
+    
+    menu.addSubMenu("MIDI learn (" + juce::String((int) mappings.size()) + " mapped)", midiLearnMenu,
+                    !audioProcessor.isOutOfProcessMode() && audioProcessor.getRenderAheadBlocks() == 0);
+    
+    menu.addItem("Keep recent plugins warm (" + audioProcessor.getWarmPoolStatus() + ")", true,
+                 audioProcessor.isWarmPoolEnabled(), [this]()
+    {
+        audioProcessor.setWarmPoolEnabled(!audioProcessor.isWarmPoolEnabled());
+    });
+    
+    // 예산은 모든 래퍼 인스턴스가 함께 쓰고, 이 인스턴스만 빼둘 수 있음
+    juce::PopupMenu hibernationMenu;
+    const auto currentBudget = audioProcessor.getHibernationBudgetMegabytes();
+    
+    for (const auto budgetGigabytes : { 0, 2, 4, 8, 16, 32 })
+    {
+        const auto name = budgetGigabytes == 0 ? juce::String("Off") : "Over " + juce::String(budgetGigabytes) + " GB in use";
+        hibernationMenu.addItem(name, true, budgetGigabytes * 1024 == currentBudget, [this, budgetGigabytes]()
+        {
+            audioProcessor.setHibernationBudgetMegabytes(budgetGigabytes * 1024);
+        });
+    }
+    
+    hibernationMenu.addSeparator();
+    hibernationMenu.addItem("Never hibernate this plugin", true, !audioProcessor.isHibernationAllowed(), [this]()
+    {
+        audioProcessor.setHibernationAllowed(!audioProcessor.isHibernationAllowed());
+    });
+    hibernationMenu.addItem("This plugin: " + audioProcessor.getHibernationStatus(), false, false, nullptr);
+    
+    menu.addSubMenu("Hibernate plugins idle for " + juce::String(HibernationManager::idleTimeoutMs / 1000) + " s ("
+                    + audioProcessor.getHibernationManagerStatus() + ")", hibernationMenu);
+    
+    juce::PopupMenu historyMenu;
+    const auto steps = audioProcessor.getStateHistorySteps();
+    
+    // 최근 단계부터 보여줌
+    for (int i = (int) steps.size(); --i >= juce::jmax(0, (int) steps.size() - maxHistoryMenuItems);)
+    {
+        const auto& step = steps[(size_t) i];
+        const auto name = step.time.formatted("%H:%M:%S") + "  (" + juce::File::descriptionOfSizeInBytes((juce::int64) step.storedBytes)
+                        + " of " + juce::File::descriptionOfSizeInBytes((juce::int64) step.stateBytes) + ")";
+        historyMenu.addItem(name, [this, i]() { audioProcessor.restoreStateHistoryStep(i); });
+    }
+    
+    menu.addSubMenu("Restore plugin state", historyMenu, !steps.empty());
+    
+    if (audioProcessor.hasRecoverableState())
+    {
+        menu.addItem("Recover unsaved changes from the last crash", [this]()
+        {
+            releaseHostedPluginEditor();
+            setLoadingState();
+            
+            threadPool.addJob([this]() { audioProcessor.recoverState(); });
+        });
+    }
+    
+    menu.addSeparator();
+    
+    if (audioProcessor.isCapturingSession())
+    {
+        menu.addItem("Stop session capture (" + audioProcessor.getSessionCaptureStatus() + ")", [this]()
+        {
+            audioProcessor.stopSessionCapture();
+            audioProcessor.getSessionCaptureFile().revealToUser();
+        });
+    }
+    else
+    {
+        menu.addItem("Capture session for replay", isLoaded, false, [this]()
+        {
+            if (!audioProcessor.startSessionCapture())
+            {
+                statusLabel.setText("Cannot start session capture", juce::dontSendNotification);
+            }
+        });
+    }
+    
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&optionsButton));
+}
+
+void VST3LoaderAudioProcessorEditor::chooseBatchRenderFiles()
+{
+    batchFileChooser = std::make_unique<juce::FileChooser>("Select audio files to render",
+                                                           juce::File(),
+                                                           "*.wav;*.aif;*.aiff;*.flac");
+    
+    const auto flags = juce::FileBrowserComponent::openMode
+                     | juce::FileBrowserComponent::canSelectFiles
+                     | juce::FileBrowserComponent::canSelectMultipleItems;
+    
+    batchFileChooser->launchAsync(flags, [this](const juce::FileChooser& chooser)
+    {
+        const auto files = chooser.getResults();
+        if (files.isEmpty()) { return; }
+        
+        // 렌더링 결과는 첫 번째 파일 옆의 Rendered 폴더에 저장
+        audioProcessor.startBatchRender(files, files.getFirst().getParentDirectory().getChildFile("Rendered"));
+        processorStateChanged(false);
+    });
+}
+
 void VST3LoaderAudioProcessorEditor::changeListenerCallback (juce::ChangeBroadcaster* source)
 {
     setHostedPluginEditorIfNeeded();
@@ -75,10 +339,31 @@ void VST3LoaderAudioProcessorEditor::changeListenerCallback (juce::ChangeBroadca
 
 void VST3LoaderAudioProcessorEditor::setHostedPluginEditorIfNeeded()
 {
-    if (!audioProcessor.isHostedPluginLoaded()) { return; }
+    if (hostedPluginEditor != nullptr || isHostedPluginEditorPending) { return; }
+    if (!audioProcessor.isHostedPluginLoaded() || !isShowing()) { return; }
+    
+    // 창은 캐시된 크기와 자리 표시로 먼저 보여주고, 호스팅 에디터는 다음 메시지에서 만듦
+    isHostedPluginEditorPending = true;
+    
+    juce::Component::SafePointer<VST3LoaderAudioProcessorEditor> safeThis(this);
+    juce::MessageManager::callAsync([safeThis]()
+    {
+        if (safeThis != nullptr) { safeThis->createHostedPluginEditor(); }
+    });
+}
+
+void VST3LoaderAudioProcessorEditor::createHostedPluginEditor()
+{
+    isHostedPluginEditorPending = false;
+    
+    if (hostedPluginEditor != nullptr || !audioProcessor.isHostedPluginLoaded() || !isShowing()) { return; }
     
     const auto newEditor = audioProcessor.createHostedPluginEditorIfNeeded();
-    if (newEditor == nullptr) { return; }
+    if (newEditor == nullptr)
+    {
+        processorStateChanged(false);
+        return;
+    }
     
     if (hostedPluginEditor.get() != newEditor)
     {
@@ -86,14 +371,50 @@ void VST3LoaderAudioProcessorEditor::setHostedPluginEditorIfNeeded()
         addAndMakeVisible(hostedPluginEditor.get());
         hostedPluginEditor.get()->addComponentListener(this);
     }
+    
+    processorStateChanged(false);
+}
+
+void VST3LoaderAudioProcessorEditor::releaseHostedPluginEditor()
+{
+    if (hostedPluginEditor == nullptr) { return; }
+    
+    // 다음에 창을 열 때 같은 크기로 바로 보여줄 수 있도록 남겨둠
+    audioProcessor.setLastHostedEditorBounds(hostedPluginEditor->getWidth(), hostedPluginEditor->getHeight());
+    
+    hostedPluginEditor->removeComponentListener(this);
+    hostedPluginEditor.reset();
+    repaint();
+}
+
+void VST3LoaderAudioProcessorEditor::updateHostedPluginEditorVisibility()
+{
+    audioProcessor.setEditorShowing(isShowing());
+    
+    if (isShowing())
+        setHostedPluginEditorIfNeeded();
+    else
+        releaseHostedPluginEditor();
+}
+
+void VST3LoaderAudioProcessorEditor::visibilityChanged()
+{
+    updateHostedPluginEditorVisibility();
+}
+
+void VST3LoaderAudioProcessorEditor::parentHierarchyChanged()
+{
+    updateHostedPluginEditorVisibility();
 }
 
 void VST3LoaderAudioProcessorEditor::setLoadingState()
 {
     loadPluginButton.setEnabled(false);
+    openEditorButton.setVisible(false);
     pluginListBoxCover.setVisible(true);
     statusLabel.setColour(juce::Label::textColourId, juce::Colour(0xffFFDFB9));
     statusLabel.setText("Loading...", juce::dontSendNotification);
+    updateTimer();
 }
 
 void VST3LoaderAudioProcessorEditor::processorStateChanged(const bool shouldShowPluginLoadingError)
@@ -101,22 +422,62 @@ void VST3LoaderAudioProcessorEditor::processorStateChanged(const bool shouldShow
     const auto isHostedPluginLoaded = audioProcessor.isHostedPluginLoaded();
     const auto pluginLoadingError = audioProcessor.getHostedPluginLoadingError();
     
-    pluginListBox->setVisible(!isHostedPluginLoaded);
+    if (!isHostedPluginLoaded) { createPluginListBoxIfNeeded(); }
+    if (pluginListBox != nullptr) { pluginListBox->setVisible(!isHostedPluginLoaded); }
     pluginListBoxCover.setVisible(false);
     loadPluginButton.setVisible(!isHostedPluginLoaded);
-    loadPluginButton.setEnabled(pluginListBox->isPluginSelected());
+    loadPluginButton.setEnabled(pluginListBox != nullptr && pluginListBox->isPluginSelected());
     closePluginButton.setVisible(isHostedPluginLoaded);
+    batchRenderButton.setVisible(isHostedPluginLoaded);
+    batchRenderButton.setEnabled(!audioProcessor.isBatchRendering());
+    openEditorButton.setVisible(isHostedPluginLoaded && hostedPluginEditor == nullptr && !isHostedPluginEditorPending
+                                && !audioProcessor.isCurrentlyLoading());
     
     if (isHostedPluginLoaded)
     {
         juce::String labelText = audioProcessor.getHostedPluginName();
         
-        if (hostedPluginEditor == nullptr)
+        if (audioProcessor.isHostedPluginInstrument())
+        {
+            labelText = labelText + " (instrument)";
+        }
+        
+        if (audioProcessor.isHibernating())
+        {
+            labelText = labelText + " (" + audioProcessor.getHibernationStatus() + ")";
+        }
+        
+        if (hostedPluginEditor == nullptr && isShowing() && !isHostedPluginEditorPending)
         {
             labelText = labelText + " (no editor)";
         }
         
-        statusLabel.setColour(juce::Label::textColourId, juce::Colour(0xffFFDFB9));
+        const auto loadSummary = audioProcessor.getLastLoadReport().getSummary();
+        if (loadSummary.isNotEmpty())
+        {
+            labelText = labelText + " | " + loadSummary;
+        }
+        
+        const auto batchRenderStatus = audioProcessor.getBatchRenderStatus();
+        if (batchRenderStatus.isNotEmpty())
+        {
+            labelText = labelText + " | " + batchRenderStatus;
+        }
+        
+        const auto midiLearnStatus = audioProcessor.getMidiLearnStatus();
+        if (midiLearnStatus.isNotEmpty())
+        {
+            labelText = labelText + " | MIDI learn: " + midiLearnStatus;
+        }
+        
+        lastWatchdogWarning = audioProcessor.getWatchdogWarning();
+        if (lastWatchdogWarning.isNotEmpty())
+        {
+            labelText = labelText + " | " + lastWatchdogWarning;
+        }
+        
+        statusLabel.setColour(juce::Label::textColourId,
+                              lastWatchdogWarning.isNotEmpty() ? juce::Colours::orange : juce::Colour(0xffFFDFB9));
         statusLabel.setText(labelText, juce::dontSendNotification);
     }
     else
@@ -130,11 +491,25 @@ void VST3LoaderAudioProcessorEditor::processorStateChanged(const bool shouldShow
     
     setSize(getEditorWidth(), getEditorHeight());
     repaint();
+    updateTimer();
+}
+
+void VST3LoaderAudioProcessorEditor::updateTimer()
+{
+    // 키보드 포커스를 한 번 잡은 뒤에는 로딩 진행 상황을 보여줄 때만 돌림
+    if (!hasGrabbedKeyboardFocus || audioProcessor.isCurrentlyLoading())
+    {
+        if (!isTimerRunning()) { startTimer(timerIntervalMs); }
+    }
+    else
+    {
+        stopTimer();
+    }
 }
 
 void VST3LoaderAudioProcessorEditor::buttonClicked(juce::Button* button)
 {
-    if (button == &loadPluginButton)
+    if (button == &loadPluginButton && pluginListBox != nullptr)
     {
         juce::String selectedPlugin = pluginListBox->getSelectedPlugin();
         if (selectedPlugin.isNotEmpty())
@@ -146,11 +521,43 @@ void VST3LoaderAudioProcessorEditor::buttonClicked(juce::Button* button)
     {
         closePlugin();
     }
+    else if (button == &batchRenderButton)
+    {
+        chooseBatchRenderFiles();
+    }
+    else if (button == &optionsButton)
+    {
+        showOptionsMenu();
+    }
+    else if (button == &openEditorButton)
+    {
+        openEditorButton.setVisible(false);
+        createHostedPluginEditor();
+    }
 }
 
 void VST3LoaderAudioProcessorEditor::paint (juce::Graphics& g)
 {
     g.fillAll (juce::Colour(0xff1a1a1a));
+    
+    if (hostedPluginEditor != nullptr || !audioProcessor.isHostedPluginLoaded()) { return; }
+    
+    // 호스팅 에디터가 만들어지기 전이나 만들지 못했을 때 보여줄 자리 표시
+    // (VST3 에디터는 네이티브 뷰라서 스냅샷으로 찍히지 않으므로 이름만 그림)
+    const auto area = getPlaceholderArea();
+    g.setColour(juce::Colour(0xff2a2a2a));
+    g.fillRect(area.reduced(margin));
+    
+    g.setColour(juce::Colour(0x80FFDFB9));
+    g.setFont(18.0f);
+    g.drawText(audioProcessor.getHostedPluginName(),
+               area.withTrimmedBottom(area.getHeight() / 2 - buttonHeight).reduced(2 * margin, 0),
+               juce::Justification::centredBottom, true);
+}
+
+juce::Rectangle<int> VST3LoaderAudioProcessorEditor::getPlaceholderArea()
+{
+    return { 0, 0, getEditorWidth(), getHostedPluginEditorOrPluginListHeight() };
 }
 
 void VST3LoaderAudioProcessorEditor::componentMovedOrResized(juce::Component &component,
@@ -170,19 +577,38 @@ void VST3LoaderAudioProcessorEditor::resized()
         hostedPluginEditor->setTopLeftPosition(0, 0);
     }
     
-    pluginListBox->setBounds(0, 0, getEditorWidth(), browserHeight);
+    if (pluginListBox != nullptr) { pluginListBox->setBounds(0, 0, getEditorWidth(), browserHeight); }
     pluginListBoxCover.setBounds(0, 0, getEditorWidth(), browserHeight);
-    loadPluginButton.setBounds(margin, getButtonOriginY(),
-                              getBounds().getWidth() - 2 * margin, buttonHeight);
-    closePluginButton.setBounds(margin, getButtonOriginY(),
-                               getBounds().getWidth() - 2 * margin, buttonHeight);
+    const auto buttonRowWidth = getBounds().getWidth() - 3 * margin - optionsButtonWidth;
+    loadPluginButton.setBounds(margin, getButtonOriginY(), buttonRowWidth, buttonHeight);
+    const auto halfButtonWidth = (buttonRowWidth - margin) / 2;
+    closePluginButton.setBounds(margin, getButtonOriginY(), halfButtonWidth, buttonHeight);
+    batchRenderButton.setBounds(2 * margin + halfButtonWidth, getButtonOriginY(),
+                               halfButtonWidth, buttonHeight);
+    optionsButton.setBounds(2 * margin + buttonRowWidth, getButtonOriginY(),
+                           optionsButtonWidth, buttonHeight);
     statusLabel.setBounds(margin, getLabelOriginY(),
                          getBounds().getWidth() - 2 * margin, labelHeight);
+    openEditorButton.setBounds(getPlaceholderArea().withSizeKeepingCentre(openEditorButtonWidth, buttonHeight)
+                                                   .translated(0, buttonHeight));
 }
 
 void VST3LoaderAudioProcessorEditor::timerCallback()
 {
-    setWantsKeyboardFocus(true);
-    grabKeyboardFocus();
-    stopTimer();
+    if (!hasGrabbedKeyboardFocus)
+    {
+        setWantsKeyboardFocus(true);
+        grabKeyboardFocus();
+        hasGrabbedKeyboardFocus = true;
+    }
+    
+    if (audioProcessor.isCurrentlyLoading())
+    {
+        const auto progress = audioProcessor.getLoadProgressText();
+        statusLabel.setText(progress.isEmpty() ? juce::String("Loading...") : "Loading... (" + progress + ")",
+                            juce::dontSendNotification);
+    }
+    
+    // 로딩이 끝나면 변경 알림으로 상태를 다시 그리므로 더 돌 필요가 없음
+    updateTimer();
 }
@@ -18,6 +18,8 @@ public:
     void changeListenerCallback (juce::ChangeBroadcaster* source) override;
     void buttonClicked(juce::Button*) override;
     void componentMovedOrResized (juce::Component& component, bool wasMoved, bool wasResized) override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
 private:
     class SemiTransparentComponent : public juce::Component
@@ -37,16 +39,33 @@ private:
     
     void loadPlugin(const juce::String& filePath);
     void closePlugin();
+    void chooseBatchRenderFiles();
+    void showOptionsMenu();
+    void reloadPlugin();
     void setHostedPluginEditorIfNeeded();
+    void createHostedPluginEditor();
+    void releaseHostedPluginEditor();
+    void updateHostedPluginEditorVisibility();
+    void createPluginListBoxIfNeeded();
+    
+    bool isHostedPluginEditorPending = false;
+    bool hasGrabbedKeyboardFocus = false;
     
     std::unique_ptr<VST3ListBox> pluginListBox;
     SemiTransparentComponent pluginListBoxCover;
     juce::TextButton loadPluginButton;
     juce::TextButton closePluginButton;
+    juce::TextButton batchRenderButton;
+    juce::TextButton optionsButton;
+    juce::TextButton openEditorButton;
+    std::unique_ptr<juce::FileChooser> batchFileChooser;
     juce::Label statusLabel;
+    juce::String lastWatchdogWarning;
     
     void setLoadingState();
     void processorStateChanged(bool shouldShowPluginLoadingError);
+    void updateTimer();
+    juce::Rectangle<int> getPlaceholderArea();
     
     static constexpr int defaultEditorWidth = 650;
     static constexpr int margin = 10;
@@ -54,15 +73,30 @@ private:
     static constexpr int labelHeight = 30;
     static constexpr int buttonHeight = 30;
     static constexpr int buttonTopspacing = 5;
+    static constexpr int optionsButtonWidth = 80;
+    static constexpr int openEditorButtonWidth = 120;
+    static constexpr int timerIntervalMs = 500;
+    static constexpr int maxHistoryMenuItems = 20;
+    static constexpr int maxBatchGroups = 8;
+    
+    // 호스팅 에디터가 아직 없으면 마지막으로 알려진 크기를 씀
+    juce::Rectangle<int> getCachedHostedEditorBounds()
+    {
+        return audioProcessor.isHostedPluginLoaded() ? audioProcessor.getLastHostedEditorBounds() : juce::Rectangle<int>();
+    }
     
     int getEditorWidth()
     {
-        return hostedPluginEditor == nullptr ? defaultEditorWidth : hostedPluginEditor->getWidth();
+        if (hostedPluginEditor != nullptr) { return hostedPluginEditor->getWidth(); }
+        const auto cached = getCachedHostedEditorBounds();
+        return cached.isEmpty() ? defaultEditorWidth : cached.getWidth();
     }
     
     int getHostedPluginEditorOrPluginListHeight()
     {
-        return hostedPluginEditor == nullptr ? browserHeight : hostedPluginEditor->getHeight();
+        if (hostedPluginEditor != nullptr) { return hostedPluginEditor->getHeight(); }
+        const auto cached = getCachedHostedEditorBounds();
+        return cached.isEmpty() ? browserHeight : cached.getHeight();
     }
     
     int getEditorHeight()
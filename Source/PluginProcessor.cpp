@@ -2,32 +2,150 @@
 #include "PluginEditor.h"
 
 VST3LoaderAudioProcessor::VST3LoaderAudioProcessor()
-    : AudioProcessor (BusesProperties()
-                     .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                     .withOutput ("Output", juce::AudioChannelSet::stereo(), true))
+    : AudioProcessor (createBusesProperties())
 {
     formatManager.addDefaultFormats();
+    
+    // 감시자가 우회하거나 되돌리면 에디터가 경고를 다시 그리도록 알림
+    deadlineWatchdog.onStateChanged = [this]() { sendChangeMessage(); };
+    
+    outputSanitizer.onRepeatedFaults = [this]()
+    {
+        {
+            const juce::ScopedLock sl(innerMutex);
+            if (multiMonoHost != nullptr) { multiMonoHost->reset(); }
+        }
+        
+        safelyPerform<void>([](auto& p) { p->reset(); });
+    };
+    
+    stateHistory.captureState = [this](juce::MemoryBlock& state) { return getHostedPluginInnerState(state); };
+    midiLearn.onMappingsChanged = [this]() { sendChangeMessage(); };
+    hibernation.canHibernate = [this]() { return canHibernateHostedPlugin(); };
+    hibernation.hibernate = [this]() { return hibernateHostedPlugin(); };
+    hibernation.wakeUp = [this]() { wakeHostedPlugin(); };
+    stateHistory.start();
 }
 
-VST3LoaderAudioProcessor::~VST3LoaderAudioProcessor() {}
+juce::AudioProcessor::BusesProperties VST3LoaderAudioProcessor::createBusesProperties()
+{
+    auto properties = BusesProperties()
+                      .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                      .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false);
+    
+    // 악기 타깃에서만 멀티 아웃용 보조 출력을 둠 (기본은 꺼짐)
+    for (int i = 0; i < numAuxOutputBuses; ++i)
+    {
+        properties = properties.withOutput("Output " + juce::String(3 + 2 * i) + "-" + juce::String(4 + 2 * i),
+                                           juce::AudioChannelSet::stereo(), false);
+    }
+    
+    return properties;
+}
+
+VST3LoaderAudioProcessor::~VST3LoaderAudioProcessor()
+{
+    cancelPendingUpdate();
+    loadScheduler->cancel(this);
+    leaveBatchGroup();
+    stateHistory.stop();
+    safelyPerform<void>([this](auto& p) { stateHistory.detach(*p); });
+}
 
 void VST3LoaderAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    // 트랙이 다시 켜지면 재워둔 플러그인을 백그라운드에서 다시 로드
+    hibernation.requestWakeUp();
+    
+    std::shared_ptr<OutOfProcessHost> host;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        host = outOfProcessHost;
+        isPreparingOutOfProcessHost = host != nullptr;
+    }
+    
+    // 자식 프로세스를 다시 띄우는 동안 (최대 1초 가량) 오디오 스레드가 innerMutex 에서 막히지 않도록 잠그지 않고 준비함
+    if (host != nullptr)
+    {
+        host->prepare(sampleRate, samplesPerBlock);
+        setLatencySamples(host->getLatencySamples());
+        
+        const juce::ScopedLock sl(innerMutex);
+        isPreparingOutOfProcessHost = false;
+    }
+    
+    prepareRateConverter(sampleRate, samplesPerBlock);
+    midiLearn.prepare(sampleRate);
+    
     safelyPerform<void>([&](auto& p)
     {
         p->releaseResources();
-        p->setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
-        p->prepareToPlay(sampleRate, samplesPerBlock);
+        p->setRateAndBufferSizeDetails(rateConverter.getInternalSampleRate(), rateConverter.getMaxInternalBlockSize());
+        p->prepareToPlay(rateConverter.getInternalSampleRate(), rateConverter.getMaxInternalBlockSize());
     });
+    
+    {
+        const juce::ScopedLock sl(innerMutex);
+        if (multiMonoHost != nullptr) { multiMonoHost->prepare(sampleRate, samplesPerBlock); }
+    }
+    
+    prepareScratchBuffers(samplesPerBlock);
+    updateAutoSleep();
+    realtimeSafetyMonitor.prepare(sampleRate);
+    
+    {
+        const juce::ScopedLock sl(rendererMutex);
+        if (anticipativeRenderer != nullptr)
+        {
+            anticipativeRenderer->prepare(sampleRate, samplesPerBlock,
+                                          juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()),
+                                          getRenderAheadBlocks());
+        }
+    }
+    
+    // 내부 레이트 변환 지연은 호스트 샘플레이트에 따라 달라짐
+    auto hasHostedInstance = false;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        hasHostedInstance = hostedPluginInstance != nullptr;
+    }
+    
+    if (hasHostedInstance)
+    {
+        setLatencySamples(getHostedLatencySamples() + getRendererLatencySamples());
+    }
+    
+    prepareDeadlineWatchdog();
+    
+    // 레이트나 블록 크기가 바뀌었을 수 있으므로 그룹에 다시 들어감
+    if (hasHostedInstance) { joinBatchGroupIfNeeded(); }
 }
 
 void VST3LoaderAudioProcessor::reset()
 {
+    {
+        const juce::ScopedLock sl(innerMutex);
+        if (outOfProcessHost != nullptr && !isPreparingOutOfProcessHost) { outOfProcessHost->reset(); }
+        if (multiMonoHost != nullptr) { multiMonoHost->reset(); }
+        rateConverter.reset();
+    }
+    
+    {
+        const juce::ScopedLock sl(rendererMutex);
+        if (anticipativeRenderer != nullptr) { anticipativeRenderer->reset(); }
+    }
+    
     safelyPerform<void>([&](auto& p) { p->reset(); });
 }
 
 void VST3LoaderAudioProcessor::releaseResources()
 {
+    {
+        const juce::ScopedLock sl(innerMutex);
+        if (multiMonoHost != nullptr) { multiMonoHost->releaseResources(); }
+    }
+    
     safelyPerform<void>([&](auto& p) { p->releaseResources(); });
 }
 
@@ -38,7 +156,74 @@ double VST3LoaderAudioProcessor::getTailLengthSeconds() const
 
 bool VST3LoaderAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
-    return true;
+    const auto mainInput = layouts.getMainInputChannelSet();
+    const auto mainOutput = layouts.getMainOutputChannelSet();
+    
+    if (mainOutput.isDisabled() || mainOutput.size() > maxHostedChannels) { return false; }
+    
+    // 입출력이 같거나 mono -> stereo 만 허용 (모노, 스테레오, 서라운드)
+    if (!mainInput.isDisabled() && mainInput != mainOutput
+        && !(mainInput == juce::AudioChannelSet::mono() && mainOutput == juce::AudioChannelSet::stereo()))
+    {
+        return false;
+    }
+    
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+        if (!sidechain.isDisabled()
+            && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+        {
+            return false;
+        }
+    }
+    
+    auto totalOutputChannels = mainOutput.size();
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+    {
+        const auto aux = layouts.getChannelSet(false, bus);
+        if (!aux.isDisabled() && aux != juce::AudioChannelSet::mono() && aux != juce::AudioChannelSet::stereo())
+        {
+            return false;
+        }
+        
+        totalOutputChannels += aux.size();
+    }
+    
+    return totalOutputChannels <= maxHostedChannels;
+}
+
+void VST3LoaderAudioProcessor::processorLayoutsChanged()
+{
+    setHostedPluginLayout();
+    
+    // 채널 수가 바뀌면 채널 인스턴스를 메시지 스레드에서 다시 만듦 (소멸자에서 대기 중인 호출은 취소됨)
+    if (isMultiMonoMode())
+    {
+        shouldRebuildMultiMonoHost.store(true);
+        triggerAsyncUpdate();
+    }
+}
+
+void VST3LoaderAudioProcessor::handleAsyncUpdate()
+{
+    if (shouldRebuildMultiMonoHost.exchange(false))
+    {
+        rebuildMultiMonoHost();
+    }
+    
+    // 같은 그룹에 다른 트랙이 들어오거나 나가서 그룹의 지연이 바뀌었으면 호스트에 다시 알림
+    if (shouldUpdateBatchLatency.exchange(false))
+    {
+        auto latency = -1;
+        {
+            const juce::ScopedLock sl(innerMutex);
+            if (batchMember != nullptr) { latency = batchMember->getLatencySamples(); }
+        }
+        
+        if (latency >= 0) { setLatencySamples(latency); }
+    }
 }
 
 void VST3LoaderAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
@@ -58,44 +243,243 @@ void VST3LoaderAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType
                                                    juce::MidiBuffer& midiMessages,
                                                    bool isActive)
 {
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        sessionCapture.pushBlock(buffer, midiMessages, isActive, getPlayHead());
+    }
+    
+    if (hibernation.isAllowed())
+    {
+        hibernation.noteBlock(buffer, midiMessages, getTotalNumInputChannels());
+    }
+    
+    // 바운스 중에는 재워둔 플러그인도 원음을 내보내지 않도록 다시 로드될 때까지 기다림
+    if (isNonRealtime())
+    {
+        hibernation.waitUntilAwake(offlineWakeTimeoutMs);
+    }
+    
+    const RealtimeSafetyMonitor::ScopedBlock monitoredBlock(realtimeSafetyMonitor, buffer.getNumSamples());
+    
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        const RealtimeSafetyMonitor::ScopedLock sl(realtimeSafetyMonitor, rendererMutex);
+        if (anticipativeRenderer != nullptr)
+        {
+            anticipativeRenderer->process(buffer, midiMessages, isActive, getPlayHead());
+            return;
+        }
+    }
+    
+    const RealtimeSafetyMonitor::ScopedLock sl(realtimeSafetyMonitor, innerMutex);
+    
+    if (outOfProcessHost != nullptr)
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            if (!isPreparingOutOfProcessHost)
+            {
+                outOfProcessHost->process(buffer, midiMessages, isActive);
+                outputSanitizer.process(buffer, getTotalNumOutputChannels());
+                return;
+            }
+        }
+        
+        buffer.clear();
+        return;
+    }
+    
+    if (isLoading && !hasInputWhileLoading.load(std::memory_order_relaxed))
+    {
+        for (int ch = 0; ch < getTotalNumInputChannels() && ch < buffer.getNumChannels(); ++ch)
+        {
+            if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) > (SampleType) 0)
+            {
+                hasInputWhileLoading.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+    
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        if (batchMember != nullptr && batchMember->getLatencySamples() != getLatencySamples())
+        {
+            shouldUpdateBatchLatency.store(true, std::memory_order_relaxed);
+            triggerAsyncUpdate();
+        }
+        
+        // 묶음 그룹에 들어가 있으면 공유 인스턴스가 처리한 한 블록 늦은 결과를 받음 (바이패스면 같은 지연의 원음)
+        // 바운스 중에는 공유 인스턴스를 기다리지 않고 자기 인스턴스로 처리함
+        if (batchMember != nullptr && !isNonRealtime())
+        {
+            if (isActive)
+                midiLearn.process(buffer, midiMessages, [&](auto& sliceBuffer, juce::MidiBuffer&) { batchMember->process(sliceBuffer); });
+            else
+                batchMember->delayBlock(buffer);
+            
+            outputSanitizer.process(buffer, getTotalNumOutputChannels());
+            return;
+        }
+    }
+    
+    // 호스트 플레이헤드는 블록마다 여기서 한 번만 읽음
+    hostedPlayHead.capture(getPlayHead());
+    
+    // MIDI 학습으로 연결된 컨트롤러가 있으면 블록을 나눠 파라미터를 바꿔가며 호스팅 플러그인을 부름
+    auto processWithMidiLearn = [&](auto& blockBuffer, juce::MidiBuffer& blockMidi)
+    {
+        midiLearn.process(blockBuffer, blockMidi, [&](auto& sliceBuffer, juce::MidiBuffer& sliceMidi)
+        {
+            processHostedPlugin(sliceBuffer, sliceMidi, isActive);
+        });
+    };
+    
+    // 플러그인별 비용 기록: 한 인스턴스가 호스트 레이트로 처리한 시간만 셈 (감시기가 우회 중이거나 AutoSleep 이 건너뛴 블록은 제외)
+    const auto isMeasuringCost = isActive && !isNonRealtime() && costMeter.isMeasuring() && hostedPluginInstance != nullptr
+                                 && multiMonoHost == nullptr && !rateConverter.isActive() && !deadlineWatchdog.isBypassing();
+    const auto startTicks = isMeasuringCost ? juce::Time::getHighResolutionTicks() : 0;
+    hasSkippedBlock = false;
+    
+    // 오프라인 렌더링은 마감 시간이 없으므로 감시하지 않음
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        if (isNonRealtime())
+            processWithMidiLearn(buffer, midiMessages);
+        else
+            deadlineWatchdog.process(buffer, midiMessages, processWithMidiLearn);
+    }
+    else
+    {
+        processWithMidiLearn(buffer, midiMessages);
+    }
+    
+    if (isMeasuringCost && !hasSkippedBlock)
+    {
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        costMeter.addBlock(buffer.getNumSamples(), getSampleRate(), elapsed * 1000.0);
+    }
+    
+    // 묶음 그룹의 지연을 알린 상태이므로 자기 인스턴스로 처리한 결과도 같은 만큼 늦춤
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        if (batchMember != nullptr) { batchMember->delayBlock(buffer); }
+    }
+}
+
+void VST3LoaderAudioProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(isNonRealtime);
+    
+    if (isNonRealtime) { hibernation.requestWakeUp(); }
+    
+    // 호스팅 플러그인도 바운스 중임을 알아야 자체 오프라인 경로(고품질 모드, 스레드 대기 등)를 고를 수 있음
+    const juce::ScopedLock sl(innerMutex);
+    if (hostedPluginInstance != nullptr) { hostedPluginInstance->setNonRealtime(isNonRealtime); }
+    if (multiMonoHost != nullptr) { multiMonoHost->setNonRealtime(isNonRealtime); }
+}
+
+template<typename SampleType>
+void VST3LoaderAudioProcessor::processHostedPlugin(juce::AudioBuffer<SampleType>& buffer,
+                                                   juce::MidiBuffer& midiMessages,
+                                                   bool isActive)
+{
+    // 디노멀로 인한 CPU 급증을 막기 위해 호스팅 플러그인 호출 동안 FTZ/DAZ 를 켬
+    const juce::ScopedNoDenormals noDenormals;
+    
     safelyPerform<void>([&](auto& p)
     {
-        if (isActive)
+        if (autoSleep.shouldSkipBlock(buffer, midiMessages, getTotalNumInputChannels()))
+        {
+            hasSkippedBlock = true;
+            return;
+        }
+        
+        // 악기는 오디오 입력을 받지 않으므로 호스트가 넘긴 메인 입력이 출력에 섞이지 않게 비움
+        if (hostedPluginIsInstrument)
+        {
+            for (int ch = 0; ch < getChannelCountOfBus(true, 0) && ch < buffer.getNumChannels(); ++ch)
+            {
+                buffer.clear(getChannelIndexInProcessBlockBuffer(true, 0, ch), 0, buffer.getNumSamples());
+            }
+        }
+        
+        if (multiMonoHost != nullptr)
         {
-            p->setPlayHead(getPlayHead());
+            multiMonoHost->process(buffer, midiMessages, isActive);
+            return;
         }
         
-        const auto hostedPluginChannels = juce::jmax(p->getTotalNumInputChannels(),
-                                                     p->getTotalNumOutputChannels());
-        const auto currentChannels = buffer.getNumChannels();
+        const auto numSamples = buffer.getNumSamples();
         
-        if (hostedPluginChannels > currentChannels)
+        auto processAtHostedRate = [&](juce::AudioBuffer<SampleType>& hostedBuffer)
         {
-            juce::AudioBuffer<SampleType> innerBuffer(hostedPluginChannels, buffer.getNumSamples());
-            for (int i = 0; i < hostedPluginChannels; ++i)
+            auto processHostedBlock = [&](auto& blockBuffer, juce::MidiBuffer& blockMidi)
             {
-                if (i < currentChannels)
-                    innerBuffer.copyFrom(i, 0, buffer.getReadPointer(i), buffer.getNumSamples());
+                if (isActive)
+                    p->processBlock(blockBuffer, blockMidi);
                 else
-                    innerBuffer.clear(i, 0, buffer.getNumSamples());
-            }
+                    p->processBlockBypassed(blockBuffer, blockMidi);
+            };
             
-            if (isActive)
-                p->processBlock(innerBuffer, midiMessages);
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                // 내부 블록은 내림 필터 지연과 넘어온 샘플만큼 앞선 입력이므로, 플러그인이 보는 위치도 그 입력에 맞춤
+                // 올림 필터와 FIFO 지연은 알린 지연에 들어 있어 호스트가 보정하므로 위치에는 넣지 않음
+                hostedPlayHead.setInputDelay(rateConverter.isActive() ? rateConverter.getInputDelaySamples() : 0);
+                rateConverter.process(hostedBuffer, midiMessages, processHostedBlock);
+            }
             else
-                p->processBlockBypassed(innerBuffer, midiMessages);
-                
-            for (int i = 0; i < currentChannels; ++i)
-                buffer.copyFrom(i, 0, innerBuffer.getReadPointer(i), buffer.getNumSamples());
+            {
+                processHostedBlock(hostedBuffer, midiMessages);
+            }
+        };
+        
+        if (hostedChannelMapIsIdentity && numHostedChannels <= buffer.getNumChannels())
+        {
+            processAtHostedRate(buffer);
+            return;
         }
-        else
+        
+        // 레이아웃이 다르면 복사 대신 채널 포인터만 재배치하고, 대응 채널이 없으면 스크래치 채널을 씀
+        auto& scratchBuffer = [this]() -> juce::AudioBuffer<SampleType>&
         {
-            if (isActive)
-                p->processBlock(buffer, midiMessages);
+            if constexpr (std::is_same_v<SampleType, float>)
+                return floatScratchBuffer;
+            else
+                return doubleScratchBuffer;
+        }();
+        
+        if (numSamples > scratchBuffer.getNumSamples() || numHostedChannels > scratchBuffer.getNumChannels())
+        {
+            jassertfalse;
+            return;
+        }
+        
+        SampleType* channels[maxHostedChannels] = {};
+        
+        for (int i = 0; i < numHostedChannels; ++i)
+        {
+            const auto wrapperChannel = hostedChannelMap[(size_t) i];
+            
+            if (wrapperChannel >= 0 && wrapperChannel < buffer.getNumChannels())
+            {
+                channels[i] = buffer.getWritePointer(wrapperChannel);
+            }
             else
-                p->processBlockBypassed(buffer, midiMessages);
+            {
+                channels[i] = scratchBuffer.getWritePointer(i);
+                juce::FloatVectorOperations::clear(channels[i], numSamples);
+            }
         }
+        
+        juce::AudioBuffer<SampleType> hostedBuffer(channels, numHostedChannels, numSamples);
+        processAtHostedRate(hostedBuffer);
     });
+    
+    // MIDI 학습으로 나눈 다음 조각은 이 조각이 끝난 위치부터 시작
+    hostedPlayHead.advance(buffer.getNumSamples());
+    outputSanitizer.process(buffer, getTotalNumOutputChannels());
 }
 
 juce::AudioProcessorEditor* VST3LoaderAudioProcessor::createEditor()
@@ -105,7 +489,17 @@ juce::AudioProcessorEditor* VST3LoaderAudioProcessor::createEditor()
 
 bool VST3LoaderAudioProcessor::isHostedPluginLoaded()
 {
-    return safelyPerform<bool>([](auto& p) { return p != nullptr; });
+    // 재워둔 플러그인도 로드된 것으로 보여서 에디터가 브라우저로 돌아가지 않게 함
+    if (hibernation.isHibernating()) { return true; }
+    
+    const juce::ScopedLock sl(innerMutex);
+    return hostedPluginInstance != nullptr || outOfProcessHost != nullptr;
+}
+
+bool VST3LoaderAudioProcessor::isHostedPluginInstrument()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return hostedPluginInstance != nullptr && hostedPluginIsInstrument;
 }
 
 bool VST3LoaderAudioProcessor::isCurrentlyLoading()
@@ -119,39 +513,751 @@ void VST3LoaderAudioProcessor::loadPlugin(const juce::String& pluginPath)
     if (isCurrentlyLoading()) { return; }
     
     removePreviouslyHostedPluginIfNeeded(true);
+    hasInputWhileLoading.store(false);
     setIsLoading(true);
     
-    auto callback = [this, pluginPath](auto pluginInstance)
+    if (isOutOfProcessMode())
     {
-        if (pluginInstance == nullptr)
-        {
-            setIsLoading(false);
-            juce::MessageManager::callAsync([this]() { sendChangeMessage(); });
-            return;
-        }
-        
-        const auto desc = pluginInstance->getPluginDescription();
-        const auto pluginName = desc.manufacturerName + " - " + desc.name;
-        
-        setHostedPluginInstance(std::move(pluginInstance));
-        
-        auto successfullyConfigured = true;
+        loadPluginOutOfProcess(pluginPath);
+        return;
+    }
+    
+    loadPluginFromFile(pluginPath, [this, pluginPath](auto pluginInstance)
+    {
+        finishLoadingPlugin(pluginPath, std::move(pluginInstance));
+    });
+}
+
+void VST3LoaderAudioProcessor::loadPluginInstance(std::unique_ptr<juce::AudioPluginInstance> pluginInstance)
+{
+    if (isCurrentlyLoading() || pluginInstance == nullptr) { return; }
+    
+    removePreviouslyHostedPluginIfNeeded(true);
+    setIsLoading(true);
+    
+    const auto pluginPath = pluginInstance->getPluginDescription().fileOrIdentifier;
+    loadProfiler.start(pluginPath);
+    finishLoadingPlugin(pluginPath, std::move(pluginInstance));
+}
+
+void VST3LoaderAudioProcessor::finishLoadingPlugin(const juce::String& pluginPath,
+                                                   std::unique_ptr<juce::AudioPluginInstance> pluginInstance)
+{
+    if (pluginInstance == nullptr)
+    {
+        hibernation.noteLoadFinished(false);
+        setIsLoading(false);
+        juce::MessageManager::callAsync([this]() { sendChangeMessage(); });
+        return;
+    }
+    
+    const auto desc = pluginInstance->getPluginDescription();
+    const auto pluginName = desc.manufacturerName + " - " + desc.name;
+    
+    setHostedPluginInstance(std::move(pluginInstance));
+    
+    auto successfullyConfigured = true;
+    
+    {
+        const LoadProfiler::ScopedPhase phase(loadProfiler, LoadProfiler::layout);
         successfullyConfigured &= setHostedPluginLayout();
+    }
+    
+    {
+        const LoadProfiler::ScopedPhase phase(loadProfiler, LoadProfiler::prepare);
         successfullyConfigured &= prepareHostedPluginForPlaying();
+    }
+    
+    {
+        const LoadProfiler::ScopedPhase phase(loadProfiler, LoadProfiler::restoreState);
         setHostedPluginState();
-        setHostedPluginPath(pluginPath);
-        setHostedPluginName(pluginName);
+    }
+    
+    updateAutoSleep();
+    deadlineWatchdog.setPluginName(pluginName);
+    midiLearn.setPluginPath(pluginPath);
+    setHostedPluginPath(pluginPath);
+    setHostedPluginName(isMultiMonoMode() ? pluginName + " (multi-mono)" : pluginName);
+    
+    if (successfullyConfigured)
+    {
+        rebuildMultiMonoHost();
+        rebuildAnticipativeRenderer();
+        joinBatchGroupIfNeeded();
+        stateHistory.clear(pluginPath);
+        
+        const auto report = loadProfiler.finish(pluginName);
         
-        if (!successfullyConfigured)
+        // 미리 만들어둔 인스턴스를 받은 로드는 플러그인 자체의 비용이 아니므로 남기지 않음
+        if (report.phaseMilliseconds[LoadProfiler::instantiate] > 0.0)
         {
-            removePreviouslyHostedPluginIfNeeded(false);
+            costDatabase->recordLoad(pluginPath, pluginName, report.getTotalMilliseconds(), report.residentBytesDelta);
         }
+        costMeter.setPlugin(pluginPath);
         
-        setIsLoading(false);
-        juce::MessageManager::callAsync([this]() { sendChangeMessage(); });
-    };
+        // 상태가 적용된 인스턴스가 생겼으므로 받아둔 상태를 버림
+        hibernation.noteLoadFinished(true);
+        
+        const juce::ScopedLock sl(innerMutex);
+        lastLoadReport = report;
+        hibernatedState = juce::MemoryBlock();
+    }
+    else
+    {
+        removePreviouslyHostedPluginIfNeeded(false);
+    }
+    
+    setIsLoading(false);
+    juce::MessageManager::callAsync([this]() { sendChangeMessage(); });
+}
+
+void VST3LoaderAudioProcessor::loadPluginOutOfProcess(const juce::String& pluginPath)
+{
+    auto onDescribed = [this, pluginPath](bool foundDescription,
+                                          const juce::PluginDescription& pluginDescription,
+                                          const juce::String& error,
+                                          double describeMilliseconds)
+    {
+        loadProfiler.start(pluginPath);
+        loadProfiler.addPhaseMilliseconds(LoadProfiler::describe, describeMilliseconds);
+        
+        if (!foundDescription)
+        {
+            setHostedPluginLoadingError(error);
+            setIsLoading(false);
+            sendChangeMessage();
+            return;
+        }
+        
+        juce::MemoryBlock innerState;
+        {
+            const juce::ScopedLock sl(innerMutex);
+            innerState = hostedPluginState;
+            hostedPluginState = juce::MemoryBlock();
+        }
+        
+        auto host = std::make_shared<OutOfProcessHost>(pluginDescription, innerState);
+        
+        loadProfiler.beginPhase(LoadProfiler::instantiate);
+        const auto launched = host->prepare(getSampleRate(), getBlockSize());
+        loadProfiler.endPhase();
+        
+        if (!launched)
+        {
+            setHostedPluginLoadingError(host->getLastError());
+            setIsLoading(false);
+            sendChangeMessage();
+            return;
+        }
+        
+        host->onWorkerReady = [this]()
+        {
+            const juce::ScopedLock sl(innerMutex);
+            if (outOfProcessHost != nullptr) { setLatencySamples(outOfProcessHost->getLatencySamples()); }
+        };
+        
+        setLatencySamples(host->getLatencySamples());
+        
+        {
+            const juce::ScopedLock sl(innerMutex);
+            outOfProcessHost = std::move(host);
+        }
+        
+        setHostedPluginPath(pluginPath);
+        setHostedPluginName(pluginDescription.manufacturerName + " - " + pluginDescription.name + " (out of process)");
+        
+        const auto report = loadProfiler.finish(getHostedPluginName());
+        {
+            const juce::ScopedLock sl(innerMutex);
+            lastLoadReport = report;
+        }
+        
+        setIsLoading(false);
+        sendChangeMessage();
+    };
+    
+    loadScheduler->requestDescription(this, pluginPath, [this]() { return getLoadPriority(); }, onDescribed);
+}
+
+void VST3LoaderAudioProcessor::setOutOfProcessMode(bool shouldRunOutOfProcess)
+{
+    const juce::ScopedLock sl(innerMutex);
+    outOfProcessMode = shouldRunOutOfProcess;
+}
+
+bool VST3LoaderAudioProcessor::isOutOfProcessMode()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return outOfProcessMode;
+}
+
+void VST3LoaderAudioProcessor::setMultiMonoMode(bool shouldUseMultiMono)
+{
+    const juce::ScopedLock sl(innerMutex);
+    multiMonoMode = shouldUseMultiMono;
+}
+
+bool VST3LoaderAudioProcessor::isMultiMonoMode()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return multiMonoMode;
+}
+
+void VST3LoaderAudioProcessor::setMultiMonoParametersLinked(bool shouldLink)
+{
+    const juce::ScopedLock sl(innerMutex);
+    multiMonoParametersLinked = shouldLink;
+    if (multiMonoHost != nullptr) { multiMonoHost->setParametersLinked(shouldLink); }
+}
+
+bool VST3LoaderAudioProcessor::areMultiMonoParametersLinked()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return multiMonoParametersLinked;
+}
+
+void VST3LoaderAudioProcessor::setAutoSleepEnabled(bool shouldBeEnabled)
+{
+    autoSleep.setEnabled(shouldBeEnabled);
+}
+
+bool VST3LoaderAudioProcessor::isAutoSleepEnabled() const
+{
+    return autoSleep.isEnabled();
+}
+
+juce::int64 VST3LoaderAudioProcessor::getNumSkippedBlocks() const
+{
+    return autoSleep.getNumSkippedBlocks();
+}
+
+void VST3LoaderAudioProcessor::setRenderAheadBlocks(int numBlocks)
+{
+    const juce::ScopedLock sl(innerMutex);
+    renderAheadBlocks = juce::jlimit(0, AnticipativeRenderer::maxBlocksAhead, numBlocks);
+}
+
+int VST3LoaderAudioProcessor::getRenderAheadBlocks()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return renderAheadBlocks;
+}
+
+void VST3LoaderAudioProcessor::setResetOnRepeatedFaults(bool shouldReset)
+{
+    outputSanitizer.setResetOnRepeatedFaults(shouldReset);
+}
+
+bool VST3LoaderAudioProcessor::isResetOnRepeatedFaults() const
+{
+    return outputSanitizer.isResetOnRepeatedFaults();
+}
+
+void VST3LoaderAudioProcessor::setReducedRateMode(bool shouldReduceRate)
+{
+    const juce::ScopedLock sl(innerMutex);
+    reducedRateMode = shouldReduceRate;
+}
+
+bool VST3LoaderAudioProcessor::isReducedRateMode()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return reducedRateMode;
+}
+
+juce::int64 VST3LoaderAudioProcessor::getNumOutputFaults() const
+{
+    return outputSanitizer.getNumIncidents();
+}
+
+void VST3LoaderAudioProcessor::setMaxConsecutiveOverruns(int numOverruns)
+{
+    deadlineWatchdog.setMaxConsecutiveOverruns(numOverruns);
+}
+
+int VST3LoaderAudioProcessor::getMaxConsecutiveOverruns() const
+{
+    return deadlineWatchdog.getMaxConsecutiveOverruns();
+}
+
+juce::String VST3LoaderAudioProcessor::getWatchdogWarning() const
+{
+    return deadlineWatchdog.getWarningText();
+}
+
+void VST3LoaderAudioProcessor::setBatchGroup(const juce::String& groupId)
+{
+    const juce::ScopedLock sl(innerMutex);
+    batchGroupId = groupId;
+}
+
+juce::String VST3LoaderAudioProcessor::getBatchGroup()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return batchGroupId;
+}
+
+juce::String VST3LoaderAudioProcessor::getBatchStatus()
+{
+    const juce::ScopedLock sl(innerMutex);
+    if (batchGroupId.isEmpty()) { return "off"; }
+    if (batchMember != nullptr) { return batchMember->getStatus(); }
+    return batchGroupError.isNotEmpty() ? batchGroupError : "not linked";
+}
+
+void VST3LoaderAudioProcessor::joinBatchGroupIfNeeded()
+{
+    leaveBatchGroup();
+    
+    juce::String groupId;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        batchGroupError = {};
+        
+        // 다른 실행 방식은 각자 자기 인스턴스를 따로 돌리므로 함께 쓰지 않음
+        if (batchGroupId.isEmpty() || hostedPluginInstance == nullptr || outOfProcessHost != nullptr
+            || multiMonoMode || renderAheadBlocks > 0 || rateConverter.isActive() || getBlockSize() <= 0)
+        {
+            return;
+        }
+        
+        groupId = batchGroupId;
+    }
+    
+    // 공유 인스턴스를 만드는 동안 오디오 스레드가 기다리지 않도록 innerMutex 밖에서 들어감
+    // (hostedPluginInstance 는 메시지 스레드에서만 바뀜)
+    juce::String error;
+    auto member = batchEngine->join(groupId, *hostedPluginInstance, getMainBusNumOutputChannels(),
+                                    getSampleRate(), getBlockSize(), error);
+    
+    if (member != nullptr)
+    {
+        setLatencySamples(member->getLatencySamples());
+    }
+    
+    const juce::ScopedLock sl(innerMutex);
+    batchMember = std::move(member);
+    batchGroupError = error;
+}
+
+void VST3LoaderAudioProcessor::leaveBatchGroup()
+{
+    std::shared_ptr<SharedBatchEngine::Member> previousMember;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        previousMember = std::move(batchMember);
+    }
+    
+    batchEngine->leave(std::move(previousMember));
+}
+
+void VST3LoaderAudioProcessor::startMidiLearn()
+{
+    midiLearn.startLearning();
+}
+
+void VST3LoaderAudioProcessor::cancelMidiLearn()
+{
+    midiLearn.cancelLearning();
+}
+
+bool VST3LoaderAudioProcessor::isMidiLearning() const
+{
+    return midiLearn.isLearning();
+}
+
+juce::String VST3LoaderAudioProcessor::getMidiLearnStatus() const
+{
+    return midiLearn.getLearnStatus();
+}
+
+std::vector<MidiLearn::Mapping> VST3LoaderAudioProcessor::getMidiMappings() const
+{
+    return midiLearn.getMappings();
+}
+
+void VST3LoaderAudioProcessor::removeMidiMapping(int index)
+{
+    midiLearn.removeMapping(index);
+}
+
+void VST3LoaderAudioProcessor::clearMidiMappings()
+{
+    midiLearn.clearMappings();
+}
+
+void VST3LoaderAudioProcessor::setWarmPoolEnabled(bool shouldBeEnabled)
+{
+    warmInstancePool->setEnabled(shouldBeEnabled);
+}
+
+bool VST3LoaderAudioProcessor::isWarmPoolEnabled() const
+{
+    return warmInstancePool->isEnabled();
+}
+
+juce::String VST3LoaderAudioProcessor::getWarmPoolStatus() const
+{
+    return warmInstancePool->getStatusText();
+}
+
+std::vector<StateHistory::StepInfo> VST3LoaderAudioProcessor::getStateHistorySteps() const
+{
+    return stateHistory.getSteps();
+}
+
+bool VST3LoaderAudioProcessor::restoreStateHistoryStep(int index)
+{
+    juce::MemoryBlock state;
+    if (!stateHistory.getStepState(index, state)) { return false; }
+    
+    return safelyPerform<bool>([&state](auto& p)
+    {
+        p->setStateInformation(state.getData(), (int) state.getSize());
+        return true;
+    });
+}
+
+bool VST3LoaderAudioProcessor::hasRecoverableState() const
+{
+    return stateHistory.hasRecoverableState();
+}
+
+void VST3LoaderAudioProcessor::recoverState()
+{
+    juce::String pluginPath;
+    juce::MemoryBlock state;
+    if (isCurrentlyLoading() || !stateHistory.takeRecoverableState(pluginPath, state)) { return; }
+    
+    // 복구한 상태로 플러그인을 다시 로드 (로드가 끝나면 hostedPluginState 가 적용됨)
+    {
+        const juce::ScopedLock sl(innerMutex);
+        hostedPluginState = state;
+    }
+    
+    loadPlugin(pluginPath);
+}
+
+bool VST3LoaderAudioProcessor::startSessionCapture()
+{
+    if (!isHostedPluginLoaded()) { return false; }
+    
+    SessionCapture::Header header;
+    header.sampleRate = getSampleRate();
+    header.maxBlockSize = getBlockSize();
+    header.numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+    header.pluginPath = getHostedPluginPath();
+    getHostedPluginInnerState(header.initialState);
+    
+    const auto name = juce::File::createLegalFileName(getHostedPluginName());
+    const auto file = SessionCapture::getCaptureDirectory()
+                          .getNonexistentChildFile(name + " " + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"),
+                                                   ".vlcap", false);
+    return sessionCapture.start(file, header);
+}
+
+void VST3LoaderAudioProcessor::stopSessionCapture()
+{
+    sessionCapture.stop();
+}
+
+bool VST3LoaderAudioProcessor::isCapturingSession() const
+{
+    return sessionCapture.isCapturing();
+}
+
+juce::File VST3LoaderAudioProcessor::getSessionCaptureFile() const
+{
+    return sessionCapture.getFile();
+}
+
+juce::String VST3LoaderAudioProcessor::getSessionCaptureStatus() const
+{
+    auto status = juce::String(sessionCapture.getNumCapturedBlocks()) + " blocks";
+    
+    const auto numDropped = sessionCapture.getNumDroppedBlocks();
+    if (numDropped > 0)
+    {
+        status = status + ", " + juce::String(numDropped) + " dropped";
+    }
+    
+    return status;
+}
+
+RealtimeSafetyMonitor::Report VST3LoaderAudioProcessor::getRealtimeSafetyReport() const
+{
+    return realtimeSafetyMonitor.getReport();
+}
+
+void VST3LoaderAudioProcessor::setEditorShowing(bool isShowing)
+{
+    isEditorShowing.store(isShowing);
+    if (isShowing) { hibernation.requestWakeUp(); }
+}
+
+juce::String VST3LoaderAudioProcessor::getLoadProgressText() const
+{
+    return loadScheduler->getProgressText();
+}
+
+void VST3LoaderAudioProcessor::setHibernationBudgetMegabytes(int megabytes)
+{
+    hibernationManager->setMemoryBudgetBytes((juce::int64) megabytes * 1024 * 1024);
+}
+
+int VST3LoaderAudioProcessor::getHibernationBudgetMegabytes() const
+{
+    return (int) (hibernationManager->getMemoryBudgetBytes() / (1024 * 1024));
+}
+
+void VST3LoaderAudioProcessor::setHibernationAllowed(bool shouldAllow)
+{
+    hibernation.setAllowed(shouldAllow);
+    if (!shouldAllow) { hibernation.requestWakeUp(); }
+}
+
+bool VST3LoaderAudioProcessor::isHibernationAllowed() const
+{
+    return hibernation.isAllowed();
+}
+
+bool VST3LoaderAudioProcessor::isHibernating() const
+{
+    return hibernation.isHibernating();
+}
+
+juce::String VST3LoaderAudioProcessor::getHibernationStatus() const
+{
+    return hibernation.getStatusText();
+}
+
+juce::String VST3LoaderAudioProcessor::getHibernationManagerStatus() const
+{
+    return hibernationManager->getStatusText();
+}
+
+bool VST3LoaderAudioProcessor::canHibernateHostedPlugin()
+{
+    // 에디터가 보이거나 바운스 또는 세션 기록 중이면 재우지 않음
+    if (isEditorShowing.load() || isNonRealtime() || isCapturingSession()) { return false; }
+    
+    // 다른 트랙과 나눠 쓰는 인스턴스, 자식 프로세스의 인스턴스는 이 래퍼만 쉰다고 내려놓을 수 없음
+    {
+        const juce::ScopedLock sl(innerMutex);
+        if (isLoading || outOfProcessHost != nullptr || batchMember != nullptr) { return false; }
+    }
+    
+    // 숨겨진 래퍼 창이 호스팅 에디터를 들고 있으면 인스턴스를 지울 수 없음
+    return safelyPerform<bool>([](auto& p) { return p->getActiveEditor() == nullptr; });
+}
+
+bool VST3LoaderAudioProcessor::hibernateHostedPlugin()
+{
+    if (!canHibernateHostedPlugin()) { return false; }
+    
+    juce::MemoryBlock innerState;
+    if (!getHostedPluginInnerState(innerState)) { return false; }
+    
+    PluginCostDatabase::Entry entry;
+    const auto savedBytes = costDatabase->getEntry(getHostedPluginPath(), entry) ? entry.residentBytes : (juce::int64) 0;
+    
+    {
+        const juce::ScopedLock sl(innerMutex);
+        hibernatedState = innerState;
+    }
+    
+    // 상태를 넘겨둔 뒤 재운 것으로 표시하므로 그 사이에 호스트가 저장해도 빈 상태를 받지 않음
+    // 경로와 이름은 그대로 두고, 알린 지연도 바꾸지 않아서 깨어난 뒤에도 호스트의 지연 보정이 그대로임
+    hibernation.setHibernating(juce::jmax((juce::int64) 0, savedBytes));
+    releaseHostedPlugin();
+    costMeter.setPlugin({});
+    
+    sendChangeMessage();
+    return true;
+}
+
+void VST3LoaderAudioProcessor::wakeHostedPlugin()
+{
+    if (isCurrentlyLoading()) { return; }
+    
+    juce::String pluginPath;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        pluginPath = hostedPluginPath;
+        hostedPluginState = hibernatedState;
+    }
+    
+    // 활동이 있어서 깨우는 것이므로 세션을 여는 중인 다른 인스턴스보다 먼저 로드
+    // 같은 플러그인을 다시 올리는 것이므로 웜 풀에서 가져가거나 사용 기록을 남기지 않음
+    hasInputWhileLoading.store(true);
+    setIsLoading(true);
+    sendChangeMessage();
+    
+    loadPluginFromFile(pluginPath, [this, pluginPath](auto pluginInstance)
+    {
+        finishWakingPlugin(pluginPath, std::move(pluginInstance));
+    }, false);
+}
+
+void VST3LoaderAudioProcessor::finishWakingPlugin(const juce::String& pluginPath,
+                                                  std::unique_ptr<juce::AudioPluginInstance> pluginInstance)
+{
+    // 새로 로드할 때와 달리 상태 기록은 이어서 쓰고, 경로와 이름, 알린 지연은 재우기 전 그대로 둠
+    auto successfullyConfigured = pluginInstance != nullptr;
+    
+    if (successfullyConfigured)
+    {
+        const auto desc = pluginInstance->getPluginDescription();
+        const auto pluginName = desc.manufacturerName + " - " + desc.name;
+        
+        setHostedPluginInstance(std::move(pluginInstance));
+        
+        {
+            const LoadProfiler::ScopedPhase phase(loadProfiler, LoadProfiler::layout);
+            successfullyConfigured &= setHostedPluginLayout();
+        }
+        
+        {
+            const LoadProfiler::ScopedPhase phase(loadProfiler, LoadProfiler::prepare);
+            successfullyConfigured &= prepareHostedPluginForPlaying();
+        }
+        
+        {
+            const LoadProfiler::ScopedPhase phase(loadProfiler, LoadProfiler::restoreState);
+            setHostedPluginState();
+        }
+        
+        if (successfullyConfigured)
+        {
+            updateAutoSleep();
+            rebuildMultiMonoHost();
+            rebuildAnticipativeRenderer();
+            joinBatchGroupIfNeeded();
+            
+            const auto report = loadProfiler.finish(pluginName);
+            costDatabase->recordLoad(pluginPath, pluginName, report.getTotalMilliseconds(), report.residentBytesDelta);
+            costMeter.setPlugin(pluginPath);
+            hibernation.noteLoadFinished(true);
+            
+            const juce::ScopedLock sl(innerMutex);
+            lastLoadReport = report;
+            hibernatedState = juce::MemoryBlock();
+        }
+        else
+        {
+            releaseHostedPlugin();
+        }
+    }
+    
+    // 실패하면 받아둔 상태와 경로를 그대로 두고 재운 채로 남아서, 다음 활동 때 다시 깨우거나 호스트가 그 상태를 저장함
+    if (!successfullyConfigured)
+    {
+        {
+            const juce::ScopedLock sl(innerMutex);
+            hostedPluginState = juce::MemoryBlock();
+        }
+        
+        hibernation.noteLoadFinished(false);
+    }
+    
+    setIsLoading(false);
+    juce::MessageManager::callAsync([this]() { sendChangeMessage(); });
+}
+
+int VST3LoaderAudioProcessor::getLoadPriority() const
+{
+    // 보이는 에디터 > 입력이 들어오는 트랙(녹음 대기, 모니터링) > 나머지
+    if (isEditorShowing.load()) { return 2; }
+    return hasInputWhileLoading.load() ? 1 : 0;
+}
+
+int VST3LoaderAudioProcessor::getRendererLatencySamples()
+{
+    const juce::ScopedLock sl(rendererMutex);
+    return anticipativeRenderer == nullptr ? 0 : anticipativeRenderer->getLatencySamples();
+}
+
+void VST3LoaderAudioProcessor::rebuildAnticipativeRenderer()
+{
+    std::unique_ptr<AnticipativeRenderer> previousRenderer;
+    {
+        const juce::ScopedLock sl(rendererMutex);
+        previousRenderer = std::move(anticipativeRenderer);
+    }
+    previousRenderer.reset();
+    
+    const auto numBlocks = getRenderAheadBlocks();
+    const auto pluginLatency = getHostedLatencySamples();
+    
+    if (numBlocks > 0 && isHostedPluginLoaded())
+    {
+        auto renderer = std::make_unique<AnticipativeRenderer>([this](auto& buffer, auto& midiMessages,
+                                                                      bool isActive, auto* playHead)
+        {
+            // 슬롯에 찍어둔 위치를 읽음 (렌더러를 바꾸는 동안 오디오 스레드와 함께 쓰지 않도록 innerMutex 안에서)
+            // 메시지 스레드가 innerMutex 를 잡은 채 이 렌더러를 멈출 수 있으므로 기다리지 않고, 잡지 못한 블록은 늦은 블록처럼 무음으로 냄
+            const juce::ScopedTryLock sl(innerMutex);
+            if (!sl.isLocked())
+            {
+                buffer.clear();
+                midiMessages.clear();
+                return;
+            }
+            
+            hostedPlayHead.capture(playHead);
+            processHostedPlugin(buffer, midiMessages, isActive);
+        });
+        
+        renderer->prepare(getSampleRate(), getBlockSize(),
+                          juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()), numBlocks);
+        
+        const juce::ScopedLock sl(rendererMutex);
+        anticipativeRenderer = std::move(renderer);
+    }
+    
+    setLatencySamples(pluginLatency + getRendererLatencySamples());
+}
+
+void VST3LoaderAudioProcessor::updateAutoSleep()
+{
+    safelyPerform<void>([this](auto& p)
+    {
+        // MIDI 를 받는 플러그인은 무음 입력에서도 소리를 낼 수 있으므로 제외 (테일은 여기서 한 번만 읽어둠)
+        const auto canSleep = !p->acceptsMidi() && !p->producesMidi();
+        autoSleep.prepare(getSampleRate(), p->getTailLengthSeconds(), getHostedLatencySamples(), canSleep);
+    });
+}
+
+void VST3LoaderAudioProcessor::rebuildMultiMonoHost()
+{
+    std::unique_ptr<MultiMonoHost> previousHost;
+    juce::AudioPluginInstance* primary = nullptr;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        previousHost = std::move(multiMonoHost);
+        if (multiMonoMode && outOfProcessHost == nullptr) { primary = hostedPluginInstance.get(); }
+    }
+    previousHost.reset();
+    
+    if (primary == nullptr) { return; }
     
-    loadPluginFromFile(pluginPath, std::move(callback));
+    // 채널 인스턴스 생성과 준비는 락 밖에서 하고 다 되면 교체
+    auto host = std::make_unique<MultiMonoHost>(formatManager, *primary);
+    host->setParametersLinked(areMultiMonoParametersLinked());
+    host->prepare(getSampleRate(), getBlockSize());
+    
+    juce::String error;
+    if (!host->setNumChannels(getMainBusNumOutputChannels(), error))
+    {
+        setHostedPluginLoadingError(error);
+        return;
+    }
+    
+    const juce::ScopedLock sl(innerMutex);
+    if (hostedPluginInstance.get() == primary)
+    {
+        multiMonoHost = std::move(host);
+    }
 }
 
 void VST3LoaderAudioProcessor::closeHostedPlugin()
@@ -160,6 +1266,19 @@ void VST3LoaderAudioProcessor::closeHostedPlugin()
     removePreviouslyHostedPluginIfNeeded(true);
 }
 
+void VST3LoaderAudioProcessor::reloadHostedPlugin()
+{
+    if (isCurrentlyLoading()) { return; }
+    
+    juce::MemoryBlock state;
+    getStateInformation(state);
+    
+    if (!state.isEmpty())
+    {
+        setStateInformation(state.getData(), (int) state.getSize());
+    }
+}
+
 juce::String VST3LoaderAudioProcessor::getHostedPluginLoadingError()
 {
     const juce::ScopedLock sl(innerMutex);
@@ -172,6 +1291,12 @@ juce::String VST3LoaderAudioProcessor::getHostedPluginName()
     return hostedPluginName;
 }
 
+LoadProfiler::Report VST3LoaderAudioProcessor::getLastLoadReport()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return lastLoadReport.pluginPath == hostedPluginPath ? lastLoadReport : LoadProfiler::Report();
+}
+
 juce::AudioProcessorEditor* VST3LoaderAudioProcessor::createHostedPluginEditorIfNeeded()
 {
     return safelyPerform<juce::AudioProcessorEditor*>([](auto& p)
@@ -185,6 +1310,19 @@ juce::AudioProcessorEditor* VST3LoaderAudioProcessor::createHostedPluginEditorIf
     });
 }
 
+void VST3LoaderAudioProcessor::setLastHostedEditorBounds(int width, int height)
+{
+    const juce::ScopedLock sl(innerMutex);
+    lastHostedEditorBounds = { width, height };
+    lastHostedEditorPath = hostedPluginPath;
+}
+
+juce::Rectangle<int> VST3LoaderAudioProcessor::getLastHostedEditorBounds()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return lastHostedEditorPath == hostedPluginPath ? lastHostedEditorBounds : juce::Rectangle<int>();
+}
+
 void VST3LoaderAudioProcessor::setIsLoading(bool value)
 {
     const juce::ScopedLock sl(innerMutex);
@@ -193,12 +1331,30 @@ void VST3LoaderAudioProcessor::setIsLoading(bool value)
 
 void VST3LoaderAudioProcessor::setHostedPluginInstance(std::unique_ptr<juce::AudioPluginInstance> pluginInstance)
 {
-    const juce::ScopedLock sl(innerMutex);
-    hostedPluginInstance.reset();
-    if (pluginInstance != nullptr)
+    std::unique_ptr<juce::AudioPluginInstance> previousInstance;
     {
-        hostedPluginInstance = std::move(pluginInstance);
+        const juce::ScopedLock instanceSl(hostedInstanceMutex);
+        const juce::ScopedLock sl(innerMutex);
+        if (hostedPluginInstance != nullptr) { stateHistory.detach(*hostedPluginInstance); }
+        
+        // 오디오 스레드가 다음 블록부터 새 표를 쓰도록 인스턴스를 떼어내기 전에 파라미터 연결을 바꿈
+        midiLearn.setInstance(pluginInstance.get());
+        previousInstance = std::move(hostedPluginInstance);
+        hostedPluginIsInstrument = false;
+        if (pluginInstance != nullptr)
+        {
+            hostedPluginIsInstrument = pluginInstance->getPluginDescription().isInstrument;
+            hostedPluginInstance = std::move(pluginInstance);
+            hostedPluginInstance->setNonRealtime(isNonRealtime());
+            hostedPluginInstance->setPlayHead(&hostedPlayHead);
+            stateHistory.attach(*hostedPluginInstance);
+        }
     }
+    
+    // 큰 플러그인은 지우는 데 수백 ms 가 걸리므로 락을 놓은 뒤 회수기에 넘김
+    // 래퍼보다 늦게 지워질 수 있으므로 래퍼의 플레이헤드를 떼어둠
+    if (previousInstance != nullptr) { previousInstance->setPlayHead(nullptr); }
+    instanceReclaimer->reclaim(std::move(previousInstance));
 }
 
 void VST3LoaderAudioProcessor::setHostedPluginLoadingError(juce::String value)
@@ -227,72 +1383,99 @@ juce::String VST3LoaderAudioProcessor::getHostedPluginPath()
 
 void VST3LoaderAudioProcessor::removePreviouslyHostedPluginIfNeeded(bool unsetError)
 {
-    safelyPerform<void>([](auto& p)
+    releaseHostedPlugin();
+    
+    // 재워둔 플러그인도 다른 플러그인을 로드하거나 닫으면 받아둔 상태와 함께 버림
+    hibernation.cancel();
     {
-        jassert(p->getActiveEditor() == nullptr);
-    });
+        const juce::ScopedLock sl(innerMutex);
+        hibernatedState = juce::MemoryBlock();
+    }
     
-    setHostedPluginInstance(nullptr);
+    // 다른 플러그인의 블록이 같은 기록에 섞이지 않게 함
+    sessionCapture.stop();
+    costMeter.setPlugin({});
+    stateHistory.clear({});
     setHostedPluginPath("");
     if (unsetError) { setHostedPluginLoadingError(""); }
     setIsLoading(false);
     setHostedPluginName("");
 }
 
+void VST3LoaderAudioProcessor::releaseHostedPlugin()
+{
+    safelyPerform<void>([](auto& p)
+    {
+        jassert(p->getActiveEditor() == nullptr);
+    });
+    
+    std::unique_ptr<AnticipativeRenderer> previousRenderer;
+    {
+        const juce::ScopedLock sl(rendererMutex);
+        previousRenderer = std::move(anticipativeRenderer);
+    }
+    previousRenderer.reset();
+    
+    std::unique_ptr<MultiMonoHost> previousMultiMonoHost;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        previousMultiMonoHost = std::move(multiMonoHost);
+    }
+    
+    // 채널 인스턴스 쪽이 기본 인스턴스의 리스너이므로 기본 인스턴스보다 먼저 넘김 (넘긴 순서대로 지움)
+    instanceReclaimer->reclaim(std::move(previousMultiMonoHost));
+    
+    // 멤버가 호스팅 인스턴스의 파라미터 변경을 듣고 있으므로 인스턴스보다 먼저 그룹에서 나감
+    leaveBatchGroup();
+    setHostedPluginInstance(nullptr);
+    
+    std::shared_ptr<OutOfProcessHost> previousHost;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        previousHost = std::move(outOfProcessHost);
+    }
+    previousHost.reset();
+}
+
 void VST3LoaderAudioProcessor::loadPluginFromFile(const juce::String& pluginPath,
-                                                  PluginLoadingCallback vst3FileLoadingCompleted)
+                                                  PluginLoadingCallback vst3FileLoadingCompleted,
+                                                  bool useWarmPool)
 {
-    juce::MessageManager::callAsync([this, pluginPath, vst3FileLoadingCompleted]()
+    auto onDescribed = [this, pluginPath, vst3FileLoadingCompleted, useWarmPool](bool foundDescription,
+                                                                    const juce::PluginDescription& pluginDescription,
+                                                                    const juce::String& descriptionError,
+                                                                    double describeMilliseconds)
     {
-        juce::OwnedArray<juce::PluginDescription> descs;
-        
-        juce::AudioPluginFormat* vst3Format = nullptr;
-        for (int i = 0; i < formatManager.getNumFormats(); ++i)
-        {
-            if (formatManager.getFormat(i)->getName() == "VST3")
-            {
-                vst3Format = formatManager.getFormat(i);
-                break;
-            }
-        }
+        loadProfiler.start(pluginPath);
+        loadProfiler.addPhaseMilliseconds(LoadProfiler::describe, describeMilliseconds);
         
-        if (vst3Format == nullptr)
+        if (!foundDescription)
         {
-            setHostedPluginLoadingError(juce::String(juce::CharPointer_UTF8("VST3 format not found")));
+            setHostedPluginLoadingError(descriptionError);
             vst3FileLoadingCompleted(nullptr);
             return;
         }
         
-        vst3Format->findAllTypesForFile(descs, pluginPath);
-        
-        if (descs.isEmpty())
-        {
-            setHostedPluginLoadingError(juce::String(juce::CharPointer_UTF8("No valid VST3 found")));
-            vst3FileLoadingCompleted(nullptr);
-            return;
-        }
+        const auto sampleRate = getSampleRate();
+        const auto blockSize = getBlockSize();
         
-        auto descIndex = -1;
-        for (int i = 0; i < descs.size(); ++i)
+        // 풀에 미리 만들어둔 인스턴스가 있으면 생성 단계를 건너뜀
+        if (useWarmPool)
         {
-            if (!descs[i]->isInstrument)
+            auto warmInstance = warmInstancePool->take(pluginDescription);
+            warmInstancePool->noteLoaded(pluginDescription, sampleRate, blockSize);
+            
+            if (warmInstance != nullptr)
             {
-                descIndex = i;
-                break;
+                vst3FileLoadingCompleted(std::move(warmInstance));
+                return;
             }
         }
         
-        if (descIndex == -1)
-        {
-            setHostedPluginLoadingError(juce::String(juce::CharPointer_UTF8("Selected VST3 is not an Audio Effect")));
-            vst3FileLoadingCompleted(nullptr);
-            return;
-        }
-        
-        const auto pluginDescription = *descs[descIndex];
-        
         auto callback = [this, vst3FileLoadingCompleted](auto pluginInstance, const auto& errorMessage)
         {
+            loadProfiler.endPhase();
+            
             if (pluginInstance == nullptr)
             {
                 juce::String errorMsg = errorMessage.isEmpty() ?
@@ -305,32 +1488,226 @@ void VST3LoaderAudioProcessor::loadPluginFromFile(const juce::String& pluginPath
             vst3FileLoadingCompleted(std::move(pluginInstance));
         };
         
+        loadProfiler.beginPhase(LoadProfiler::instantiate);
         formatManager.createPluginInstanceAsync(pluginDescription,
-                                               getSampleRate(),
-                                               getBlockSize(),
+                                               sampleRate,
+                                               blockSize,
                                                callback);
-    });
+    };
+    
+    loadScheduler->requestDescription(this, pluginPath, [this]() { return getLoadPriority(); }, onDescribed);
+}
+
+bool VST3LoaderAudioProcessor::findHostablePluginDescription(juce::AudioPluginFormatManager& manager,
+                                                             const juce::String& pluginPath,
+                                                             juce::PluginDescription& result,
+                                                             juce::String& error)
+{
+    juce::OwnedArray<juce::PluginDescription> descs;
+    
+    juce::AudioPluginFormat* vst3Format = nullptr;
+    for (int i = 0; i < manager.getNumFormats(); ++i)
+    {
+        if (manager.getFormat(i)->getName() == "VST3")
+        {
+            vst3Format = manager.getFormat(i);
+            break;
+        }
+    }
+    
+    if (vst3Format == nullptr)
+    {
+        error = juce::String(juce::CharPointer_UTF8("VST3 format not found"));
+        return false;
+    }
+    
+    {
+        // JUCE 의 VST3 모듈 로드는 스레드 안전하지 않으므로 스케줄러와 일괄 렌더러가 동시에 스캔하지 않게 함
+        static juce::CriticalSection moduleLoadingLock;
+        const juce::ScopedLock sl(moduleLoadingLock);
+        vst3Format->findAllTypesForFile(descs, pluginPath);
+    }
+    
+    if (descs.isEmpty())
+    {
+        error = juce::String(juce::CharPointer_UTF8("No valid VST3 found"));
+        return false;
+    }
+    
+    // 한 번들에 이펙트와 악기가 같이 있으면 타깃 종류와 같은 쪽을 우선함
+    for (const auto wantsInstrument : { VST3LOADER_INSTRUMENT != 0, VST3LOADER_INSTRUMENT == 0 })
+    {
+        for (auto* desc : descs)
+        {
+            if (desc->isInstrument == wantsInstrument)
+            {
+                result = *desc;
+                return true;
+            }
+        }
+    }
+    
+    error = juce::String(juce::CharPointer_UTF8("Selected VST3 is not an Audio Effect or Instrument"));
+    return false;
 }
 
 bool VST3LoaderAudioProcessor::setHostedPluginLayout()
 {
-    safelyPerform<void>([](auto& p) { p->enableAllBuses(); });
+    const juce::ScopedLock sl(innerMutex);
+    
+    if (isMultiMonoMode())
+    {
+        const auto supportsMono = safelyPerform<bool>([](auto& p) { return MultiMonoHost::setMonoLayout(*p); });
+        
+        if (!supportsMono)
+        {
+            setHostedPluginLoadingError("Plugin does not support a mono layout");
+            return false;
+        }
+        
+        updateHostedChannelMap();
+        return true;
+    }
+    
+    safelyPerform<void>([this](auto& p)
+    {
+        // 래퍼의 메인 입출력과 사이드체인을 그대로 요청해보고, 안 되면 스테레오, 그래도 안 되면 기존처럼 전체 버스 활성화
+        auto desired = p->getBusesLayout();
+        const auto wrapperLayout = getBusesLayout();
+        
+        if (!desired.inputBuses.isEmpty() && !wrapperLayout.inputBuses.isEmpty())
+            desired.inputBuses.getReference(0) = wrapperLayout.getMainInputChannelSet();
+        if (!desired.outputBuses.isEmpty())
+            desired.outputBuses.getReference(0) = wrapperLayout.getMainOutputChannelSet();
+        if (desired.inputBuses.size() > 1)
+            desired.inputBuses.getReference(1) = getChannelCountOfBus(true, 1) > 0 ? wrapperLayout.getChannelSet(true, 1)
+                                                                                    : juce::AudioChannelSet::disabled();
+        
+        // 악기는 메인 입력을 끄고, 보조 출력은 래퍼에서 켜진 버스만 같은 순서로 연결
+        if (hostedPluginIsInstrument)
+        {
+            if (!desired.inputBuses.isEmpty())
+                desired.inputBuses.getReference(0) = juce::AudioChannelSet::disabled();
+            
+            for (int bus = 1; bus < desired.outputBuses.size(); ++bus)
+            {
+                desired.outputBuses.getReference(bus) = bus < wrapperLayout.outputBuses.size() ? wrapperLayout.getChannelSet(false, bus)
+                                                                                                : juce::AudioChannelSet::disabled();
+            }
+        }
+        
+        if (p->checkBusesLayoutSupported(desired) && p->setBusesLayout(desired)) { return; }
+        
+        auto stereo = p->getBusesLayout();
+        if (!stereo.inputBuses.isEmpty()) { stereo.inputBuses.getReference(0) = juce::AudioChannelSet::stereo(); }
+        if (!stereo.outputBuses.isEmpty()) { stereo.outputBuses.getReference(0) = juce::AudioChannelSet::stereo(); }
+        
+        if (p->checkBusesLayoutSupported(stereo) && p->setBusesLayout(stereo)) { return; }
+        
+        p->enableAllBuses();
+    });
+    
+    updateHostedChannelMap();
+    prepareScratchBuffers(getBlockSize());
     return true;
 }
 
+void VST3LoaderAudioProcessor::updateHostedChannelMap()
+{
+    const juce::ScopedLock sl(innerMutex);
+    
+    hostedChannelMap.fill(-1);
+    numHostedChannels = 0;
+    hostedChannelMapIsIdentity = true;
+    
+    safelyPerform<void>([this](auto& p)
+    {
+        numHostedChannels = juce::jmin(maxHostedChannels, juce::jmax(p->getTotalNumInputChannels(),
+                                                                     p->getTotalNumOutputChannels()));
+        std::array<bool, maxHostedChannels> isWrapperChannelUsed {};
+        
+        for (const auto isInput : { true, false })
+        {
+            for (int bus = 0; bus < juce::jmin(p->getBusCount(isInput), getBusCount(isInput)); ++bus)
+            {
+                const auto numChannels = juce::jmin(p->getChannelCountOfBus(isInput, bus),
+                                                    getChannelCountOfBus(isInput, bus));
+                
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    const auto hostedIndex = p->getChannelIndexInProcessBlockBuffer(isInput, bus, ch);
+                    const auto wrapperIndex = getChannelIndexInProcessBlockBuffer(isInput, bus, ch);
+                    
+                    if (hostedIndex >= numHostedChannels || wrapperIndex >= maxHostedChannels) { continue; }
+                    if (hostedChannelMap[(size_t) hostedIndex] == wrapperIndex) { continue; }
+                    if (hostedChannelMap[(size_t) hostedIndex] >= 0 || isWrapperChannelUsed[(size_t) wrapperIndex]) { continue; }
+                    
+                    hostedChannelMap[(size_t) hostedIndex] = wrapperIndex;
+                    isWrapperChannelUsed[(size_t) wrapperIndex] = true;
+                }
+            }
+        }
+    });
+    
+    for (int i = 0; i < numHostedChannels; ++i)
+    {
+        hostedChannelMapIsIdentity &= hostedChannelMap[(size_t) i] == i;
+    }
+}
+
+void VST3LoaderAudioProcessor::prepareScratchBuffers(int blockSize)
+{
+    const juce::ScopedLock sl(innerMutex);
+    
+    if (hostedChannelMapIsIdentity || blockSize <= 0) { return; }
+    
+    floatScratchBuffer.setSize(numHostedChannels, blockSize, false, true, true);
+    doubleScratchBuffer.setSize(numHostedChannels, blockSize, false, true, true);
+}
+
 bool VST3LoaderAudioProcessor::prepareHostedPluginForPlaying()
 {
-    setLatencySamples(safelyPerform<int>([](auto& p) { return p->getLatencySamples(); }));
+    prepareRateConverter(getSampleRate(), getBlockSize());
     
     safelyPerform<void>([this](auto& p)
     {
-        p->setRateAndBufferSizeDetails(getSampleRate(), getBlockSize());
-        p->prepareToPlay(getSampleRate(), getBlockSize());
+        p->setRateAndBufferSizeDetails(rateConverter.getInternalSampleRate(), rateConverter.getMaxInternalBlockSize());
+        p->prepareToPlay(rateConverter.getInternalSampleRate(), rateConverter.getMaxInternalBlockSize());
     });
     
+    setLatencySamples(getHostedLatencySamples() + getRendererLatencySamples());
+    prepareDeadlineWatchdog();
     return true;
 }
 
+void VST3LoaderAudioProcessor::prepareRateConverter(double sampleRate, int samplesPerBlock)
+{
+    const juce::ScopedLock sl(innerMutex);
+    
+    // 멀티 모노 채널 인스턴스는 호스트 레이트로 준비되므로 함께 쓰지 않음
+    const auto factor = reducedRateMode && !multiMonoMode ? InternalRateConverter::getFactorForRate(sampleRate) : 1;
+    const auto numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels(), numHostedChannels);
+    rateConverter.prepare(sampleRate, juce::jmax(1, samplesPerBlock), numChannels, factor);
+    hostedPlayHead.prepare(sampleRate, factor);
+}
+
+int VST3LoaderAudioProcessor::getHostedLatencySamples()
+{
+    // 호스팅 플러그인의 지연은 내부 레이트 기준이므로 호스트 레이트로 바꿔서 더함
+    const juce::ScopedLock sl(innerMutex);
+    const auto pluginLatency = safelyPerform<int>([](auto& p) { return p->getLatencySamples(); });
+    return pluginLatency * rateConverter.getFactor() + (rateConverter.isActive() ? rateConverter.getLatencySamples() : 0);
+}
+
+void VST3LoaderAudioProcessor::prepareDeadlineWatchdog()
+{
+    // 우회할 때의 원음은 호스팅 플러그인과 같은 만큼 늦춤
+    const juce::ScopedLock sl(innerMutex);
+    deadlineWatchdog.prepare(getSampleRate(), getBlockSize(),
+                             juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()),
+                             getHostedLatencySamples());
+}
+
 void VST3LoaderAudioProcessor::setHostedPluginState()
 {
     const juce::ScopedLock sl(innerMutex);
@@ -349,45 +1726,187 @@ void VST3LoaderAudioProcessor::setHostedPluginState()
 
 void VST3LoaderAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    safelyPerform<void>([this, &destData](auto& p)
+    juce::MemoryBlock innerState;
+    if (!getHostedPluginInnerState(innerState)) { return; }
+    
+    juce::XmlElement xml("state");
+    
+    if (isOutOfProcessMode())
     {
-        juce::XmlElement xml("state");
-        
-        auto filePathElement = std::make_unique<juce::XmlElement>(pluginPathTag);
-        filePathElement->addTextElement(getHostedPluginPath());
-        xml.addChildElement(filePathElement.release());
-        
-        juce::MemoryBlock innerState;
-        p->getStateInformation(innerState);
-        auto stateNode = std::make_unique<juce::XmlElement>(innerStateTag);
-        stateNode->addTextElement(innerState.toBase64Encoding());
-        xml.addChildElement(stateNode.release());
-        
-        const auto text = xml.toString();
-        destData.replaceAll(text.toRawUTF8(), text.getNumBytesAsUTF8());
-    });
+        xml.setAttribute(outOfProcessTag, true);
+    }
+    
+    xml.setAttribute(autoSleepTag, isAutoSleepEnabled());
+    xml.setAttribute(resetOnFaultsTag, isResetOnRepeatedFaults());
+    xml.setAttribute(watchdogOverrunsTag, getMaxConsecutiveOverruns());
+    
+    if (isReducedRateMode())
+    {
+        xml.setAttribute(reducedRateTag, true);
+    }
+    
+    if (getBatchGroup().isNotEmpty())
+    {
+        xml.setAttribute(batchGroupTag, getBatchGroup());
+    }
+    
+    if (!isHibernationAllowed())
+    {
+        xml.setAttribute(neverHibernateTag, true);
+    }
+    
+    xml.setAttribute(instanceIdTag, stateHistory.getInstanceId());
+    
+    const auto editorBounds = getLastHostedEditorBounds();
+    if (!editorBounds.isEmpty())
+    {
+        xml.setAttribute(editorWidthTag, editorBounds.getWidth());
+        xml.setAttribute(editorHeightTag, editorBounds.getHeight());
+    }
+    
+    if (getRenderAheadBlocks() > 0)
+    {
+        xml.setAttribute(renderAheadTag, getRenderAheadBlocks());
+    }
+    
+    if (isMultiMonoMode())
+    {
+        xml.setAttribute(multiMonoTag, true);
+        xml.setAttribute(linkParametersTag, areMultiMonoParametersLinked());
+    }
+    
+    if (auto midiLearnXml = midiLearn.createXml())
+    {
+        xml.addChildElement(midiLearnXml.release());
+    }
+    
+    auto filePathElement = std::make_unique<juce::XmlElement>(pluginPathTag);
+    filePathElement->addTextElement(getHostedPluginPath());
+    xml.addChildElement(filePathElement.release());
+    
+    auto stateNode = std::make_unique<juce::XmlElement>(innerStateTag);
+    stateNode->addTextElement(innerState.toBase64Encoding());
+    xml.addChildElement(stateNode.release());
+    
+    const auto text = xml.toString();
+    destData.replaceAll(text.toRawUTF8(), text.getNumBytesAsUTF8());
+}
+
+bool VST3LoaderAudioProcessor::getHostedPluginInnerState(juce::MemoryBlock& innerState)
+{
+    // 재워둔 동안 (다시 로드해서 상태를 적용하기 전까지 포함) 은 내려놓기 전에 받아둔 상태를 돌려줌
+    if (hibernation.isHibernating())
+    {
+        const juce::ScopedLock sl(innerMutex);
+        innerState = hibernatedState;
+        return true;
+    }
+    
+    std::shared_ptr<OutOfProcessHost> host;
+    {
+        const juce::ScopedLock sl(innerMutex);
+        host = outOfProcessHost;
+    }
+    
+    // 자식 프로세스의 응답을 기다리는 동안 innerMutex 를 잡고 있지 않도록 함
+    if (host != nullptr)
+    {
+        return host->getState(innerState);
+    }
+    
+    // 인스턴스는 hostedInstanceMutex 와 innerMutex 를 둘 다 잡아야 바뀌므로 hostedInstanceMutex 만으로 살아 있음이 보장됨
+    const juce::ScopedLock sl(hostedInstanceMutex);
+    if (hostedPluginInstance == nullptr) { return false; }
+    
+    hostedPluginInstance->getStateInformation(innerState);
+    return true;
 }
 
 void VST3LoaderAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    const juce::ScopedLock sl(innerMutex);
+    juce::String pluginPath;
+    juce::MemoryBlock innerState;
     
-    auto xml = juce::XmlDocument::parse(juce::String(juce::CharPointer_UTF8(static_cast<const char*>(data)),
-                                                     (size_t) sizeInBytes));
+    auto xml = parseWrapperState(data, sizeInBytes, pluginPath, innerState);
+    if (xml == nullptr) { return; }
     
-    if (xml != nullptr)
+    // 래퍼 설정만 innerMutex 안에서 바꾸고, 로드는 락을 놓은 뒤에 함
+    // loadPlugin 은 hostedInstanceMutex 를 잡으므로 innerMutex 를 든 채 부르면 잠금 순서가 뒤집힘
     {
-        if (auto* pluginPathNode = xml->getChildByName(pluginPathTag))
+        const juce::ScopedLock sl(innerMutex);
+        outOfProcessMode = xml->getBoolAttribute(outOfProcessTag, false);
+        multiMonoMode = xml->getBoolAttribute(multiMonoTag, false);
+        multiMonoParametersLinked = xml->getBoolAttribute(linkParametersTag, true);
+        reducedRateMode = xml->getBoolAttribute(reducedRateTag, false);
+        batchGroupId = xml->getStringAttribute(batchGroupTag);
+        stateHistory.setInstanceId(xml->getStringAttribute(instanceIdTag));
+        autoSleep.setEnabled(xml->getBoolAttribute(autoSleepTag, false));
+        outputSanitizer.setResetOnRepeatedFaults(xml->getBoolAttribute(resetOnFaultsTag, false));
+        deadlineWatchdog.setMaxConsecutiveOverruns(xml->getIntAttribute(watchdogOverrunsTag, 0));
+        
+        hibernation.setAllowed(!xml->getBoolAttribute(neverHibernateTag, false));
+        
+        if (xml->hasAttribute(editorWidthTag) && xml->hasAttribute(editorHeightTag))
         {
-            auto pluginPath = pluginPathNode->getAllSubText();
-            juce::MemoryBlock innerState;
-            auto base64String = xml->getChildElementAllSubText(innerStateTag, {});
-            innerState.fromBase64Encoding(base64String);
-            hostedPluginState = innerState;
-            
-            loadPlugin(pluginPath);
+            lastHostedEditorBounds = { xml->getIntAttribute(editorWidthTag), xml->getIntAttribute(editorHeightTag) };
+            lastHostedEditorPath = pluginPath;
         }
+        renderAheadBlocks = juce::jlimit(0, AnticipativeRenderer::maxBlocksAhead, xml->getIntAttribute(renderAheadTag, 0));
+        midiLearn.restoreFromXml(xml->getChildByName(MidiLearn::xmlTag), pluginPath);
+        hostedPluginState = innerState;
     }
+    
+    loadPlugin(pluginPath);
+}
+
+std::unique_ptr<juce::XmlElement> VST3LoaderAudioProcessor::parseWrapperState(const void* data, int sizeInBytes,
+                                                                              juce::String& pluginPath,
+                                                                              juce::MemoryBlock& innerState)
+{
+    auto xml = juce::XmlDocument::parse(juce::String(juce::CharPointer_UTF8(static_cast<const char*>(data)),
+                                                     (size_t) sizeInBytes));
+    
+    if (xml == nullptr) { return nullptr; }
+    
+    auto* pluginPathNode = xml->getChildByName(pluginPathTag);
+    if (pluginPathNode == nullptr) { return nullptr; }
+    
+    pluginPath = pluginPathNode->getAllSubText();
+    innerState.reset();
+    innerState.fromBase64Encoding(xml->getChildElementAllSubText(innerStateTag, {}));
+    return xml;
+}
+
+void VST3LoaderAudioProcessor::startBatchRender(const juce::Array<juce::File>& inputFiles,
+                                                const juce::File& outputDirectory)
+{
+    if (isBatchRendering() || inputFiles.isEmpty()) { return; }
+    
+    BatchRenderer::Settings settings;
+    getStateInformation(settings.wrapperState);
+    settings.inputFiles = inputFiles;
+    settings.outputDirectory = outputDirectory;
+    
+    if (settings.wrapperState.isEmpty()) { return; }
+    
+    auto renderer = std::make_unique<BatchRenderer>(std::move(settings));
+    renderer->onFinished = [this]() { sendChangeMessage(); };
+    renderer->start();
+    
+    const juce::ScopedLock sl(innerMutex);
+    batchRenderer = std::move(renderer);
+}
+
+bool VST3LoaderAudioProcessor::isBatchRendering()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return batchRenderer != nullptr && batchRenderer->isRunning();
+}
+
+juce::String VST3LoaderAudioProcessor::getBatchRenderStatus()
+{
+    const juce::ScopedLock sl(innerMutex);
+    return batchRenderer == nullptr ? juce::String() : batchRenderer->getStatusText();
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
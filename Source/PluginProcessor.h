@@ -1,8 +1,34 @@
 #pragma once
 #include <JuceHeader.h>
+#include "BatchRenderer.h"
+#include "OutOfProcessHost.h"
+#include "MultiMonoHost.h"
+#include "AutoSleep.h"
+#include "AnticipativeRenderer.h"
+#include "OutputSanitizer.h"
+#include "LoadProfiler.h"
+#include "WarmInstancePool.h"
+#include "LoadScheduler.h"
+#include "RealtimeSafetyMonitor.h"
+#include "InternalRateConverter.h"
+#include "StateHistory.h"
+#include "DeadlineWatchdog.h"
+#include "SessionCapture.h"
+#include "SharedBatchEngine.h"
+#include "MidiLearn.h"
+#include "PluginCostDatabase.h"
+#include "InstanceReclaimer.h"
+#include "HibernationManager.h"
+#include "HostedPlayHead.h"
+
+// 악기 (aumu) 타깃은 Instrument/VST3 Loader Instrument.jucer 에서 1 로 정의해서 빌드함
+#ifndef VST3LOADER_INSTRUMENT
+ #define VST3LOADER_INSTRUMENT 0
+#endif
 
 class VST3LoaderAudioProcessor : public juce::AudioProcessor,
-                                  public juce::ChangeBroadcaster
+                                  public juce::ChangeBroadcaster,
+                                  private juce::AsyncUpdater
 {
 public:
     VST3LoaderAudioProcessor();
@@ -13,6 +39,7 @@ public:
     void reset() override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void setNonRealtime (bool isNonRealtime) noexcept override;
     
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -33,44 +60,243 @@ public:
     void setStateInformation (const void*, int) override;
     
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+    void processorLayoutsChanged() override;
     
     // Public API
     bool isHostedPluginLoaded();
+    bool isHostedPluginInstrument();
     bool isCurrentlyLoading();
     void loadPlugin(const juce::String& pluginPath);
+    void loadPluginInstance(std::unique_ptr<juce::AudioPluginInstance> pluginInstance);
     void closeHostedPlugin();
+    void reloadHostedPlugin();
     juce::String getHostedPluginLoadingError();
     juce::String getHostedPluginName();
+    juce::String getHostedPluginPath();
+    LoadProfiler::Report getLastLoadReport();
     juce::AudioProcessorEditor* createHostedPluginEditorIfNeeded();
     
+    // 래퍼 창을 바로 띄울 수 있도록 마지막 호스팅 에디터 크기를 기억
+    void setLastHostedEditorBounds(int width, int height);
+    juce::Rectangle<int> getLastHostedEditorBounds();
+    
+    void startBatchRender(const juce::Array<juce::File>& inputFiles, const juce::File& outputDirectory);
+    bool isBatchRendering();
+    juce::String getBatchRenderStatus();
+    
+    // 호스팅 플러그인을 자식 프로세스에서 실행 (다음 로드부터 적용)
+    void setOutOfProcessMode(bool shouldRunOutOfProcess);
+    bool isOutOfProcessMode();
+    
+    // 채널마다 모노 인스턴스를 하나씩 돌림 (다음 로드부터 적용)
+    void setMultiMonoMode(bool shouldUseMultiMono);
+    bool isMultiMonoMode();
+    void setMultiMonoParametersLinked(bool shouldLink);
+    bool areMultiMonoParametersLinked();
+    
+    // 입력이 무음이면 호스팅 플러그인 호출을 건너뜀
+    void setAutoSleepEnabled(bool shouldBeEnabled);
+    bool isAutoSleepEnabled() const;
+    juce::int64 getNumSkippedBlocks() const;
+    
+    // 호스팅 플러그인을 별도 스레드에서 지정한 블록 수만큼 앞서 처리 (0 이면 끔, 다음 로드부터 적용)
+    void setRenderAheadBlocks(int numBlocks);
+    int getRenderAheadBlocks();
+    
+    // 88.2 kHz 이상에서 호스팅 플러그인을 1/2 또는 1/4 내부 레이트로 돌림 (다음 로드부터 적용)
+    void setReducedRateMode(bool shouldReduceRate);
+    bool isReducedRateMode();
+    
+    // 출력의 NaN/Inf 는 항상 0 으로 바꾸고, 반복되면 호스팅 플러그인을 리셋할 수 있음
+    void setResetOnRepeatedFaults(bool shouldReset);
+    bool isResetOnRepeatedFaults() const;
+    juce::int64 getNumOutputFaults() const;
+    
+    // 블록 처리가 연속으로 마감 시간을 넘기면 지연을 맞춘 원음으로 우회했다가 나중에 다시 시험 (0 이면 끔)
+    void setMaxConsecutiveOverruns(int numOverruns);
+    int getMaxConsecutiveOverruns() const;
+    juce::String getWatchdogWarning() const;
+    
+    // 최근 로드한 플러그인을 미리 만들어두는 공용 풀 (모든 래퍼 인스턴스가 공유, 설정도 세션이 아니라 컴퓨터 단위로 저장)
+    void setWarmPoolEnabled(bool shouldBeEnabled);
+    bool isWarmPoolEnabled() const;
+    juce::String getWarmPoolStatus() const;
+    
+    // 세션을 열 때 에디터가 보이는 인스턴스부터 로드하도록 스케줄러에 알림
+    void setEditorShowing(bool isShowing);
+    juce::String getLoadProgressText() const;
+    
+    // 상주 메모리가 예산을 넘으면 오래 쉬는 인스턴스의 호스팅 플러그인을 상태만 남기고 내려놓음 (예산은 모든 래퍼 인스턴스가 공유, 0 이면 끔)
+    void setHibernationBudgetMegabytes(int megabytes);
+    int getHibernationBudgetMegabytes() const;
+    void setHibernationAllowed(bool shouldAllow);
+    bool isHibernationAllowed() const;
+    bool isHibernating() const;
+    juce::String getHibernationStatus() const;
+    juce::String getHibernationManagerStatus() const;
+    
+    // 호스팅 플러그인 상태의 변경 기록 (되돌리기)과 호스트가 죽었을 때의 복구
+    std::vector<StateHistory::StepInfo> getStateHistorySteps() const;
+    bool restoreStateHistoryStep(int index);
+    bool hasRecoverableState() const;
+    void recoverState();
+    
+    // 들어오는 블록을 파일로 기록해서 VST3LoaderHost --replay 로 같은 블록 경계 그대로 재현
+    bool startSessionCapture();
+    void stopSessionCapture();
+    bool isCapturingSession() const;
+    juce::File getSessionCaptureFile() const;
+    juce::String getSessionCaptureStatus() const;
+    
+    // 같은 그룹의 래퍼 인스턴스들이 호스팅 플러그인 하나를 넓은 채널 호출로 나눠 씀 (빈 문자열이면 끔, 다음 로드부터 적용)
+    void setBatchGroup(const juce::String& groupId);
+    juce::String getBatchGroup();
+    juce::String getBatchStatus();
+    
+    // MIDI 컨트롤러를 호스팅 플러그인 파라미터에 연결 (플러그인 컨트롤을 움직인 다음 컨트롤러를 움직임)
+    void startMidiLearn();
+    void cancelMidiLearn();
+    bool isMidiLearning() const;
+    juce::String getMidiLearnStatus() const;
+    std::vector<MidiLearn::Mapping> getMidiMappings() const;
+    void removeMidiMapping(int index);
+    void clearMidiMappings();
+    
+    // 오디오 스레드의 막힌 락, 할당 횟수와 최악 블록 시간
+    RealtimeSafetyMonitor::Report getRealtimeSafetyReport() const;
+    
+    static std::unique_ptr<juce::XmlElement> parseWrapperState(const void* data, int sizeInBytes,
+                                                               juce::String& pluginPath,
+                                                               juce::MemoryBlock& innerState);
+    static bool findHostablePluginDescription(juce::AudioPluginFormatManager& manager,
+                                              const juce::String& pluginPath,
+                                              juce::PluginDescription& result,
+                                              juce::String& error);
+                                              
 private:
     juce::CriticalSection innerMutex;
+    // 호스팅 인스턴스를 바꾸는 쪽과 상태를 읽는 쪽만 잡음 (오디오 스레드는 잡지 않음)
+    // 플러그인의 getStateInformation 이 오래 걸려도 innerMutex 를 잡고 있지 않도록 함
+    // 둘 다 잡을 때는 항상 hostedInstanceMutex 를 먼저 잡으므로 innerMutex 를 든 채 인스턴스를 바꾸면 안 됨
+    juce::CriticalSection hostedInstanceMutex;
     juce::AudioPluginFormatManager formatManager;
     std::unique_ptr<juce::AudioPluginInstance> hostedPluginInstance;
+    std::shared_ptr<OutOfProcessHost> outOfProcessHost;
+    bool isPreparingOutOfProcessHost = false; // innerMutex 로 보호, prepareToPlay 가 잠그지 않고 준비하는 동안 true
+    bool outOfProcessMode = false;
+    std::unique_ptr<MultiMonoHost> multiMonoHost;
+    bool multiMonoMode = false;
+    bool multiMonoParametersLinked = true;
+    AutoSleep autoSleep;
+    
+    // 오디오 스레드가 렌더 스레드와 innerMutex 를 두고 다투지 않도록 따로 보호
+    juce::CriticalSection rendererMutex;
+    std::unique_ptr<AnticipativeRenderer> anticipativeRenderer;
+    int renderAheadBlocks = 0;
+    OutputSanitizer outputSanitizer;
+    InternalRateConverter rateConverter;
+    bool reducedRateMode = false;
+    RealtimeSafetyMonitor realtimeSafetyMonitor;
+    DeadlineWatchdog deadlineWatchdog;
+    SessionCapture sessionCapture;
+    juce::SharedResourcePointer<SharedBatchEngine> batchEngine;
+    std::shared_ptr<SharedBatchEngine::Member> batchMember;
+    juce::String batchGroupId;
+    juce::String batchGroupError;
+    MidiLearn midiLearn;
+    HostedPlayHead hostedPlayHead; // 로드할 때 호스팅 인스턴스에 한 번 넘겨두고 블록마다 위치만 찍음
+    
+    juce::Rectangle<int> lastHostedEditorBounds;
+    juce::String lastHostedEditorPath;
+    
+    // 호스팅 플러그인 버퍼의 각 채널이 래퍼 버퍼의 몇 번 채널인지 (-1 이면 스크래치 채널)
+    static constexpr int maxHostedChannels = 32;
+    static constexpr int numAuxOutputBuses = VST3LOADER_INSTRUMENT ? 7 : 0;
+    std::array<int, maxHostedChannels> hostedChannelMap {};
+    int numHostedChannels = 0;
+    bool hostedChannelMapIsIdentity = true;
+    bool hostedPluginIsInstrument = false; // 악기는 메인 입력 없이 출력 버스 (보조 출력 포함) 로만 연결
+    juce::AudioBuffer<float> floatScratchBuffer;
+    juce::AudioBuffer<double> doubleScratchBuffer;
     
     bool isLoading = false;
     juce::String hostedPluginLoadingError;
     juce::String hostedPluginPath;
     juce::String hostedPluginName;
     juce::MemoryBlock hostedPluginState;
+    LoadProfiler loadProfiler;
+    LoadProfiler::Report lastLoadReport;
+    juce::SharedResourcePointer<WarmInstancePool> warmInstancePool;
+    juce::SharedResourcePointer<LoadScheduler> loadScheduler;
+    juce::SharedResourcePointer<InstanceReclaimer> instanceReclaimer;
+    juce::SharedResourcePointer<PluginCostDatabase> costDatabase;
+    PluginCostDatabase::Meter costMeter;
+    bool hasSkippedBlock = false; // 오디오 스레드 전용: 이번 블록에서 AutoSleep 이 처리를 건너뛰었는지
+    juce::SharedResourcePointer<HibernationManager> hibernationManager;
+    HibernationManager::Client hibernation;
+    juce::MemoryBlock hibernatedState; // 재워둔 동안 호스트가 저장을 요청하면 돌려줄 상태
+    StateHistory stateHistory;
+    std::atomic<bool> isEditorShowing { false };
+    std::atomic<bool> hasInputWhileLoading { false };
+    
+    // 오디오 스레드가 요청하고 handleAsyncUpdate 가 메시지 스레드에서 처리함
+    std::atomic<bool> shouldRebuildMultiMonoHost { false };
+    std::atomic<bool> shouldUpdateBatchLatency { false };
+    std::unique_ptr<BatchRenderer> batchRenderer;
     
     static constexpr const char* innerStateTag = "inner_state";
     static constexpr const char* pluginPathTag = "plugin_path";
+    static constexpr const char* outOfProcessTag = "out_of_process";
+    static constexpr const char* multiMonoTag = "multi_mono";
+    static constexpr const char* linkParametersTag = "link_parameters";
+    static constexpr const char* autoSleepTag = "auto_sleep";
+    static constexpr const char* renderAheadTag = "render_ahead";
+    static constexpr const char* resetOnFaultsTag = "reset_on_faults";
+    static constexpr const char* editorWidthTag = "editor_width";
+    static constexpr const char* editorHeightTag = "editor_height";
+    static constexpr const char* reducedRateTag = "reduced_rate";
+    static constexpr const char* instanceIdTag = "instance_id";
+    static constexpr const char* watchdogOverrunsTag = "watchdog_overruns";
+    static constexpr const char* batchGroupTag = "batch_group";
+    static constexpr const char* neverHibernateTag = "never_hibernate";
+    
+    static constexpr int offlineWakeTimeoutMs = 30000;
     
     using PluginLoadingCallback = std::function<void(std::unique_ptr<juce::AudioPluginInstance>)>;
     
+    static BusesProperties createBusesProperties();
     void setIsLoading(bool value);
     void setHostedPluginInstance(std::unique_ptr<juce::AudioPluginInstance> pluginInstance);
     void setHostedPluginLoadingError(juce::String value);
     void setHostedPluginPath(juce::String value);
     void setHostedPluginName(juce::String value);
-    juce::String getHostedPluginPath();
     
     void removePreviouslyHostedPluginIfNeeded(bool unsetError);
-    void loadPluginFromFile(const juce::String& pluginPath, PluginLoadingCallback callback);
+    void releaseHostedPlugin();
+    bool canHibernateHostedPlugin();
+    bool hibernateHostedPlugin();
+    void wakeHostedPlugin();
+    void loadPluginFromFile(const juce::String& pluginPath, PluginLoadingCallback callback, bool useWarmPool = true);
+    void finishLoadingPlugin(const juce::String& pluginPath, std::unique_ptr<juce::AudioPluginInstance> pluginInstance);
+    void finishWakingPlugin(const juce::String& pluginPath, std::unique_ptr<juce::AudioPluginInstance> pluginInstance);
+    void loadPluginOutOfProcess(const juce::String& pluginPath);
+    bool getHostedPluginInnerState(juce::MemoryBlock& innerState);
     bool setHostedPluginLayout();
+    void updateHostedChannelMap();
+    void prepareScratchBuffers(int blockSize);
     bool prepareHostedPluginForPlaying();
+    void prepareRateConverter(double sampleRate, int samplesPerBlock);
+    int getHostedLatencySamples();
+    void prepareDeadlineWatchdog();
+    void joinBatchGroupIfNeeded();
+    void leaveBatchGroup();
     void setHostedPluginState();
+    void rebuildMultiMonoHost();
+    void handleAsyncUpdate() override;
+    void updateAutoSleep();
+    int getLoadPriority() const;
+    void rebuildAnticipativeRenderer();
+    int getRendererLatencySamples();
     
     template<typename T>
     T safelyPerform(std::function<T(std::unique_ptr<juce::AudioPluginInstance>&)> operation) const
@@ -85,5 +311,10 @@ private:
                              juce::MidiBuffer& midiMessages,
                              bool isActive);
     
+    template<typename SampleType>
+    void processHostedPlugin(juce::AudioBuffer<SampleType>& buffer,
+                             juce::MidiBuffer& midiMessages,
+                             bool isActive);
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VST3LoaderAudioProcessor)
 };
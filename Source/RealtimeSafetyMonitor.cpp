@@ -0,0 +1,95 @@
+#include "RealtimeSafetyMonitor.h"
+
+namespace
+{
+    thread_local RealtimeSafetyMonitor* currentMonitor = nullptr;
+    std::atomic<bool> checkingAllocations { false };
+}
+
+juce::String RealtimeSafetyMonitor::Report::toString() const
+{
+    juce::String text;
+    text << "Blocks: " << numBlocks << "\n"
+         << "Contended locks: " << numContendedLocks << "\n"
+         << "Allocations: " << (numAllocations < 0 ? juce::String("not checked") : juce::String(numAllocations)) << "\n"
+         << "Worst block: " << juce::String(worstBlockMilliseconds, 3) << " ms"
+         << " (budget " << juce::String(worstBlockBudgetMilliseconds, 3) << " ms)";
+    return text;
+}
+
+RealtimeSafetyMonitor::ScopedBlock::ScopedBlock(RealtimeSafetyMonitor& monitor, int numSamples)
+    : owner(monitor),
+      previousMonitor(currentMonitor),
+      budgetMilliseconds(1000.0 * numSamples / juce::jmax(1.0, monitor.preparedSampleRate.load(std::memory_order_relaxed))),
+      startTicks(juce::Time::getHighResolutionTicks())
+{
+    currentMonitor = &owner;
+}
+
+RealtimeSafetyMonitor::ScopedBlock::~ScopedBlock()
+{
+    currentMonitor = previousMonitor;
+    
+    const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    owner.numBlocks.fetch_add(1, std::memory_order_relaxed);
+    
+    // 오디오 스레드 하나만 쓰므로 비교 후 저장으로 충분함
+    if (elapsed > owner.worstBlockMilliseconds.load(std::memory_order_relaxed))
+    {
+        owner.worstBlockMilliseconds.store(elapsed, std::memory_order_relaxed);
+        owner.worstBlockBudgetMilliseconds.store(budgetMilliseconds, std::memory_order_relaxed);
+    }
+}
+
+RealtimeSafetyMonitor::ScopedLock::ScopedLock(RealtimeSafetyMonitor& monitor, const juce::CriticalSection& lock)
+    : criticalSection(lock)
+{
+    if (!criticalSection.tryEnter())
+    {
+        monitor.numContendedLocks.fetch_add(1, std::memory_order_relaxed);
+        criticalSection.enter();
+    }
+}
+
+RealtimeSafetyMonitor::ScopedLock::~ScopedLock()
+{
+    criticalSection.exit();
+}
+
+RealtimeSafetyMonitor::Report RealtimeSafetyMonitor::getReport() const
+{
+    Report report;
+    report.numBlocks = numBlocks.load();
+    report.numContendedLocks = numContendedLocks.load();
+    report.numAllocations = isCheckingAllocations() ? numAllocations.load() : -1;
+    report.worstBlockMilliseconds = worstBlockMilliseconds.load();
+    report.worstBlockBudgetMilliseconds = worstBlockBudgetMilliseconds.load();
+    return report;
+}
+
+void RealtimeSafetyMonitor::resetReport()
+{
+    numBlocks.store(0);
+    numContendedLocks.store(0);
+    numAllocations.store(0);
+    worstBlockMilliseconds.store(0.0);
+    worstBlockBudgetMilliseconds.store(0.0);
+}
+
+bool RealtimeSafetyMonitor::isCheckingAllocations()
+{
+    return checkingAllocations.load(std::memory_order_relaxed);
+}
+
+void RealtimeSafetyMonitor::setCheckingAllocations(bool shouldCheck)
+{
+    checkingAllocations.store(shouldCheck);
+}
+
+void RealtimeSafetyMonitor::noteAllocation()
+{
+    if (auto* monitor = currentMonitor)
+    {
+        monitor->numAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 오디오 스레드에서 실시간 규칙을 어긴 횟수(막힌 락, 메모리 할당)와 최악의 블록 처리 시간을 기록
+// 플러그인은 전역 operator new 를 바꾸지 않음. 할당 검사는 할당 훅을 가진 테스트 바이너리(헬퍼)가
+// setCheckingAllocations(true) 로 켜고, 훅에서 noteAllocation() 을 부를 때만 셈
+
+class RealtimeSafetyMonitor
+{
+public:
+    struct Report
+    {
+        juce::int64 numBlocks = 0;
+        juce::int64 numContendedLocks = 0;
+        juce::int64 numAllocations = -1; // -1 이면 검사하지 않음
+        double worstBlockMilliseconds = 0.0;
+        double worstBlockBudgetMilliseconds = 0.0;
+        
+        juce::String toString() const;
+    };
+    
+    // processBlock 전체를 감싸서 시간을 재고, 이 스레드의 할당을 이 모니터로 셈
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(RealtimeSafetyMonitor& monitor, int numSamples);
+        ~ScopedBlock();
+    
+    private:
+        RealtimeSafetyMonitor& owner;
+        RealtimeSafetyMonitor* previousMonitor;
+        double budgetMilliseconds;
+        juce::int64 startTicks;
+        
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+    };
+    
+    // 오디오 스레드용 락: 바로 잡히지 않으면 막힌 것으로 기록한 뒤 기다림
+    class ScopedLock
+    {
+    public:
+        ScopedLock(RealtimeSafetyMonitor& monitor, const juce::CriticalSection& lock);
+        ~ScopedLock();
+    
+    private:
+        const juce::CriticalSection& criticalSection;
+        
+        JUCE_DECLARE_NON_COPYABLE (ScopedLock)
+    };
+    
+    void prepare(double sampleRate) { preparedSampleRate.store(sampleRate); }
+    Report getReport() const;
+    void resetReport();
+    
+    static bool isCheckingAllocations();
+    static void setCheckingAllocations(bool shouldCheck);
+    
+    // 할당 훅에서 불림. ScopedBlock 안에 있는 스레드의 할당만 셈
+    static void noteAllocation();
+    
+private:
+    std::atomic<double> preparedSampleRate { 44100.0 };
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<juce::int64> numContendedLocks { 0 };
+    std::atomic<juce::int64> numAllocations { 0 };
+    std::atomic<double> worstBlockMilliseconds { 0.0 };
+    std::atomic<double> worstBlockBudgetMilliseconds { 0.0 };
+};
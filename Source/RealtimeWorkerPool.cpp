@@ -0,0 +1,142 @@
+#include "RealtimeWorkerPool.h"
+
+class RealtimeWorkerPool::Worker : public juce::Thread
+{
+public:
+    explicit Worker(RealtimeWorkerPool& o) : juce::Thread("Multi-mono worker"), owner(o) {}
+    
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeUp();
+        stopThread(1000);
+    }
+    
+    void wakeUp()
+    {
+        if (isSleeping.load()) { wakeEvent.signal(); }
+    }
+    
+    void run() override
+    {
+        auto seenGeneration = owner.getGeneration();
+        
+        while (!threadShouldExit())
+        {
+            auto currentGeneration = owner.getGeneration();
+            
+            for (int i = 0; i < spinIterations && currentGeneration == seenGeneration; ++i)
+            {
+                std::this_thread::yield();
+                currentGeneration = owner.getGeneration();
+            }
+            
+            if (currentGeneration == seenGeneration)
+            {
+                // 다시 확인한 뒤에 잠들어서 깨우기 신호를 놓치지 않게 함
+                isSleeping.store(true);
+                if (owner.getGeneration() == seenGeneration)
+                {
+                    wakeEvent.wait(10);
+                }
+                isSleeping.store(false);
+                continue;
+            }
+            
+            seenGeneration = currentGeneration;
+            owner.runAvailableTasks(currentGeneration);
+        }
+    }
+    
+private:
+    RealtimeWorkerPool& owner;
+    juce::WaitableEvent wakeEvent;
+    std::atomic<bool> isSleeping { false };
+};
+
+RealtimeWorkerPool::RealtimeWorkerPool() {}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    stop();
+}
+
+void RealtimeWorkerPool::start(int numWorkers, int samplesPerBlock, double sampleRate)
+{
+    stop();
+    
+    const auto options = juce::Thread::RealtimeOptions{}
+                             .withApproximateAudioProcessingTime(juce::jmax(1, samplesPerBlock),
+                                                                 sampleRate > 0.0 ? sampleRate : 44100.0);
+    
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this));
+        if (!worker->startRealtimeThread(options))
+        {
+            worker->startThread(juce::Thread::Priority::highest);
+        }
+    }
+}
+
+void RealtimeWorkerPool::stop()
+{
+    workers.clear();
+}
+
+void RealtimeWorkerPool::run(int numTasksToRun, TaskFunction function, void* context)
+{
+    if (workers.isEmpty() || numTasksToRun <= 1)
+    {
+        for (int i = 0; i < numTasksToRun; ++i)
+        {
+            function(context, i);
+        }
+        return;
+    }
+    
+    jassert(numTasksToRun <= maxTasks);
+    numTasksToRun = juce::jmin(numTasksToRun, maxTasks);
+    
+    // 함수/컨텍스트를 먼저 써두고 세대를 올리면서 작업 수와 함께 한 번에 발행함
+    taskFunction.store(function, std::memory_order_relaxed);
+    taskContext.store(context, std::memory_order_relaxed);
+    numCompletedTasks.store(0, std::memory_order_relaxed);
+    
+    const auto newGeneration = (juce::uint32) (workState.load(std::memory_order_relaxed) >> 32) + 1;
+    workState.store(((juce::uint64) newGeneration << 32) | ((juce::uint64) numTasksToRun << 16),
+                    std::memory_order_release);
+    
+    for (auto* worker : workers)
+    {
+        worker->wakeUp();
+    }
+    
+    runAvailableTasks(newGeneration);
+    
+    while (numCompletedTasks.load(std::memory_order_acquire) < numTasksToRun)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void RealtimeWorkerPool::runAvailableTasks(juce::uint32 taskGeneration)
+{
+    auto state = workState.load(std::memory_order_acquire);
+    
+    while ((juce::uint32) (state >> 32) == taskGeneration)
+    {
+        const auto task = (int) (state & 0xffff);
+        if (task >= (int) ((state >> 16) & 0xffff)) { return; }
+        
+        // 세대와 번호가 그대로일 때만 가져감, 실패하면 state 가 새 값으로 바뀌어 다시 확인함
+        if (!workState.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            continue;
+        }
+        
+        taskFunction.load(std::memory_order_relaxed)(taskContext.load(std::memory_order_relaxed), task);
+        numCompletedTasks.fetch_add(1, std::memory_order_release);
+        state = workState.load(std::memory_order_acquire);
+    }
+}
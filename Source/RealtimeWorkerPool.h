@@ -0,0 +1,44 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 오디오 스레드에서 블록마다 fork/join 하는 실시간 작업자 풀
+// 작업 배분은 원자 변수로만 하고, 호출한 스레드도 작업을 나눠서 처리함
+// 작업자는 잠깐 스핀하며 다음 블록을 기다리다가 없으면 잠듦
+class RealtimeWorkerPool
+{
+public:
+    using TaskFunction = void (*)(void* context, int taskIndex);
+    
+    RealtimeWorkerPool();
+    ~RealtimeWorkerPool();
+    
+    // 메시지 스레드에서 호출
+    void start(int numWorkers, int samplesPerBlock, double sampleRate);
+    void stop();
+    int getNumWorkers() const { return workers.size(); }
+    
+    // 오디오 스레드에서 호출: 모든 작업이 끝날 때까지 반환하지 않음
+    void run(int numTasks, TaskFunction function, void* context);
+    
+private:
+    class Worker;
+    
+    juce::OwnedArray<Worker> workers;
+    
+    std::atomic<TaskFunction> taskFunction { nullptr };
+    std::atomic<void*> taskContext { nullptr };
+    std::atomic<int> numCompletedTasks { 0 };
+    
+    // 세대(상위 32비트), 작업 수(16비트), 다음 작업(하위 16비트)을 한 원자 변수에 묶어서 발행함
+    // 세대가 맞을 때만 작업을 가져가므로 이전 블록의 작업자가 늦게 와도 새 블록의 작업을 두 번 돌리거나
+    // 이전 함수/컨텍스트로 돌리지 않음 (가져간 작업이 끝나기 전에는 다음 블록이 시작되지 않음)
+    std::atomic<juce::uint64> workState { 0 };
+    
+    static constexpr int spinIterations = 4000;
+    static constexpr int maxTasks = 0xffff;
+    
+    juce::uint32 getGeneration() const { return (juce::uint32) (workState.load(std::memory_order_acquire) >> 32); }
+    void runAvailableTasks(juce::uint32 taskGeneration);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeWorkerPool)
+};
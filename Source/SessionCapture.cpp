@@ -0,0 +1,289 @@
+#include "SessionCapture.h"
+#include "LoadProfiler.h"
+
+SessionCapture::SessionCapture() : juce::Thread("Session capture writer") {}
+
+SessionCapture::~SessionCapture()
+{
+    stop();
+}
+
+juce::File SessionCapture::getCaptureDirectory()
+{
+    // ~/Library/Logs/VST3 Loader/Captures
+    return LoadProfiler::getLogDirectory().getChildFile("Captures");
+}
+
+bool SessionCapture::start(const juce::File& file, const Header& header)
+{
+    stop();
+    
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+    
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk()) { return false; }
+    
+    stream->write("VLCP", 4);
+    stream->writeInt(headerVersion);
+    stream->writeDouble(header.sampleRate);
+    stream->writeInt(header.maxBlockSize);
+    stream->writeInt(header.numChannels);
+    stream->writeString(header.pluginPath);
+    stream->writeInt64((juce::int64) header.initialState.getSize());
+    stream->write(header.initialState.getData(), header.initialState.getSize());
+    
+    ring.allocate((size_t) ringBytes, false);
+    ringFifo.setTotalSize(ringBytes);
+    
+    // 레코드 하나가 들어갈 크기를 미리 잡아서 오디오 스레드에서는 할당하지 않음
+    recordCapacity = 256 + (size_t) maxMidiBytes + sizeof(float) * (size_t) header.numChannels * (size_t) header.maxBlockSize;
+    record.allocate(recordCapacity, false);
+    
+    const juce::SpinLock::ScopedLockType sl(captureLock);
+    captureFile = file;
+    outputStream = std::move(stream);
+    numCaptureChannels = header.numChannels;
+    maxCaptureBlockSize = header.maxBlockSize;
+    nextSequence = 0;
+    numCapturedBlocks.store(0);
+    numDroppedBlocks.store(0);
+    capturing.store(true);
+    
+    startThread(juce::Thread::Priority::low);
+    return true;
+}
+
+void SessionCapture::stop()
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(captureLock);
+        if (!capturing.exchange(false)) { return; }
+    }
+    
+    // 작업 스레드가 끝나면서 남은 레코드를 모두 씀
+    stopThread(5000);
+    drainRing();
+    outputStream->flush();
+    outputStream.reset();
+}
+
+void SessionCapture::pushBlock(const juce::AudioBuffer<float>& buffer,
+                               const juce::MidiBuffer& midiMessages,
+                               bool isActive,
+                               juce::AudioPlayHead* playHead)
+{
+    const juce::SpinLock::ScopedTryLockType sl(captureLock);
+    if (!sl.isLocked() || !capturing.load(std::memory_order_relaxed)) { return; }
+    
+    const auto numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), numCaptureChannels);
+    const auto sequence = nextSequence++;
+    
+    if (numSamples > maxCaptureBlockSize)
+    {
+        numDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    // 레코드 크기는 앞 4바이트에 나중에 채움
+    juce::MemoryOutputStream out(record.getData() + sizeof(juce::uint32), recordCapacity - sizeof(juce::uint32));
+    
+    juce::uint32 flags = isActive ? activeFlag : 0;
+    const auto position = playHead != nullptr ? playHead->getPosition() : juce::Optional<juce::AudioPlayHead::PositionInfo>();
+    
+    if (position.hasValue())
+    {
+        flags |= positionFlag;
+        if (position->getTimeInSamples().hasValue())              { flags |= timeInSamplesFlag; }
+        if (position->getTimeInSeconds().hasValue())              { flags |= timeInSecondsFlag; }
+        if (position->getPpqPosition().hasValue())                { flags |= ppqPositionFlag; }
+        if (position->getBpm().hasValue())                        { flags |= bpmFlag; }
+        if (position->getTimeSignature().hasValue())              { flags |= timeSignatureFlag; }
+        if (position->getPpqPositionOfLastBarStart().hasValue())  { flags |= lastBarStartFlag; }
+        if (position->getLoopPoints().hasValue())                 { flags |= loopPointsFlag; }
+        if (position->getIsPlaying())                             { flags |= playingFlag; }
+        if (position->getIsRecording())                           { flags |= recordingFlag; }
+        if (position->getIsLooping())                             { flags |= loopingFlag; }
+    }
+    
+    out.writeInt((int) sequence);
+    out.writeInt(numSamples);
+    out.writeInt(numChannels);
+    out.writeInt((int) flags);
+    
+    if (position.hasValue())
+    {
+        const auto timeSignature = position->getTimeSignature().orFallback(juce::AudioPlayHead::TimeSignature {});
+        const auto loopPoints = position->getLoopPoints().orFallback(juce::AudioPlayHead::LoopPoints {});
+        
+        out.writeInt64(position->getTimeInSamples().orFallback(0));
+        out.writeDouble(position->getTimeInSeconds().orFallback(0.0));
+        out.writeDouble(position->getPpqPosition().orFallback(0.0));
+        out.writeDouble(position->getBpm().orFallback(0.0));
+        out.writeInt(timeSignature.numerator);
+        out.writeInt(timeSignature.denominator);
+        out.writeDouble(position->getPpqPositionOfLastBarStart().orFallback(0.0));
+        out.writeDouble(loopPoints.ppqStart);
+        out.writeDouble(loopPoints.ppqEnd);
+    }
+    
+    const auto midiStart = out.getPosition();
+    out.writeInt(0);
+    
+    int numMidiEvents = 0;
+    size_t midiBytes = 0;
+    
+    for (const auto metadata : midiMessages)
+    {
+        midiBytes += (size_t) metadata.numBytes + 6;
+        if (midiBytes > (size_t) maxMidiBytes) { break; }
+        
+        out.writeInt(metadata.samplePosition);
+        out.writeShort((short) metadata.numBytes);
+        out.write(metadata.data, (size_t) metadata.numBytes);
+        ++numMidiEvents;
+    }
+    
+    const auto midiEnd = out.getPosition();
+    out.setPosition(midiStart);
+    out.writeInt(numMidiEvents);
+    out.setPosition(midiEnd);
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        out.write(buffer.getReadPointer(ch), sizeof(float) * (size_t) numSamples);
+    }
+    
+    const auto recordSize = (juce::uint32) out.getDataSize();
+    const auto littleEndianSize = juce::ByteOrder::swapIfBigEndian(recordSize);
+    std::memcpy(record.getData(), &littleEndianSize, sizeof(littleEndianSize));
+    
+    const auto totalSize = (int) (recordSize + sizeof(juce::uint32));
+    if (ringFifo.getFreeSpace() < totalSize)
+    {
+        numDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    const auto scope = ringFifo.write(totalSize);
+    std::memcpy(ring.getData() + scope.startIndex1, record.getData(), (size_t) scope.blockSize1);
+    std::memcpy(ring.getData() + scope.startIndex2, record.getData() + scope.blockSize1, (size_t) scope.blockSize2);
+    
+    numCapturedBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionCapture::run()
+{
+    while (!threadShouldExit())
+    {
+        drainRing();
+        wait(20);
+    }
+}
+
+void SessionCapture::drainRing()
+{
+    const auto scope = ringFifo.read(ringFifo.getNumReady());
+    
+    if (scope.blockSize1 > 0) { outputStream->write(ring.getData() + scope.startIndex1, (size_t) scope.blockSize1); }
+    if (scope.blockSize2 > 0) { outputStream->write(ring.getData() + scope.startIndex2, (size_t) scope.blockSize2); }
+}
+
+SessionCapture::Reader::Reader(const juce::File& file) : stream(file)
+{
+    if (!stream.openedOk()) { return; }
+    
+    char magic[4] = {};
+    if (stream.read(magic, 4) != 4 || std::memcmp(magic, "VLCP", 4) != 0) { return; }
+    if (stream.readInt() != headerVersion) { return; }
+    
+    header.sampleRate = stream.readDouble();
+    header.maxBlockSize = stream.readInt();
+    header.numChannels = stream.readInt();
+    header.pluginPath = stream.readString();
+    
+    const auto stateSize = stream.readInt64();
+    if (stateSize < 0 || stateSize > stream.getNumBytesRemaining()) { return; }
+    
+    header.initialState.setSize((size_t) stateSize);
+    stream.read(header.initialState.getData(), (int) stateSize);
+    
+    valid = header.sampleRate > 0.0 && header.maxBlockSize > 0 && header.numChannels > 0;
+}
+
+bool SessionCapture::Reader::readNextBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, BlockInfo& info)
+{
+    if (!valid || stream.getNumBytesRemaining() < (juce::int64) sizeof(juce::uint32)) { return false; }
+    
+    const auto recordSize = (juce::int64) (juce::uint32) stream.readInt();
+    const auto recordEnd = stream.getPosition() + recordSize;
+    if (recordSize <= 0 || recordEnd > stream.getTotalLength()) { return false; }
+    
+    info.sequence = (juce::uint32) stream.readInt();
+    info.numSamples = stream.readInt();
+    const auto numChannels = stream.readInt();
+    const auto flags = (juce::uint32) stream.readInt();
+    
+    if (info.numSamples < 0 || info.numSamples > buffer.getNumSamples() || numChannels > buffer.getNumChannels()) { return false; }
+    
+    info.isActive = (flags & activeFlag) != 0;
+    info.hasPosition = (flags & positionFlag) != 0;
+    info.position = {};
+    
+    if (info.hasPosition)
+    {
+        auto& position = info.position;
+        const auto timeInSamples = stream.readInt64();
+        const auto timeInSeconds = stream.readDouble();
+        const auto ppqPosition = stream.readDouble();
+        const auto bpm = stream.readDouble();
+        const auto numerator = stream.readInt();
+        const auto denominator = stream.readInt();
+        const auto lastBarStart = stream.readDouble();
+        const auto loopStart = stream.readDouble();
+        const auto loopEnd = stream.readDouble();
+        
+        if (flags & timeInSamplesFlag) { position.setTimeInSamples(timeInSamples); }
+        if (flags & timeInSecondsFlag) { position.setTimeInSeconds(timeInSeconds); }
+        if (flags & ppqPositionFlag)   { position.setPpqPosition(ppqPosition); }
+        if (flags & bpmFlag)           { position.setBpm(bpm); }
+        if (flags & timeSignatureFlag) { position.setTimeSignature(juce::AudioPlayHead::TimeSignature { numerator, denominator }); }
+        if (flags & lastBarStartFlag)  { position.setPpqPositionOfLastBarStart(lastBarStart); }
+        if (flags & loopPointsFlag)    { position.setLoopPoints(juce::AudioPlayHead::LoopPoints { loopStart, loopEnd }); }
+        position.setIsPlaying((flags & playingFlag) != 0);
+        position.setIsRecording((flags & recordingFlag) != 0);
+        position.setIsLooping((flags & loopingFlag) != 0);
+    }
+    
+    midiMessages.clear();
+    const auto numMidiEvents = stream.readInt();
+    
+    for (int i = 0; i < numMidiEvents; ++i)
+    {
+        const auto samplePosition = stream.readInt();
+        const auto numBytes = (int) stream.readShort();
+        juce::uint8 data[256] = {};
+        
+        if (numBytes <= 0 || numBytes > (int) sizeof(data))
+        {
+            // 시스템 익스클루시브처럼 긴 메시지는 건너뜀
+            stream.skipNextBytes(juce::jmax(0, numBytes));
+            continue;
+        }
+        
+        stream.read(data, numBytes);
+        midiMessages.addEvent(data, numBytes, samplePosition);
+    }
+    
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (ch < numChannels)
+            stream.read(buffer.getWritePointer(ch), (int) (sizeof(float) * (size_t) info.numSamples));
+        else
+            buffer.clear(ch, 0, info.numSamples);
+    }
+    
+    stream.setPosition(recordEnd);
+    return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 래퍼에 들어온 블록(입력 오디오, MIDI, 재생 위치, 블록 크기)과 시작 시점의 플러그인 상태를 파일로 기록
+// 오디오 스레드는 미리 할당한 링 버퍼에 레코드를 넣기만 하고, 파일 쓰기는 별도 스레드가 맡음
+// 기록한 파일은 VST3LoaderHost --replay 로 같은 블록 경계 그대로 다시 처리할 수 있음
+//
+// 파일 형식 (리틀 엔디언)
+//   "VLCP" version sampleRate maxBlockSize numChannels pluginPath stateSize state
+//   레코드마다: recordSize sequence numSamples numChannels flags [재생 위치] numMidiEvents [MIDI] [채널별 float 오디오]
+class SessionCapture : private juce::Thread
+{
+public:
+    struct Header
+    {
+        double sampleRate = 0.0;
+        int maxBlockSize = 0;
+        int numChannels = 0;
+        juce::String pluginPath;
+        juce::MemoryBlock initialState;
+    };
+    
+    struct BlockInfo
+    {
+        juce::uint32 sequence = 0;
+        int numSamples = 0;
+        bool isActive = true;
+        bool hasPosition = false;
+        juce::AudioPlayHead::PositionInfo position;
+    };
+    
+    SessionCapture();
+    ~SessionCapture() override;
+    
+    // 메시지 스레드에서 호출
+    bool start(const juce::File& file, const Header& header);
+    void stop();
+    bool isCapturing() const { return capturing.load(); }
+    juce::File getFile() const { return captureFile; }
+    juce::int64 getNumCapturedBlocks() const { return numCapturedBlocks.load(); }
+    juce::int64 getNumDroppedBlocks() const { return numDroppedBlocks.load(); }
+    
+    static juce::File getCaptureDirectory();
+    
+    // 오디오 스레드에서 호출: 링 버퍼가 가득 차면 블록을 버리고 개수만 셈
+    void pushBlock(const juce::AudioBuffer<float>& buffer,
+                   const juce::MidiBuffer& midiMessages,
+                   bool isActive,
+                   juce::AudioPlayHead* playHead);
+    
+    // 기록 파일을 블록 단위로 읽음 (VST3LoaderHost --replay)
+    class Reader
+    {
+    public:
+        explicit Reader(const juce::File& file);
+        
+        bool isValid() const { return valid; }
+        const Header& getHeader() const { return header; }
+        
+        // buffer 는 헤더의 채널 수와 최대 블록 크기 이상이어야 함
+        bool readNextBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, BlockInfo& info);
+    
+    private:
+        juce::FileInputStream stream;
+        Header header;
+        bool valid = false;
+    };
+    
+private:
+    std::atomic<bool> capturing { false };
+    std::atomic<juce::int64> numCapturedBlocks { 0 };
+    std::atomic<juce::int64> numDroppedBlocks { 0 };
+    
+    // start/stop 과 오디오 스레드 사이의 짧은 보호 (오디오 스레드는 tryEnter 만 씀)
+    juce::SpinLock captureLock;
+    juce::File captureFile;
+    std::unique_ptr<juce::FileOutputStream> outputStream;
+    
+    juce::HeapBlock<char> ring;
+    juce::AbstractFifo ringFifo { 1 };
+    juce::HeapBlock<char> record;
+    size_t recordCapacity = 0;
+    int numCaptureChannels = 0;
+    int maxCaptureBlockSize = 0;
+    juce::uint32 nextSequence = 0;
+    
+    static constexpr int ringBytes = 16 * 1024 * 1024;
+    static constexpr int maxMidiBytes = 65536;
+    static constexpr int headerVersion = 1;
+    
+    enum Flags
+    {
+        activeFlag          = 1 << 0,
+        positionFlag        = 1 << 1,
+        timeInSamplesFlag   = 1 << 2,
+        timeInSecondsFlag   = 1 << 3,
+        ppqPositionFlag     = 1 << 4,
+        bpmFlag             = 1 << 5,
+        timeSignatureFlag   = 1 << 6,
+        lastBarStartFlag    = 1 << 7,
+        loopPointsFlag      = 1 << 8,
+        playingFlag         = 1 << 9,
+        recordingFlag       = 1 << 10,
+        loopingFlag         = 1 << 11
+    };
+    
+    void run() override;
+    void drainRing();
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionCapture)
+};
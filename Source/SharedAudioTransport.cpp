@@ -0,0 +1,371 @@
+#include "SharedAudioTransport.h"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace
+{
+    constexpr juce::uint32 transportMagic = 0x56334c54; // "V3LT"
+    
+    // macOS 는 공유 메모리/세마포어 이름을 31자로 제한함
+    juce::String makeUniqueName()
+    {
+        static std::atomic<int> counter { 0 };
+        return "/v3l" + juce::String((int) getpid()) + "_" + juce::String(++counter);
+    }
+    
+    size_t alignUp(size_t value)
+    {
+        return (value + 63) & ~(size_t) 63;
+    }
+}
+
+SharedAudioTransport::SharedAudioTransport(const juce::String& nameToUse, bool owner)
+    : name(nameToUse), isOwner(owner)
+{
+}
+
+SharedAudioTransport::~SharedAudioTransport()
+{
+    if (mappedMemory != nullptr) { munmap(mappedMemory, mappedSize); }
+    if (requestSemaphore != SEM_FAILED) { sem_close(requestSemaphore); }
+    if (responseSemaphore != SEM_FAILED) { sem_close(responseSemaphore); }
+    if (stateSemaphore != SEM_FAILED) { sem_close(stateSemaphore); }
+    
+    if (isOwner)
+    {
+        shm_unlink(name.toRawUTF8());
+        sem_unlink((name + "q").toRawUTF8());
+        sem_unlink((name + "r").toRawUTF8());
+        sem_unlink((name + "s").toRawUTF8());
+    }
+}
+
+size_t SharedAudioTransport::getHeaderBytes()
+{
+    return alignUp(sizeof(Header));
+}
+
+size_t SharedAudioTransport::getSlotBytes(int maxBlockSize)
+{
+    return alignUp(sizeof(float) * (size_t) maxChannels * (size_t) maxBlockSize + (size_t) maxMidiBytes);
+}
+
+size_t SharedAudioTransport::getMappedBytes(size_t slotBytes)
+{
+    // 상태 영역은 실제로 쓴 페이지만 메모리를 차지함
+    return getHeaderBytes() + slotBytes * numSlots + (size_t) maxStateBytes;
+}
+
+bool SharedAudioTransport::map(size_t size, bool create)
+{
+    const auto fd = shm_open(name.toRawUTF8(), create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) { return false; }
+    
+    if (create && ftruncate(fd, (off_t) size) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    
+    auto* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    
+    if (memory == MAP_FAILED) { return false; }
+    
+    mappedMemory = memory;
+    mappedSize = size;
+    return true;
+}
+
+bool SharedAudioTransport::openSemaphores(bool create)
+{
+    const auto requestName = name + "q";
+    const auto responseName = name + "r";
+    const auto stateName = name + "s";
+    
+    if (create)
+    {
+        sem_unlink(requestName.toRawUTF8());
+        sem_unlink(responseName.toRawUTF8());
+        sem_unlink(stateName.toRawUTF8());
+        requestSemaphore = sem_open(requestName.toRawUTF8(), O_CREAT | O_EXCL, 0600, 0);
+        responseSemaphore = sem_open(responseName.toRawUTF8(), O_CREAT | O_EXCL, 0600, 0);
+        stateSemaphore = sem_open(stateName.toRawUTF8(), O_CREAT | O_EXCL, 0600, 0);
+    }
+    else
+    {
+        requestSemaphore = sem_open(requestName.toRawUTF8(), 0);
+        responseSemaphore = sem_open(responseName.toRawUTF8(), 0);
+        stateSemaphore = sem_open(stateName.toRawUTF8(), 0);
+    }
+    
+    return requestSemaphore != SEM_FAILED && responseSemaphore != SEM_FAILED && stateSemaphore != SEM_FAILED;
+}
+
+std::unique_ptr<SharedAudioTransport> SharedAudioTransport::create(int maxBlockSize)
+{
+    std::unique_ptr<SharedAudioTransport> transport(new SharedAudioTransport(makeUniqueName(), true));
+    
+    const auto slotBytes = getSlotBytes(maxBlockSize);
+    if (!transport->map(getMappedBytes(slotBytes), true)) { return nullptr; }
+    if (!transport->openSemaphores(true)) { return nullptr; }
+    
+    transport->header = new (transport->mappedMemory) Header();
+    transport->header->magic = transportMagic;
+    transport->header->maxBlockSize = maxBlockSize;
+    transport->slotMemory = static_cast<juce::uint8*>(transport->mappedMemory) + getHeaderBytes();
+    transport->slotBytes = slotBytes;
+    return transport;
+}
+
+std::unique_ptr<SharedAudioTransport> SharedAudioTransport::open(const juce::String& name)
+{
+    std::unique_ptr<SharedAudioTransport> transport(new SharedAudioTransport(name, false));
+    
+    // 먼저 헤더만 매핑해서 블록 크기를 알아낸 뒤 전체를 다시 매핑
+    if (!transport->map(getHeaderBytes(), false)) { return nullptr; }
+    
+    const auto* header = static_cast<const Header*>(transport->mappedMemory);
+    if (header->magic != transportMagic) { return nullptr; }
+    
+    const auto slotBytes = getSlotBytes(header->maxBlockSize);
+    munmap(transport->mappedMemory, transport->mappedSize);
+    transport->mappedMemory = nullptr;
+    
+    if (!transport->map(getMappedBytes(slotBytes), false)) { return nullptr; }
+    if (!transport->openSemaphores(false)) { return nullptr; }
+    
+    transport->header = static_cast<Header*>(transport->mappedMemory);
+    transport->slotMemory = static_cast<juce::uint8*>(transport->mappedMemory) + getHeaderBytes();
+    transport->slotBytes = slotBytes;
+    return transport;
+}
+
+float* SharedAudioTransport::getChannel(juce::uint64 sequence, int channel) const
+{
+    auto* slot = slotMemory + slotBytes * (size_t) (sequence % numSlots);
+    return reinterpret_cast<float*>(slot) + (size_t) channel * (size_t) header->maxBlockSize;
+}
+
+juce::uint8* SharedAudioTransport::getMidiData(juce::uint64 sequence) const
+{
+    auto* slot = slotMemory + slotBytes * (size_t) (sequence % numSlots);
+    return slot + sizeof(float) * (size_t) maxChannels * (size_t) header->maxBlockSize;
+}
+
+void SharedAudioTransport::postRequest()
+{
+    sem_post(requestSemaphore);
+}
+
+void SharedAudioTransport::waitForCompletion(juce::uint64 sequence)
+{
+    auto& slot = getSlot(sequence);
+    header->responseWaiters.store(1);
+    
+    while (slot.completedSequence.load(std::memory_order_acquire) < sequence
+           && header->shouldQuit.load() == 0)
+    {
+        sem_wait(responseSemaphore);
+    }
+    
+    header->responseWaiters.store(0);
+}
+
+bool SharedAudioTransport::waitForRequest()
+{
+    while (sem_wait(requestSemaphore) != 0 && errno == EINTR) {}
+    return header->shouldQuit.load() == 0;
+}
+
+void SharedAudioTransport::postCompletion()
+{
+    if (header->responseWaiters.load() != 0)
+    {
+        sem_post(responseSemaphore);
+    }
+}
+
+bool SharedAudioTransport::writeState(const void* data, size_t numBytes)
+{
+    if (numBytes > (size_t) maxStateBytes)
+    {
+        header->stateNumBytes.store(-1, std::memory_order_release);
+        return false;
+    }
+    
+    std::memcpy(getStateData(), data, numBytes);
+    header->stateNumBytes.store((juce::int32) numBytes, std::memory_order_release);
+    return true;
+}
+
+bool SharedAudioTransport::readState(juce::MemoryBlock& destData) const
+{
+    const auto numBytes = header->stateNumBytes.load(std::memory_order_acquire);
+    if (numBytes < 0 || numBytes > maxStateBytes) { return false; }
+    
+    destData.replaceAll(getStateData(), (size_t) numBytes);
+    return true;
+}
+
+bool SharedAudioTransport::requestState(juce::MemoryBlock& destData, int timeoutMs)
+{
+    const auto request = header->stateRequest.fetch_add(1) + 1;
+    
+    // 워커의 오디오 스레드를 깨워서 메시지 스레드로 상태 저장을 넘기게 함
+    sem_post(requestSemaphore);
+    
+    // macOS 의 이름 있는 세마포어에는 sem_timedwait 가 없으므로 시간이 다 되면 다른 스레드가 대신 깨움
+    std::atomic<bool> timedOut { false };
+    juce::WaitableEvent answered;
+    std::thread timeoutThread([this, &timedOut, &answered, timeoutMs]()
+    {
+        if (!answered.wait(timeoutMs))
+        {
+            timedOut.store(true);
+            sem_post(stateSemaphore);
+        }
+    });
+    
+    while (header->stateResponse.load(std::memory_order_acquire) != request && !timedOut.load())
+    {
+        sem_wait(stateSemaphore);
+    }
+    
+    answered.signal();
+    timeoutThread.join();
+    
+    return header->stateResponse.load(std::memory_order_acquire) == request && readState(destData);
+}
+
+bool SharedAudioTransport::isStateRequested() const
+{
+    return header->stateRequest.load() != header->stateResponse.load();
+}
+
+void SharedAudioTransport::postState(const juce::MemoryBlock& state)
+{
+    // 늦게 도착한 요청도 가장 최근 요청 번호로 한 번에 응답함
+    const auto request = header->stateRequest.load();
+    writeState(state.getData(), state.getSize());
+    header->stateResponse.store(request, std::memory_order_release);
+    sem_post(stateSemaphore);
+}
+
+int SharedAudioTransport::writeMidi(const juce::MidiBuffer& midiMessages, juce::uint8* dest, int maxBytes)
+{
+    auto numBytes = 0;
+    
+    for (const auto metadata : midiMessages)
+    {
+        const auto eventBytes = (int) sizeof(juce::int32) + (int) sizeof(juce::uint16) + metadata.numBytes;
+        if (numBytes + eventBytes > maxBytes) { break; }
+        
+        const auto samplePosition = (juce::int32) metadata.samplePosition;
+        const auto size = (juce::uint16) metadata.numBytes;
+        std::memcpy(dest + numBytes, &samplePosition, sizeof(samplePosition));
+        std::memcpy(dest + numBytes + sizeof(samplePosition), &size, sizeof(size));
+        std::memcpy(dest + numBytes + sizeof(samplePosition) + sizeof(size), metadata.data, (size_t) metadata.numBytes);
+        numBytes += eventBytes;
+    }
+    
+    return numBytes;
+}
+
+void SharedAudioTransport::readMidi(const juce::uint8* source, int numBytes,
+                                    juce::MidiBuffer& midiMessages, int numSamples)
+{
+    constexpr auto eventHeaderBytes = (int) (sizeof(juce::int32) + sizeof(juce::uint16));
+    auto position = 0;
+    
+    while (position + eventHeaderBytes <= numBytes)
+    {
+        juce::int32 samplePosition;
+        juce::uint16 size;
+        std::memcpy(&samplePosition, source + position, sizeof(samplePosition));
+        std::memcpy(&size, source + position + sizeof(samplePosition), sizeof(size));
+        position += eventHeaderBytes;
+        
+        if (position + size > numBytes) { break; }
+        
+        midiMessages.addEvent(source + position, size, juce::jlimit(0, juce::jmax(0, numSamples - 1), (int) samplePosition));
+        position += size;
+    }
+}
+
+std::vector<SharedAudioTransport::LatencyResult> SharedAudioTransport::measureRoundTripLatency(const std::vector<int>& blockSizes,
+                                                                                              int numIterations)
+{
+    std::vector<LatencyResult> results;
+    const auto maxBlockSize = blockSizes.empty() ? 0 : *std::max_element(blockSizes.begin(), blockSizes.end());
+    
+    auto transport = create(maxBlockSize);
+    if (transport == nullptr) { return results; }
+    
+    // 실제 자식 프로세스처럼 이름으로 다시 열어서 별도 매핑을 사용
+    auto echo = open(transport->getName());
+    if (echo == nullptr) { return results; }
+    
+    std::thread echoThread([&echo]()
+    {
+        auto& header = echo->getHeader();
+        auto next = header.requestSequence.load() + 1;
+        
+        while (echo->waitForRequest())
+        {
+            const auto latest = header.requestSequence.load(std::memory_order_acquire);
+            for (; next <= latest; ++next)
+            {
+                auto& slot = echo->getSlot(next);
+                for (int ch = 0; ch < slot.numChannels; ++ch)
+                {
+                    juce::FloatVectorOperations::multiply(echo->getChannel(next, ch), 0.5f, slot.numSamples);
+                }
+                slot.completedSequence.store(next, std::memory_order_release);
+            }
+            echo->postCompletion();
+        }
+    });
+    
+    auto& header = transport->getHeader();
+    juce::uint64 sequence = 0;
+    
+    for (const auto blockSize : blockSizes)
+    {
+        double total = 0.0;
+        double worst = 0.0;
+        
+        for (int i = 0; i < numIterations; ++i)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            
+            ++sequence;
+            auto& slot = transport->getSlot(sequence);
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                juce::FloatVectorOperations::fill(transport->getChannel(sequence, ch), 1.0f, blockSize);
+            }
+            slot.numChannels = 2;
+            slot.numSamples = blockSize;
+            slot.isActive = 1;
+            slot.numMidiBytes = 0;
+            slot.requestSequence.store(sequence, std::memory_order_release);
+            header.requestSequence.store(sequence, std::memory_order_release);
+            transport->postRequest();
+            transport->waitForCompletion(sequence);
+            
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e6;
+            total += elapsed;
+            worst = juce::jmax(worst, elapsed);
+        }
+        
+        results.push_back({ blockSize, total / juce::jmax(1, numIterations), worst });
+    }
+    
+    header.shouldQuit.store(1);
+    transport->postRequest();
+    echoThread.join();
+    return results;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <JuceHeader.h>
+#include <semaphore.h>
+
+// 래퍼와 자식 프로세스 사이의 공유 메모리 오디오/MIDI 블록 링 버퍼
+// 블록당 시스템 콜은 세마포어 깨우기(sem_post) 한 번뿐이고, 완료 여부는 원자 변수로 확인함
+class SharedAudioTransport
+{
+public:
+    static constexpr int numSlots = 4;
+    static constexpr int maxChannels = 32;
+    static constexpr int maxMidiBytes = 16384;
+    static constexpr int maxStateBytes = 16 * 1024 * 1024;
+    
+    struct Slot
+    {
+        std::atomic<juce::uint64> requestSequence;
+        std::atomic<juce::uint64> completedSequence;
+        juce::int32 numChannels;
+        juce::int32 numSamples;
+        juce::int32 isActive;
+        juce::int32 numMidiBytes;
+    };
+    
+    struct Header
+    {
+        juce::uint32 magic;
+        juce::int32 maxBlockSize;
+        std::atomic<juce::uint64> requestSequence;
+        std::atomic<juce::int32> workerReady;
+        std::atomic<juce::int32> shouldQuit;
+        std::atomic<juce::int32> responseWaiters;
+        std::atomic<juce::int32> pluginLatencySamples;
+        std::atomic<juce::uint32> stateRequest;
+        std::atomic<juce::uint32> stateResponse;
+        std::atomic<juce::int32> stateNumBytes;
+        Slot slots[numSlots];
+    };
+    
+    static std::unique_ptr<SharedAudioTransport> create(int maxBlockSize);
+    static std::unique_ptr<SharedAudioTransport> open(const juce::String& name);
+    ~SharedAudioTransport();
+    
+    const juce::String& getName() const { return name; }
+    Header& getHeader() const { return *header; }
+    Slot& getSlot(juce::uint64 sequence) const { return header->slots[sequence % numSlots]; }
+    float* getChannel(juce::uint64 sequence, int channel) const;
+    juce::uint8* getMidiData(juce::uint64 sequence) const;
+    
+    // 래퍼 쪽
+    void postRequest();
+    void waitForCompletion(juce::uint64 sequence);
+    
+    // 워커 쪽 (shouldQuit 이면 false)
+    bool waitForRequest();
+    void postCompletion();
+    
+    // 상태 영역: 시작할 때는 래퍼가 실행 정보를, 요청이 오면 워커가 플러그인 상태를 씀
+    bool writeState(const void* data, size_t numBytes);
+    bool readState(juce::MemoryBlock& destData) const;
+    
+    // 래퍼 쪽: 워커가 상태를 써줄 때까지 최대 timeoutMs 동안 기다림
+    bool requestState(juce::MemoryBlock& destData, int timeoutMs);
+    
+    // 워커 쪽
+    bool isStateRequested() const;
+    void postState(const juce::MemoryBlock& state);
+    
+    static int writeMidi(const juce::MidiBuffer& midiMessages, juce::uint8* dest, int maxBytes);
+    static void readMidi(const juce::uint8* source, int numBytes, juce::MidiBuffer& midiMessages, int numSamples);
+    
+    struct LatencyResult
+    {
+        int blockSize;
+        double averageMicroseconds;
+        double worstMicroseconds;
+    };
+    
+    // 같은 공유 메모리/세마포어 경로로 에코 스레드와 왕복 지연을 측정
+    static std::vector<LatencyResult> measureRoundTripLatency(const std::vector<int>& blockSizes,
+                                                              int numIterations = 2000);
+    
+private:
+    SharedAudioTransport(const juce::String& name, bool isOwner);
+    
+    juce::String name;
+    bool isOwner;
+    void* mappedMemory = nullptr;
+    size_t mappedSize = 0;
+    Header* header = nullptr;
+    juce::uint8* slotMemory = nullptr;
+    size_t slotBytes = 0;
+    sem_t* requestSemaphore = SEM_FAILED;
+    sem_t* responseSemaphore = SEM_FAILED;
+    sem_t* stateSemaphore = SEM_FAILED;
+    
+    static size_t getSlotBytes(int maxBlockSize);
+    static size_t getHeaderBytes();
+    static size_t getMappedBytes(size_t slotBytes);
+    juce::uint8* getStateData() const { return slotMemory + slotBytes * numSlots; }
+    bool map(size_t size, bool create);
+    bool openSemaphores(bool create);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedAudioTransport)
+};
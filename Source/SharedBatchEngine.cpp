@@ -0,0 +1,627 @@
+#include "SharedBatchEngine.h"
+
+//==============================================================================
+void BatchSampleRing::setSize(int numChannels, int numSamples)
+{
+    buffer.setSize(juce::jmax(1, numChannels), juce::jmax(1, numSamples));
+    buffer.clear();
+    numWritten.store(0);
+    numRead.store(0);
+}
+
+int BatchSampleRing::getNumReady() const
+{
+    return (int) (numWritten.load(std::memory_order_acquire) - numRead.load(std::memory_order_relaxed));
+}
+
+int BatchSampleRing::getFreeSpace() const
+{
+    return buffer.getNumSamples() - (int) (numWritten.load(std::memory_order_relaxed) - numRead.load(std::memory_order_acquire));
+}
+
+void BatchSampleRing::write(const float* const* channels, int numChannels, int numSamples)
+{
+    const auto size = buffer.getNumSamples();
+    const auto written = numWritten.load(std::memory_order_relaxed);
+    const auto position = (int) (written % size);
+    const auto firstPart = juce::jmin(numSamples, size - position);
+    
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (channels != nullptr && ch < numChannels)
+        {
+            buffer.copyFrom(ch, position, channels[ch], firstPart);
+            buffer.copyFrom(ch, 0, channels[ch] + firstPart, numSamples - firstPart);
+        }
+        else
+        {
+            buffer.clear(ch, position, firstPart);
+            buffer.clear(ch, 0, numSamples - firstPart);
+        }
+    }
+    
+    numWritten.store(written + numSamples, std::memory_order_release);
+}
+
+void BatchSampleRing::read(float* const* channels, int numChannels, int numSamples)
+{
+    const auto size = buffer.getNumSamples();
+    const auto alreadyRead = numRead.load(std::memory_order_relaxed);
+    const auto position = (int) (alreadyRead % size);
+    const auto firstPart = juce::jmin(numSamples, size - position);
+    
+    if (channels != nullptr)
+    {
+        for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch)
+        {
+            juce::FloatVectorOperations::copy(channels[ch], buffer.getReadPointer(ch, position), firstPart);
+            juce::FloatVectorOperations::copy(channels[ch] + firstPart, buffer.getReadPointer(ch), numSamples - firstPart);
+        }
+    }
+    
+    numRead.store(alreadyRead + numSamples, std::memory_order_release);
+}
+
+//==============================================================================
+class SharedBatchEngine::Group : private juce::Thread
+{
+public:
+    Group(std::unique_ptr<juce::AudioPluginInstance> sharedInstance, double rate, int blockSize)
+        : juce::Thread("Batch group"),
+          instance(std::move(sharedInstance)),
+          identifier(instance->getPluginDescription().createIdentifierString()),
+          sampleRate(rate),
+          maxBlockSize(blockSize)
+    {
+        midiMessages.ensureSize(256);
+    }
+    
+    ~Group() override
+    {
+        stopThread(2000);
+        instance->releaseResources();
+    }
+    
+    bool matches(const juce::String& pluginIdentifier, double rate, int blockSize) const
+    {
+        return identifier == pluginIdentifier && sampleRate == rate && maxBlockSize == blockSize;
+    }
+    
+    // 메시지 스레드에서 엔진 락을 잡고 호출: 멤버 목록이 바뀌면 공유 인스턴스를 새 채널 수로 다시 준비
+    // 그룹 스레드가 멈춘 동안 멤버들은 링에 넣지 않고 원음으로 내므로 링이 넘치지 않음
+    bool rebuild(const std::vector<std::shared_ptr<Member>>& newMembers)
+    {
+        paused.store(true);
+        stopThread(2000);
+        
+        int totalChannels = 0;
+        for (const auto& member : newMembers)
+        {
+            totalChannels += member->numChannels;
+        }
+        
+        instance->releaseResources();
+        
+        if (totalChannels > 0 && !setChannelCount(*instance, totalChannels))
+        {
+            // 이전 구성으로 되돌림
+            setChannelCount(*instance, juce::jmax(1, numTotalChannels));
+            if (!members.empty()) { prepareAndStart(); }
+            paused.store(false);
+            return false;
+        }
+        
+        members = newMembers;
+        numTotalChannels = totalChannels;
+        
+        int offset = 0;
+        for (const auto& member : members)
+        {
+            member->channelOffset = offset;
+            offset += member->numChannels;
+        }
+        
+        wideBuffer.setSize(juce::jmax(1, numTotalChannels), maxBlockSize);
+        isLive.assign(members.size(), false);
+        
+        if (!members.empty()) { prepareAndStart(); }
+        paused.store(false);
+        return true;
+    }
+    
+    const std::vector<std::shared_ptr<Member>>& getMembers() const { return members; }
+    bool isEmpty() const { return members.empty(); }
+    int getNumMembers() const { return (int) members.size(); }
+    int getNumTotalChannels() const { return numTotalChannels; }
+    int getPluginLatencySamples() const { return instance->getLatencySamples(); }
+    int getMaxBlockSize() const { return maxBlockSize; }
+    bool isPaused() const { return paused.load(std::memory_order_relaxed); }
+    juce::AudioPluginInstance& getInstance() { return *instance; }
+    
+    void signal() { workAvailable.signal(); }
+    
+private:
+    std::unique_ptr<juce::AudioPluginInstance> instance;
+    const juce::String identifier;
+    const double sampleRate;
+    const int maxBlockSize;
+    
+    std::vector<std::shared_ptr<Member>> members;
+    std::vector<bool> isLive;
+    int numTotalChannels = 0;
+    juce::AudioBuffer<float> wideBuffer;
+    juce::MidiBuffer midiMessages;
+    juce::WaitableEvent workAvailable;
+    std::atomic<bool> paused { false };
+    
+    // 이만큼 블록을 넣지 않은 멤버(트랙이 멈췄거나 호스트가 건너뜀)는 기다리지 않음
+    static constexpr juce::uint32 staleMilliseconds = 100;
+    
+    void prepareAndStart()
+    {
+        instance->setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        instance->prepareToPlay(sampleRate, maxBlockSize);
+        
+        const auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(maxBlockSize, sampleRate);
+        if (!startRealtimeThread(options))
+        {
+            startThread(juce::Thread::Priority::highest);
+        }
+    }
+    
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            workAvailable.wait(5);
+            processAvailableBlocks();
+        }
+    }
+    
+    void processAvailableBlocks()
+    {
+        float* channels[256] = {};
+        
+        while (!threadShouldExit())
+        {
+            // 살아 있는 멤버 모두에게 입력이 있고 결과를 넣을 자리가 있는 만큼만 한 번에 처리
+            const auto now = juce::Time::getMillisecondCounter();
+            auto numSamples = maxBlockSize;
+            auto hasLiveMember = false;
+            
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                auto& member = *members[i];
+                
+                // 링이 넘쳐 끊긴 멤버는 오디오 스레드가 링을 건드리지 않으므로 여기서 비우고 다시 연결하게 함
+                if (member.linkState.load(std::memory_order_acquire) == Member::LinkState::unlinked)
+                {
+                    member.resync();
+                }
+                
+                isLive[i] = member.linkState.load(std::memory_order_relaxed) == Member::LinkState::linked
+                         && now - member.lastDepositMilliseconds.load() < staleMilliseconds;
+                if (!isLive[i]) { continue; }
+                
+                hasLiveMember = true;
+                numSamples = juce::jmin(numSamples, member.input.getNumReady(), member.output.getFreeSpace());
+            }
+            
+            if (!hasLiveMember || numSamples <= 0) { return; }
+            
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                auto& member = *members[i];
+                
+                for (int ch = 0; ch < member.numChannels; ++ch)
+                {
+                    channels[ch] = wideBuffer.getWritePointer(member.channelOffset + ch);
+                }
+                
+                if (isLive[i])
+                    member.input.read(channels, member.numChannels, numSamples);
+                else
+                    for (int ch = 0; ch < member.numChannels; ++ch) { juce::FloatVectorOperations::clear(channels[ch], numSamples); }
+            }
+            
+            juce::AudioBuffer<float> block(wideBuffer.getArrayOfWritePointers(), numTotalChannels, numSamples);
+            midiMessages.clear();
+            instance->processBlock(block, midiMessages);
+            
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                if (!isLive[i]) { continue; }
+                
+                auto& member = *members[i];
+                member.output.write(wideBuffer.getArrayOfReadPointers() + member.channelOffset, member.numChannels, numSamples);
+            }
+        }
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Group)
+};
+
+//==============================================================================
+SharedBatchEngine::Member::Member(Group& g, juce::AudioPluginInstance& source, int channels, int blockSize)
+    : group(g), sourceInstance(source), numChannels(channels), maxBlockSize(blockSize)
+{
+    // 입력이 밀려도 몇 블록은 버틸 수 있게 하고, 결과는 최대 블록만큼 무음을 미리 채워서 한 블록 늦게 받음
+    input.setSize(numChannels, ringBlocks * maxBlockSize);
+    output.setSize(numChannels, ringBlocks * maxBlockSize);
+    output.write(nullptr, numChannels, maxBlockSize);
+    sourceInstance.addListener(this);
+}
+
+SharedBatchEngine::Member::~Member()
+{
+    sourceInstance.removeListener(this);
+}
+
+void SharedBatchEngine::Member::setLatency(int newLatencySamples)
+{
+    auto newDelayLine = std::make_unique<juce::AudioBuffer<float>>(numChannels, newLatencySamples + maxBlockSize);
+    newDelayLine->clear();
+    
+    {
+        const juce::SpinLock::ScopedLockType sl(delayLineLock);
+        std::swap(pendingDelayLine, newDelayLine);
+        hasPendingDelayLine = true;
+    }
+    
+    // 오디오 스레드가 바꿔 끼우고 남긴 예전 지연선은 여기(메시지 스레드)에서 지움
+    newDelayLine.reset();
+    latencySamples.store(newLatencySamples);
+}
+
+void SharedBatchEngine::Member::resync()
+{
+    input.read(nullptr, numChannels, input.getNumReady());
+    output.read(nullptr, numChannels, output.getNumReady());
+    output.write(nullptr, numChannels, maxBlockSize);
+    linkState.store(LinkState::resynced, std::memory_order_release);
+}
+
+void SharedBatchEngine::Member::pushThroughDelay(const juce::AudioBuffer<float>& buffer, int numChannelsToUse, int numSamples)
+{
+    {
+        const juce::SpinLock::ScopedTryLockType tl(delayLineLock);
+        if (tl.isLocked() && hasPendingDelayLine)
+        {
+            std::swap(delayLine, *pendingDelayLine);
+            hasPendingDelayLine = false;
+            delayWritePosition = 0;
+        }
+    }
+    
+    const auto delayLength = delayLine.getNumSamples();
+    const auto delaySamples = juce::jmin(getLatencySamples(), delayLength - maxBlockSize);
+    const auto readPosition = (delayWritePosition - delaySamples + delayLength) % delayLength;
+    
+    for (int ch = 0; ch < numChannelsToUse; ++ch)
+    {
+        const auto firstWrite = juce::jmin(numSamples, delayLength - delayWritePosition);
+        delayLine.copyFrom(ch, delayWritePosition, buffer, ch, 0, firstWrite);
+        delayLine.copyFrom(ch, 0, buffer, ch, firstWrite, numSamples - firstWrite);
+        
+        const auto firstRead = juce::jmin(numSamples, delayLength - readPosition);
+        delayed.copyFrom(ch, 0, delayLine, ch, readPosition, firstRead);
+        delayed.copyFrom(ch, firstRead, delayLine, ch, 0, numSamples - firstRead);
+    }
+    
+    delayWritePosition = (delayWritePosition + numSamples) % delayLength;
+}
+
+void SharedBatchEngine::Member::process(juce::AudioBuffer<float>& buffer)
+{
+    const auto numSamples = buffer.getNumSamples();
+    const auto channels = juce::jmin(buffer.getNumChannels(), numChannels);
+    
+    if (numSamples > maxBlockSize || numSamples > delayed.getNumSamples()) { return; }
+    
+    pushThroughDelay(buffer, channels, numSamples);
+    
+    // 그룹 스레드가 링을 비우고 한 블록 지연을 다시 채워두었으면 다시 연결함
+    if (linkState.load(std::memory_order_acquire) == LinkState::resynced)
+    {
+        numOwedSamples = 0;
+        numPrimingSamples = maxBlockSize;
+        linkState.store(LinkState::linked, std::memory_order_relaxed);
+    }
+    
+    // 그룹 스레드가 밀려 링이 넘치면 샘플 수가 어긋나므로 그룹 스레드가 링을 비울 때까지 연결을 끊음
+    const auto isPaused = group.isPaused();
+    if (!isPaused && linkState.load(std::memory_order_relaxed) == LinkState::linked && input.getFreeSpace() < numSamples)
+    {
+        linkState.store(LinkState::unlinked, std::memory_order_release);
+    }
+    
+    // 끊긴 동안과 그룹을 다시 구성하는 동안(그룹 스레드가 멈춤)은 링에 넣지 않고 같은 지연의 원음으로 냄
+    if (isPaused || linkState.load(std::memory_order_relaxed) != LinkState::linked)
+    {
+        for (int ch = 0; ch < channels; ++ch) { buffer.copyFrom(ch, 0, delayed, ch, 0, numSamples); }
+        numFallbackSamples.fetch_add(numSamples, std::memory_order_relaxed);
+        return;
+    }
+    
+    input.write(buffer.getArrayOfReadPointers(), channels, numSamples);
+    lastDepositMilliseconds.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+    group.signal();
+    
+    // 앞에서 원음으로 대신 낸 만큼은 늦게 도착한 결과에서 버림
+    if (numOwedSamples > 0)
+    {
+        const auto numToDiscard = juce::jmin(numOwedSamples, output.getNumReady());
+        output.read(nullptr, channels, numToDiscard);
+        numOwedSamples -= numToDiscard;
+    }
+    
+    const auto numReady = numOwedSamples > 0 ? 0 : juce::jmin(numSamples, output.getNumReady());
+    output.read(buffer.getArrayOfWritePointers(), channels, numReady);
+    
+    // 다시 연결한 직후에는 그룹 스레드가 채워둔 무음 대신 같은 지연의 원음을 냄
+    const auto numPriming = juce::jmin(numPrimingSamples, numReady);
+    if (numPriming > 0)
+    {
+        for (int ch = 0; ch < channels; ++ch) { buffer.copyFrom(ch, 0, delayed, ch, 0, numPriming); }
+        numPrimingSamples -= numPriming;
+    }
+    
+    if (numReady < numSamples)
+    {
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            buffer.copyFrom(ch, numReady, delayed, ch, numReady, numSamples - numReady);
+        }
+        
+        numOwedSamples += numSamples - numReady;
+        numFallbackSamples.fetch_add(numSamples - numReady, std::memory_order_relaxed);
+    }
+}
+
+void SharedBatchEngine::Member::delayBlock(juce::AudioBuffer<float>& buffer)
+{
+    const auto numSamples = buffer.getNumSamples();
+    const auto channels = juce::jmin(buffer.getNumChannels(), numChannels);
+    
+    if (numSamples > delayed.getNumSamples()) { return; }
+    
+    pushThroughDelay(buffer, channels, numSamples);
+    for (int ch = 0; ch < channels; ++ch) { buffer.copyFrom(ch, 0, delayed, ch, 0, numSamples); }
+}
+
+juce::String SharedBatchEngine::Member::getStatus() const
+{
+    if (linkState.load() != LinkState::linked) { return "out of sync, passing dry until resynced"; }
+    
+    return juce::String(group.getNumMembers()) + " instances, " + juce::String(group.getNumTotalChannels()) + " channels in one call";
+}
+
+void SharedBatchEngine::Member::audioProcessorParameterChanged(juce::AudioProcessor*, int parameterIndex, float newValue)
+{
+    // 공유 인스턴스는 모든 멤버가 같은 설정이라고 가정하므로 어느 멤버에서 바꿔도 그대로 반영
+    if (auto* parameter = group.getInstance().getParameters()[parameterIndex])
+    {
+        parameter->setValue(newValue);
+    }
+}
+
+//==============================================================================
+SharedBatchEngine::SharedBatchEngine()
+{
+    formatManager.addDefaultFormats();
+}
+
+SharedBatchEngine::~SharedBatchEngine() = default;
+
+bool SharedBatchEngine::setChannelCount(juce::AudioPluginInstance& instance, int numChannels)
+{
+    // 알려진 레이아웃이 있으면 그것부터, 없으면 이름 없는 채널 묶음으로 요청
+    for (const auto& channelSet : { juce::AudioChannelSet::canonicalChannelSet(numChannels),
+                                    juce::AudioChannelSet::discreteChannels(numChannels) })
+    {
+        if (channelSet.size() != numChannels) { continue; }
+        
+        auto layout = instance.getBusesLayout();
+        if (layout.inputBuses.isEmpty() || layout.outputBuses.isEmpty()) { return false; }
+        
+        for (auto& bus : layout.inputBuses)  { bus = juce::AudioChannelSet::disabled(); }
+        for (auto& bus : layout.outputBuses) { bus = juce::AudioChannelSet::disabled(); }
+        layout.inputBuses.getReference(0) = channelSet;
+        layout.outputBuses.getReference(0) = channelSet;
+        
+        if (instance.checkBusesLayoutSupported(layout) && instance.setBusesLayout(layout)) { return true; }
+    }
+    
+    return false;
+}
+
+std::shared_ptr<SharedBatchEngine::Member> SharedBatchEngine::join(const juce::String& groupId,
+                                                                   juce::AudioPluginInstance& sourceInstance,
+                                                                   int numChannels,
+                                                                   double sampleRate,
+                                                                   int maxBlockSize,
+                                                                   juce::String& error)
+{
+    const juce::ScopedLock sl(lock);
+    
+    const auto description = sourceInstance.getPluginDescription();
+    auto& group = groups[groupId];
+    
+    if (group == nullptr)
+    {
+        auto instance = formatManager.createPluginInstance(description, sampleRate, maxBlockSize, error);
+        if (instance == nullptr)
+        {
+            groups.erase(groupId);
+            return nullptr;
+        }
+        
+        // 그룹의 설정은 처음 들어온 인스턴스의 상태를 따름
+        juce::MemoryBlock state;
+        sourceInstance.getStateInformation(state);
+        if (!state.isEmpty()) { instance->setStateInformation(state.getData(), (int) state.getSize()); }
+        
+        group = std::make_unique<Group>(std::move(instance), sampleRate, maxBlockSize);
+    }
+    else if (!group->matches(description.createIdentifierString(), sampleRate, maxBlockSize))
+    {
+        error = "Batch group " + groupId + " runs a different plugin or sample rate";
+        return nullptr;
+    }
+    
+    std::shared_ptr<Member> member(new Member(*group, sourceInstance, numChannels, maxBlockSize));
+    
+    auto members = group->getMembers();
+    members.push_back(member);
+    
+    if (!group->rebuild(members))
+    {
+        error = "Plugin cannot process " + juce::String(group->getNumTotalChannels() + numChannels) + " channels in one call";
+        if (group->isEmpty()) { groups.erase(groupId); }
+        return nullptr;
+    }
+    
+    // 새 멤버는 아직 오디오 스레드가 쓰지 않으므로 바로 준비함
+    const auto latency = maxBlockSize + group->getPluginLatencySamples();
+    member->latencySamples.store(latency);
+    member->delayLine.setSize(numChannels, latency + maxBlockSize);
+    member->delayLine.clear();
+    member->delayed.setSize(numChannels, maxBlockSize);
+    
+    updateLatency(*group);
+    return member;
+}
+
+void SharedBatchEngine::updateLatency(Group& group)
+{
+    // 채널 수가 바뀌면 공유 인스턴스의 지연도 바뀔 수 있으므로 남은 멤버의 지연선을 새 지연에 맞춤
+    const auto latency = group.getMaxBlockSize() + group.getPluginLatencySamples();
+    
+    for (const auto& member : group.getMembers())
+    {
+        if (member->getLatencySamples() != latency) { member->setLatency(latency); }
+    }
+}
+
+void SharedBatchEngine::leave(std::shared_ptr<Member> member)
+{
+    if (member == nullptr) { return; }
+    
+    const juce::ScopedLock sl(lock);
+    
+    for (auto it = groups.begin(); it != groups.end(); ++it)
+    {
+        auto& group = *it->second;
+        if (&group != &member->group) { continue; }
+        
+        auto members = group.getMembers();
+        members.erase(std::remove(members.begin(), members.end(), member), members.end());
+        group.rebuild(members);
+        
+        if (group.isEmpty())
+        {
+            groups.erase(it);
+            return;
+        }
+        
+        updateLatency(group);
+        return;
+    }
+}
+
+std::vector<SharedBatchEngine::MeasureResult> SharedBatchEngine::measure(juce::AudioPluginFormatManager& manager,
+                                                                         const juce::PluginDescription& description,
+                                                                         const std::vector<int>& instanceCounts,
+                                                                         double sampleRate,
+                                                                         int blockSize,
+                                                                         double secondsOfAudio)
+{
+    std::vector<MeasureResult> results;
+    const auto numBlocks = (int) (secondsOfAudio * sampleRate / blockSize);
+    juce::Random random;
+    
+    auto createInstance = [&](int numChannels) -> std::unique_ptr<juce::AudioPluginInstance>
+    {
+        juce::String error;
+        auto instance = manager.createPluginInstance(description, sampleRate, blockSize, error);
+        if (instance == nullptr || !setChannelCount(*instance, numChannels)) { return nullptr; }
+        
+        instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        instance->prepareToPlay(sampleRate, blockSize);
+        return instance;
+    };
+    
+    auto fillWithNoise = [&](juce::AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            for (int s = 0; s < buffer.getNumSamples(); ++s) { buffer.setSample(ch, s, random.nextFloat() * 0.5f - 0.25f); }
+        }
+    };
+    
+    for (const auto numInstances : instanceCounts)
+    {
+        MeasureResult result { numInstances, 2 * numInstances, false, 0.0, 0.0 };
+        juce::MidiBuffer midiMessages;
+        
+        // 따로: 스테레오 인스턴스마다 한 번씩 호출
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> separate;
+        for (int i = 0; i < numInstances; ++i)
+        {
+            if (auto instance = createInstance(2)) { separate.push_back(std::move(instance)); }
+        }
+        
+        std::vector<juce::AudioBuffer<float>> inputs((size_t) numInstances, juce::AudioBuffer<float>(2, blockSize));
+        for (auto& input : inputs) { fillWithNoise(input); }
+        
+        if ((int) separate.size() == numInstances)
+        {
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            const auto start = juce::Time::getHighResolutionTicks();
+            
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    buffer.makeCopyOf(inputs[(size_t) i], true);
+                    midiMessages.clear();
+                    separate[(size_t) i]->processBlock(buffer, midiMessages);
+                }
+            }
+            
+            result.separateMilliseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+        }
+        
+        for (auto& instance : separate) { instance->releaseResources(); }
+        separate.clear();
+        
+        // 모아서: 채널을 넓은 버퍼에 모으고 한 번 호출한 뒤 다시 나눔 (엔진의 복사 비용 포함)
+        if (auto wide = createInstance(result.numChannels))
+        {
+            result.isSupported = true;
+            juce::AudioBuffer<float> wideBuffer(result.numChannels, blockSize);
+            juce::AudioBuffer<float> outputs(result.numChannels, blockSize);
+            const auto start = juce::Time::getHighResolutionTicks();
+            
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    for (int ch = 0; ch < 2; ++ch) { wideBuffer.copyFrom(2 * i + ch, 0, inputs[(size_t) i], ch, 0, blockSize); }
+                }
+                
+                midiMessages.clear();
+                wide->processBlock(wideBuffer, midiMessages);
+                
+                for (int ch = 0; ch < result.numChannels; ++ch) { outputs.copyFrom(ch, 0, wideBuffer, ch, 0, blockSize); }
+            }
+            
+            result.batchedMilliseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+            wide->releaseResources();
+        }
+        
+        results.push_back(result);
+    }
+    
+    return results;
+}
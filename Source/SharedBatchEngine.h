@@ -0,0 +1,140 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 같은 그룹 ID 의 래퍼 인스턴스들이 호스팅 플러그인 하나를 넓은 다채널 호출 한 번으로 나눠 쓰는 엔진 (모든 래퍼 인스턴스가 공유)
+// 각 래퍼는 자기 채널을 락 없는 링에 넣고 한 블록 늦은 결과를 꺼내기만 하며,
+// 그룹의 실시간 스레드가 최근에 블록을 넣은 멤버들의 채널을 모아서 처리한 뒤 다시 나눠줌
+// 플러그인이 그 채널 수의 레이아웃을 받지 못하면 그룹에 들어가지 않음
+class SharedBatchEngine
+{
+public:
+    class Member;
+    
+    SharedBatchEngine();
+    ~SharedBatchEngine();
+    
+    // 메시지 스레드에서 호출: sourceInstance 의 설명과 상태로 그룹의 공유 인스턴스를 만들고, 파라미터 변경을 공유 인스턴스에 반영함
+    std::shared_ptr<Member> join(const juce::String& groupId,
+                                 juce::AudioPluginInstance& sourceInstance,
+                                 int numChannels,
+                                 double sampleRate,
+                                 int maxBlockSize,
+                                 juce::String& error);
+    void leave(std::shared_ptr<Member> member);
+    
+    struct MeasureResult
+    {
+        int numInstances;
+        int numChannels;
+        bool isSupported;
+        double separateMilliseconds;
+        double batchedMilliseconds;
+    };
+    
+    // 스테레오 인스턴스 여러 개를 따로 부를 때와 넓은 인스턴스 하나로 모아서 부를 때의 CPU 시간 (VST3LoaderHost --batch-benchmark)
+    static std::vector<MeasureResult> measure(juce::AudioPluginFormatManager& formatManager,
+                                              const juce::PluginDescription& description,
+                                              const std::vector<int>& instanceCounts,
+                                              double sampleRate = 48000.0,
+                                              int blockSize = 512,
+                                              double secondsOfAudio = 10.0);
+    
+    static bool setChannelCount(juce::AudioPluginInstance& instance, int numChannels);
+    
+private:
+    class Group;
+    
+    juce::CriticalSection lock;
+    juce::AudioPluginFormatManager formatManager;
+    std::map<juce::String, std::unique_ptr<Group>> groups;
+    
+    void updateLatency(Group& group);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedBatchEngine)
+};
+
+// 단일 생산자/단일 소비자 샘플 링 (쓰는 쪽과 읽는 쪽이 각각 한 스레드)
+class BatchSampleRing
+{
+public:
+    void setSize(int numChannels, int numSamples);
+    int getNumReady() const;
+    int getFreeSpace() const;
+    
+    // channels 가 nullptr 이면 무음을 쓰거나 읽은 만큼 버림
+    void write(const float* const* channels, int numChannels, int numSamples);
+    void read(float* const* channels, int numChannels, int numSamples);
+    
+private:
+    juce::AudioBuffer<float> buffer;
+    std::atomic<juce::int64> numWritten { 0 };
+    std::atomic<juce::int64> numRead { 0 };
+};
+
+class SharedBatchEngine::Member : private juce::AudioProcessorListener
+{
+public:
+    ~Member() override;
+    
+    // 오디오 스레드에서 호출: 입력을 넣고 한 블록 늦은 결과를 꺼냄. 결과가 없으면 같은 지연의 원음을 냄
+    void process(juce::AudioBuffer<float>& buffer);
+    
+    // 오프라인 렌더링처럼 래퍼가 자기 인스턴스로 직접 처리할 때, 연결 모드와 같은 지연이 되도록 결과를 늦춤
+    void delayBlock(juce::AudioBuffer<float>& buffer);
+    
+    // 다른 트랙이 들어오거나 나가서 그룹의 지연이 바뀔 수 있음. 래퍼는 달라지면 호스트에 다시 알려야 함
+    int getLatencySamples() const { return latencySamples.load(); }
+    juce::int64 getNumFallbackSamples() const { return numFallbackSamples.load(); }
+    juce::String getStatus() const;
+    
+private:
+    friend class SharedBatchEngine;
+    friend class Group;
+    
+    Member(Group& group, juce::AudioPluginInstance& source, int numChannels, int maxBlockSize);
+    
+    // 링이 넘치면 오디오 스레드가 unlinked 로 바꾸고 링을 건드리지 않음
+    // 그룹 스레드가 링을 비우고 한 블록 지연을 다시 채운 뒤 resynced 로 바꾸면 오디오 스레드가 다시 연결함
+    enum class LinkState
+    {
+        linked,
+        unlinked,
+        resynced
+    };
+    
+    Group& group;
+    juce::AudioPluginInstance& sourceInstance;
+    const int numChannels;
+    const int maxBlockSize;
+    int channelOffset = 0; // 그룹 스레드가 멈춘 동안에만 바뀜
+    
+    BatchSampleRing input;
+    BatchSampleRing output;
+    std::atomic<LinkState> linkState { LinkState::linked };
+    std::atomic<juce::uint32> lastDepositMilliseconds { 0 };
+    std::atomic<int> latencySamples { 0 };
+    std::atomic<juce::int64> numFallbackSamples { 0 };
+    
+    // 오디오 스레드 전용
+    juce::AudioBuffer<float> delayLine;
+    juce::AudioBuffer<float> delayed;
+    int delayWritePosition = 0;
+    int numOwedSamples = 0;
+    int numPrimingSamples = 0;
+    
+    // 지연이 바뀌면 메시지 스레드가 새 크기의 지연선을 만들어두고 오디오 스레드가 다음 블록에서 바꿔 끼움
+    juce::SpinLock delayLineLock;
+    std::unique_ptr<juce::AudioBuffer<float>> pendingDelayLine;
+    bool hasPendingDelayLine = false;
+    
+    static constexpr int ringBlocks = 8;
+    
+    void setLatency(int newLatencySamples);
+    void resync();
+    void pushThroughDelay(const juce::AudioBuffer<float>& buffer, int numChannelsToUse, int numSamples);
+    
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int parameterIndex, float newValue) override;
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Member)
+};
@@ -0,0 +1,419 @@
+#include "StateHistory.h"
+
+// 모든 래퍼 인스턴스가 같이 쓰는 저우선순위 스레드
+// 처음 만들 때 오래된 체크포인트(닫히지 않고 남은 세션)를 정리함
+class StateHistory::CheckpointThread : public juce::TimeSliceThread
+{
+public:
+    CheckpointThread() : juce::TimeSliceThread("VST3 Loader state history")
+    {
+        const auto cutoff = juce::Time::getCurrentTime() - juce::RelativeTime::days(14);
+        for (const auto& directory : getRecoveryDirectory().findChildFiles(juce::File::findDirectories, false))
+        {
+            if (directory.getLastModificationTime() < cutoff) { directory.deleteRecursively(); }
+        }
+        
+        startThread(juce::Thread::Priority::low);
+    }
+    
+    ~CheckpointThread() override { stopThread(5000); }
+    
+    // 같은 세션 상태가 복제되어도 두 인스턴스가 한 디렉터리에 쓰지 않도록 사용 중인 id 를 기억
+    juce::CriticalSection idLock;
+    juce::StringArray liveInstanceIds;
+};
+
+StateHistory::StateHistory()
+    : instanceId(juce::Uuid().toString())
+{
+    const juce::ScopedLock sl(checkpointThread->idLock);
+    checkpointThread->liveInstanceIds.add(instanceId);
+}
+
+StateHistory::~StateHistory()
+{
+    stop();
+    
+    // 정상 종료: 복구할 일이 없으므로 체크포인트를 지움
+    getCheckpointDirectory().deleteRecursively();
+    
+    const juce::ScopedLock sl(checkpointThread->idLock);
+    checkpointThread->liveInstanceIds.removeString(instanceId);
+}
+
+void StateHistory::start()
+{
+    checkpointThread->addTimeSliceClient(this);
+    startTimer(idleIntervalMs);
+}
+
+void StateHistory::stop()
+{
+    stopTimer();
+    checkpointThread->removeTimeSliceClient(this);
+}
+
+void StateHistory::attach(juce::AudioPluginInstance& instance)
+{
+    instance.addListener(this);
+}
+
+void StateHistory::detach(juce::AudioPluginInstance& instance)
+{
+    instance.removeListener(this);
+}
+
+void StateHistory::clear(const juce::String& pluginPath)
+{
+    const juce::ScopedLock sl(lock);
+    
+    segments.clear();
+    totalBytes = 0;
+    currentPluginPath = pluginPath;
+    
+    {
+        // 이전 플러그인에서 읽어두고 아직 저장하지 않은 상태는 버림
+        const juce::ScopedLock pendingSl(pendingLock);
+        pendingState.reset();
+        hasPendingState = false;
+    }
+    
+    const auto directory = getCheckpointDirectory();
+    directory.deleteRecursively();
+    
+    if (pluginPath.isNotEmpty())
+    {
+        directory.createDirectory();
+        
+        juce::XmlElement session("session");
+        session.createNewChildElement("plugin_path")->addTextElement(pluginPath);
+        session.writeTo(directory.getChildFile("session.xml"));
+    }
+    
+    // 로드 직후 상태를 첫 단계로 남김
+    markEdited();
+}
+
+void StateHistory::markEdited()
+{
+    lastEditTime.store(juce::Time::getMillisecondCounter());
+    isDirty.store(true);
+}
+
+void StateHistory::audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails& details)
+{
+    if (details.programChanged || details.nonParameterStateChanged || details.parameterInfoChanged)
+    {
+        markEdited();
+    }
+}
+
+void StateHistory::timerCallback()
+{
+    if (!isDirty.load()) { return; }
+    
+    // 드래그 중인 노브처럼 편집이 이어지는 동안은 기다림
+    const auto sinceEdit = (int) (juce::Time::getMillisecondCounter() - lastEditTime.load());
+    if (sinceEdit < quietPeriodMs) { return; }
+    
+    isDirty.store(false);
+    
+    // 호스트처럼 메시지 스레드에서 읽음. 델타 계산과 디스크 쓰기는 백그라운드 스레드에 맡김
+    juce::MemoryBlock state;
+    if (captureState == nullptr || !captureState(state) || state.isEmpty()) { return; }
+    
+    const juce::ScopedLock sl(pendingLock);
+    pendingState = std::move(state);
+    hasPendingState = true;
+}
+
+int StateHistory::useTimeSlice()
+{
+    juce::MemoryBlock state;
+    {
+        const juce::ScopedLock sl(pendingLock);
+        if (!hasPendingState) { return idleIntervalMs; }
+        
+        state = std::move(pendingState);
+        hasPendingState = false;
+    }
+    
+    store(state);
+    return idleIntervalMs;
+}
+
+void StateHistory::store(const juce::MemoryBlock& state)
+{
+    const juce::ScopedLock sl(lock);
+    if (currentPluginPath.isEmpty()) { return; }
+    
+    auto delta = segments.empty() ? juce::MemoryBlock() : createDelta(segments.back().base, state);
+    
+    if (!segments.empty() && !segments.back().steps.empty() && segments.back().steps.back().delta == delta)
+    {
+        return;
+    }
+    
+    // 바뀐 부분이 많으면 새 기준 상태로 시작
+    if (segments.empty() || delta.getSize() > segments.back().base.getSize() / 2)
+    {
+        Segment segment { nextSegmentNumber++, state, {} };
+        delta = createDelta(segment.base, state);
+        totalBytes += segment.base.getSize();
+        
+        getSegmentFile(segment.number, ".base").replaceWithData(state.getData(), state.getSize());
+        segments.push_back(std::move(segment));
+    }
+    
+    auto& segment = segments.back();
+    totalBytes += delta.getSize();
+    segment.steps.push_back({ juce::Time::getCurrentTime(), delta, state.getSize() });
+    
+    // 레코드: 길이(4바이트) + 델타. 쓰다가 죽어서 잘린 마지막 레코드는 읽을 때 버림
+    juce::FileOutputStream output(getSegmentFile(segment.number, ".deltas"));
+    if (output.openedOk())
+    {
+        output.writeInt((int) delta.getSize());
+        output.write(delta.getData(), delta.getSize());
+        output.flush();
+    }
+    
+    evictIfNeeded();
+}
+
+void StateHistory::evictIfNeeded()
+{
+    auto numSteps = 0;
+    for (const auto& segment : segments) { numSteps += (int) segment.steps.size(); }
+    
+    // 가장 최근 기준 상태는 항상 남김
+    while ((numSteps > maxSteps || totalBytes > maxTotalBytes) && numSteps > 1)
+    {
+        auto& oldest = segments.front();
+        
+        if (!oldest.steps.empty())
+        {
+            totalBytes -= oldest.steps.front().delta.getSize();
+            oldest.steps.erase(oldest.steps.begin());
+            --numSteps;
+        }
+        
+        if (oldest.steps.empty() && segments.size() > 1)
+        {
+            totalBytes -= oldest.base.getSize();
+            getSegmentFile(oldest.number, ".base").deleteFile();
+            getSegmentFile(oldest.number, ".deltas").deleteFile();
+            segments.erase(segments.begin());
+        }
+    }
+}
+
+std::vector<StateHistory::StepInfo> StateHistory::getSteps() const
+{
+    const juce::ScopedLock sl(lock);
+    
+    std::vector<StepInfo> result;
+    for (const auto& segment : segments)
+    {
+        for (size_t i = 0; i < segment.steps.size(); ++i)
+        {
+            const auto& step = segment.steps[i];
+            const auto storedBytes = step.delta.getSize() + (i == 0 ? segment.base.getSize() : 0);
+            result.push_back({ step.time, step.stateBytes, storedBytes });
+        }
+    }
+    return result;
+}
+
+bool StateHistory::getStepState(int index, juce::MemoryBlock& result) const
+{
+    const juce::ScopedLock sl(lock);
+    
+    for (const auto& segment : segments)
+    {
+        if (index < (int) segment.steps.size())
+        {
+            return index >= 0 && applyDelta(segment.base, segment.steps[(size_t) index].delta, result);
+        }
+        index -= (int) segment.steps.size();
+    }
+    return false;
+}
+
+juce::String StateHistory::getInstanceId() const
+{
+    const juce::ScopedLock sl(lock);
+    return instanceId;
+}
+
+void StateHistory::setInstanceId(const juce::String& id)
+{
+    const juce::ScopedLock sl(lock);
+    if (id.isEmpty() || id == instanceId) { return; }
+    
+    {
+        const juce::ScopedLock idSl(checkpointThread->idLock);
+        if (checkpointThread->liveInstanceIds.contains(id)) { return; }
+        
+        checkpointThread->liveInstanceIds.removeString(instanceId);
+        checkpointThread->liveInstanceIds.add(id);
+    }
+    
+    getCheckpointDirectory().deleteRecursively();
+    instanceId = id;
+    
+    // 이 id 의 체크포인트가 남아 있으면 지난번에 정상 종료되지 않은 것
+    const auto previous = getCheckpointDirectory();
+    if (previous.isDirectory())
+    {
+        const auto recovered = previous.getSiblingFile(id + ".recovered");
+        recovered.deleteRecursively();
+        previous.moveFileTo(recovered);
+    }
+    
+    const auto pluginPath = currentPluginPath;
+    segments.clear();
+    totalBytes = 0;
+    currentPluginPath = {};
+    
+    if (pluginPath.isNotEmpty()) { clear(pluginPath); }
+}
+
+bool StateHistory::hasRecoverableState() const
+{
+    juce::String pluginPath;
+    juce::MemoryBlock state;
+    return readCheckpoint(getCheckpointDirectory().getSiblingFile(getInstanceId() + ".recovered"), pluginPath, state);
+}
+
+bool StateHistory::takeRecoverableState(juce::String& pluginPath, juce::MemoryBlock& state)
+{
+    const auto directory = getCheckpointDirectory().getSiblingFile(getInstanceId() + ".recovered");
+    const auto found = readCheckpoint(directory, pluginPath, state);
+    directory.deleteRecursively();
+    return found;
+}
+
+bool StateHistory::readCheckpoint(const juce::File& directory, juce::String& pluginPath, juce::MemoryBlock& state)
+{
+    auto session = juce::XmlDocument::parse(directory.getChildFile("session.xml"));
+    if (session == nullptr) { return false; }
+    
+    pluginPath = session->getChildElementAllSubText("plugin_path", {});
+    
+    // 가장 최근 기준 상태와 그 델타 파일의 마지막 온전한 레코드
+    auto latestNumber = -1;
+    for (const auto& file : directory.findChildFiles(juce::File::findFiles, false, "*.base"))
+    {
+        latestNumber = juce::jmax(latestNumber, file.getFileNameWithoutExtension().getIntValue());
+    }
+    
+    juce::MemoryBlock base;
+    if (latestNumber < 0 || !directory.getChildFile(juce::String(latestNumber) + ".base").loadFileAsData(base))
+    {
+        return false;
+    }
+    
+    juce::MemoryBlock lastDelta;
+    juce::FileInputStream input(directory.getChildFile(juce::String(latestNumber) + ".deltas"));
+    
+    while (input.openedOk() && input.getNumBytesRemaining() >= 4)
+    {
+        const auto size = input.readInt();
+        if (size < 0 || input.getNumBytesRemaining() < size) { break; }
+        
+        lastDelta.setSize((size_t) size);
+        input.read(lastDelta.getData(), size);
+    }
+    
+    if (lastDelta.isEmpty())
+    {
+        state = base;
+        return true;
+    }
+    
+    return applyDelta(base, lastDelta, state);
+}
+
+juce::MemoryBlock StateHistory::createDelta(const juce::MemoryBlock& base, const juce::MemoryBlock& state)
+{
+    // 형식: 새 크기, 그리고 (오프셋, 길이, 바이트) 런의 목록. 기준과 다른 블록만 담음
+    juce::MemoryOutputStream output;
+    output.writeInt((int) state.getSize());
+    
+    const auto* baseData = static_cast<const char*>(base.getData());
+    const auto* stateData = static_cast<const char*>(state.getData());
+    const auto stateSize = (int) state.getSize();
+    const auto baseSize = (int) base.getSize();
+    
+    auto runStart = -1;
+    
+    for (int offset = 0; offset <= stateSize; offset += deltaBlockSize)
+    {
+        const auto length = juce::jmin(deltaBlockSize, stateSize - offset);
+        const auto differs = length > 0
+                          && (offset + length > baseSize || std::memcmp(baseData + offset, stateData + offset, (size_t) length) != 0);
+        
+        if (differs && runStart < 0) { runStart = offset; }
+        
+        if (!differs && runStart >= 0)
+        {
+            output.writeInt(runStart);
+            output.writeInt(offset - runStart);
+            output.write(stateData + runStart, (size_t) (offset - runStart));
+            runStart = -1;
+        }
+    }
+    
+    if (runStart >= 0)
+    {
+        output.writeInt(runStart);
+        output.writeInt(stateSize - runStart);
+        output.write(stateData + runStart, (size_t) (stateSize - runStart));
+    }
+    
+    return output.getMemoryBlock();
+}
+
+bool StateHistory::applyDelta(const juce::MemoryBlock& base, const juce::MemoryBlock& delta, juce::MemoryBlock& result)
+{
+    if (delta.isEmpty())
+    {
+        result = base;
+        return true;
+    }
+    
+    juce::MemoryInputStream input(delta, false);
+    const auto size = input.readInt();
+    if (size < 0) { return false; }
+    
+    result.setSize((size_t) size, true);
+    result.copyFrom(base.getData(), 0, juce::jmin((size_t) size, base.getSize()));
+    
+    while (input.getNumBytesRemaining() >= 8)
+    {
+        const auto offset = input.readInt();
+        const auto length = input.readInt();
+        
+        if (offset < 0 || length < 0 || offset + length > size || input.getNumBytesRemaining() < length) { return false; }
+        input.read(static_cast<char*>(result.getData()) + offset, length);
+    }
+    
+    return true;
+}
+
+juce::File StateHistory::getRecoveryDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("Application Support/VST3 Loader/Recovery");
+}
+
+juce::File StateHistory::getCheckpointDirectory() const
+{
+    return getRecoveryDirectory().getChildFile(getInstanceId());
+}
+
+juce::File StateHistory::getSegmentFile(int number, const char* extension) const
+{
+    return getCheckpointDirectory().getChildFile(juce::String(number) + extension);
+}
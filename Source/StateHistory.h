@@ -0,0 +1,101 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 호스팅 플러그인 상태의 제한된 변경 기록
+// - 편집이 끝나고 잠시 조용해지면 메시지 스레드에서 상태를 읽고, 공용 백그라운드 스레드에서 기준 상태에 대한 바이너리 델타로 저장
+// - 델타가 기준 상태의 절반을 넘으면 현재 상태를 새 기준으로 삼음 (단계당 메모리는 바뀐 만큼만 씀)
+// - 기준 상태와 델타를 디스크에 이어 써서, 호스트가 죽어도 다음에 세션을 열 때 마지막 상태를 복구할 수 있음
+class StateHistory : private juce::TimeSliceClient,
+                     private juce::Timer,
+                     private juce::AudioProcessorListener
+{
+public:
+    struct StepInfo
+    {
+        juce::Time time;
+        size_t stateBytes;
+        size_t storedBytes;
+    };
+    
+    StateHistory();
+    ~StateHistory() override;
+    
+    // 메시지 스레드에서 불림
+    std::function<bool(juce::MemoryBlock&)> captureState;
+    
+    void start();
+    void stop();
+    
+    // 메시지 스레드에서 호출
+    void attach(juce::AudioPluginInstance& instance);
+    void detach(juce::AudioPluginInstance& instance);
+    void clear(const juce::String& pluginPath);
+    
+    std::vector<StepInfo> getSteps() const;
+    bool getStepState(int index, juce::MemoryBlock& result) const;
+    
+    // 세션 상태에 저장되는 인스턴스 id. 이전에 죽은 세션의 체크포인트가 있으면 복구용으로 옮겨둠
+    juce::String getInstanceId() const;
+    void setInstanceId(const juce::String& id);
+    bool hasRecoverableState() const;
+    bool takeRecoverableState(juce::String& pluginPath, juce::MemoryBlock& state);
+    
+    static juce::MemoryBlock createDelta(const juce::MemoryBlock& base, const juce::MemoryBlock& state);
+    static bool applyDelta(const juce::MemoryBlock& base, const juce::MemoryBlock& delta, juce::MemoryBlock& result);
+    static juce::File getRecoveryDirectory();
+    
+private:
+    class CheckpointThread;
+    
+    struct Step
+    {
+        juce::Time time;
+        juce::MemoryBlock delta;
+        size_t stateBytes;
+    };
+    
+    struct Segment
+    {
+        int number;
+        juce::MemoryBlock base;
+        std::vector<Step> steps;
+    };
+    
+    juce::SharedResourcePointer<CheckpointThread> checkpointThread;
+    juce::CriticalSection lock;
+    std::vector<Segment> segments;
+    size_t totalBytes = 0;
+    int nextSegmentNumber = 0;
+    juce::String instanceId;
+    juce::String currentPluginPath;
+    
+    std::atomic<bool> isDirty { false };
+    std::atomic<juce::uint32> lastEditTime { 0 };
+    
+    // 메시지 스레드가 읽은 상태를 백그라운드 스레드로 넘김
+    juce::CriticalSection pendingLock;
+    juce::MemoryBlock pendingState;
+    bool hasPendingState = false;
+    
+    static constexpr int maxSteps = 100;
+    static constexpr size_t maxTotalBytes = 32 * 1024 * 1024;
+    static constexpr int deltaBlockSize = 64;
+    static constexpr int quietPeriodMs = 500;
+    static constexpr int idleIntervalMs = 250;
+    
+    void markEdited();
+    void store(const juce::MemoryBlock& state);
+    void evictIfNeeded();
+    juce::File getCheckpointDirectory() const;
+    juce::File getSegmentFile(int number, const char* extension) const;
+    static bool readCheckpoint(const juce::File& directory, juce::String& pluginPath, juce::MemoryBlock& state);
+    
+    int useTimeSlice() override;
+    void timerCallback() override;
+    
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails& details) override;
+    void audioProcessorParameterChangeGestureEnd(juce::AudioProcessor*, int) override { markEdited(); }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StateHistory)
+};
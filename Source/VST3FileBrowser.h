@@ -1,8 +1,9 @@
 #pragma once
 #include <JuceHeader.h>
+#include "PluginCostDatabase.h"
 
 class VST3ListBox : public juce::Component,
-                    public juce::ListBoxModel,
+                    public juce::TableListBoxModel,
                     public juce::TextEditor::Listener
 {
 public:
@@ -17,8 +18,32 @@ public:
         searchBox.addListener(this);
         addAndMakeVisible(searchBox);
         
-        // 리스트 박스
+        // 비용 필터 (측정한 적 없는 플러그인은 기준을 모르므로 빠짐)
+        costFilterBox.addItemList({ "All plugins", "Measured only", "CPU under 5%", "CPU under 20%",
+                                    "Loads under 1 s", "Memory under 100 MB" }, showAll + 1);
+        costFilterBox.setSelectedId(showAll + 1, juce::dontSendNotification);
+        costFilterBox.setColour(juce::ComboBox::textColourId, juce::Colour(0xffFFDFB9));
+        costFilterBox.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        costFilterBox.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xffA4193D));
+        costFilterBox.setColour(juce::ComboBox::arrowColourId, juce::Colour(0xffFFDFB9));
+        costFilterBox.onChange = [this]() { updateFilteredList(); };
+        addAndMakeVisible(costFilterBox);
+        
+        // 리스트 박스: 이름과 이전에 로드했을 때 잰 비용 (헤더를 누르면 정렬)
+        auto& header = listBox.getHeader();
+        header.addColumn("Plugin", nameColumn, 250, 120, -1, juce::TableHeaderComponent::defaultFlags);
+        header.addColumn("Load", loadColumn, 70, 50, 120, juce::TableHeaderComponent::defaultFlags);
+        header.addColumn("Memory", memoryColumn, 75, 50, 120, juce::TableHeaderComponent::defaultFlags);
+        header.addColumn("CPU", cpuColumn, 60, 45, 120, juce::TableHeaderComponent::defaultFlags);
+        header.addColumn("Peak", peakColumn, 60, 45, 120, juce::TableHeaderComponent::defaultFlags);
+        header.setStretchToFitActive(true);
+        header.setSortColumnId(nameColumn, true);
+        header.setColour(juce::TableHeaderComponent::textColourId, juce::Colour(0xffFFDFB9));
+        header.setColour(juce::TableHeaderComponent::backgroundColourId, juce::Colour(0xff2a2a2a));
+        header.setColour(juce::TableHeaderComponent::outlineColourId, juce::Colour(0xff1a1a1a));
+        
         listBox.setModel(this);
+        listBox.setHeaderHeight(22);
         listBox.setRowHeight(30);
         listBox.setColour(juce::ListBox::backgroundColourId, juce::Colour(0xff1a1a1a));
         listBox.setColour(juce::ListBox::outlineColourId, juce::Colours::transparentBlack);
@@ -30,10 +55,19 @@ public:
     void resized() override
     {
         auto area = getLocalBounds();
-        searchBox.setBounds(area.removeFromTop(35).reduced(5));
+        auto searchArea = area.removeFromTop(35).reduced(5);
+        costFilterBox.setBounds(searchArea.removeFromRight(170));
+        searchArea.removeFromRight(5);
+        searchBox.setBounds(searchArea);
         listBox.setBounds(area);
     }
     
+    void visibilityChanged() override
+    {
+        // 다른 인스턴스가 플러그인을 로드하고 잰 비용을 브라우저를 다시 열 때 반영
+        if (isVisible()) { updateFilteredList(); }
+    }
+    
     void scanPlugins()
     {
         allPlugins.clear();
@@ -56,6 +90,9 @@ public:
     
     void updateFilteredList()
     {
+        const auto selectedPlugin = getSelectedPlugin();
+        costs = costDatabase->getEntries();
+        
         filteredPlugins.clear();
         juce::String searchText = searchBox.getText().toLowerCase();
         
@@ -64,11 +101,19 @@ public:
             juce::File file(plugin);
             juce::String name = file.getFileNameWithoutExtension().toLowerCase();
             
-            if (searchText.isEmpty() || name.contains(searchText))
+            if ((searchText.isEmpty() || name.contains(searchText)) && passesCostFilter(plugin))
                 filteredPlugins.add(plugin);
         }
         
+        sortFilteredList();
         listBox.updateContent();
+        
+        if (filteredPlugins.contains(selectedPlugin))
+            listBox.selectRow(filteredPlugins.indexOf(selectedPlugin));
+        else
+            listBox.deselectAllRows();
+        
+        listBox.repaint();
     }
     
     void textEditorTextChanged(juce::TextEditor&) override
@@ -81,17 +126,31 @@ public:
         return filteredPlugins.size();
     }
     
-    void paintListBoxItem(int rowNumber, juce::Graphics& g,
-                         int width, int height, bool rowIsSelected) override
+    void paintRowBackground(juce::Graphics& g, int, int, int, bool rowIsSelected) override
     {
         if (rowIsSelected)
             g.fillAll(juce::Colour(0xffA4193D));
         else
             g.fillAll(juce::Colour(0xff1a1a1a));
-        
+    }
+    
+    void paintCell(juce::Graphics& g, int rowNumber, int columnId,
+                   int width, int height, bool rowIsSelected) override
+    {
         if (rowNumber >= filteredPlugins.size())
             return;
         
+        const auto& plugin = filteredPlugins[rowNumber];
+        
+        if (columnId != nameColumn)
+        {
+            g.setColour(juce::Colour(0xffFFDFB9).withAlpha(rowIsSelected ? 1.0f : 0.75f));
+            g.setFont(height * 0.42f);
+            g.drawText(getCostText(plugin, columnId), 0, 0, width - 8, height,
+                       juce::Justification::centredRight, true);
+            return;
+        }
+        
         // LP 아이콘 그리기
         const float iconSize = height * 0.6f;
         const float iconX = 10.0f;
@@ -109,7 +168,7 @@ public:
         g.fillEllipse(centerX, centerY, centerSize, centerSize);
         
         // 텍스트
-        juce::File file(filteredPlugins[rowNumber]);
+        juce::File file(plugin);
         g.setColour(rowIsSelected ? juce::Colour(0xffFFDFB9) : juce::Colour(0xffFFDFB9));
         g.setFont(height * 0.5f);
         g.drawText(file.getFileNameWithoutExtension(),
@@ -118,7 +177,23 @@ public:
                   juce::Justification::centredLeft, true);
     }
     
-    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override
+    juce::String getCellTooltip(int rowNumber, int) override
+    {
+        if (rowNumber < 0 || rowNumber >= filteredPlugins.size())
+            return {};
+        
+        const auto it = costs.find(filteredPlugins[rowNumber]);
+        return it != costs.end() ? it->second.getDetails() : juce::String("Not measured yet");
+    }
+    
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override
+    {
+        sortColumnId = newSortColumnId;
+        sortForwards = isForwards;
+        updateFilteredList();
+    }
+    
+    void cellDoubleClicked(int row, int, const juce::MouseEvent&) override
     {
         if (row >= 0 && row < filteredPlugins.size())
         {
@@ -143,8 +218,107 @@ public:
     std::function<void(const juce::String&)> onPluginSelected;
     
 private:
+    enum ColumnId
+    {
+        nameColumn = 1,
+        loadColumn,
+        memoryColumn,
+        cpuColumn,
+        peakColumn
+    };
+    
+    enum CostFilter
+    {
+        showAll,
+        showMeasured,
+        showCpuUnder5Percent,
+        showCpuUnder20Percent,
+        showLoadsUnder1Second,
+        showMemoryUnder100Megabytes
+    };
+    
     juce::TextEditor searchBox;
-    juce::ListBox listBox;
+    juce::ComboBox costFilterBox;
+    juce::TableListBox listBox;
+    juce::TooltipWindow tooltipWindow { this, 500 };
     juce::StringArray allPlugins;
     juce::StringArray filteredPlugins;
+    juce::SharedResourcePointer<PluginCostDatabase> costDatabase;
+    std::map<juce::String, PluginCostDatabase::Entry> costs;
+    int sortColumnId = nameColumn;
+    bool sortForwards = true;
+    
+    const PluginCostDatabase::Entry* findCost(const juce::String& plugin) const
+    {
+        const auto it = costs.find(plugin);
+        return it != costs.end() ? &it->second : nullptr;
+    }
+    
+    // 측정하지 않은 값은 -1
+    double getCostValue(const juce::String& plugin, int columnId) const
+    {
+        const auto* entry = findCost(plugin);
+        if (entry == nullptr) { return -1.0; }
+        
+        switch (columnId)
+        {
+            case loadColumn:   return entry->hasLoadCost() ? entry->loadMilliseconds : -1.0;
+            case memoryColumn: return entry->hasLoadCost() ? (double) entry->residentBytes : -1.0;
+            case cpuColumn:    return entry->hasCpuCost() ? entry->getAverageLoad() : -1.0;
+            case peakColumn:   return entry->hasCpuCost() ? entry->getWorstLoad() : -1.0;
+            default:           return -1.0;
+        }
+    }
+    
+    juce::String getCostText(const juce::String& plugin, int columnId) const
+    {
+        const auto value = getCostValue(plugin, columnId);
+        if (value < 0.0) { return "-"; }
+        
+        switch (columnId)
+        {
+            case loadColumn:   return value >= 1000.0 ? juce::String(value / 1000.0, 1) + " s"
+                                                      : juce::String(juce::roundToInt(value)) + " ms";
+            case memoryColumn: return juce::String(juce::roundToInt(value / (1024.0 * 1024.0))) + " MB";
+            case cpuColumn:
+            case peakColumn:   return juce::String(value * 100.0, 1) + "%";
+            default:           return {};
+        }
+    }
+    
+    bool passesCostFilter(const juce::String& plugin) const
+    {
+        const auto* entry = findCost(plugin);
+        
+        switch (costFilterBox.getSelectedId() - 1)
+        {
+            case showMeasured:                return entry != nullptr;
+            case showCpuUnder5Percent:        return entry != nullptr && entry->hasCpuCost() && entry->getAverageLoad() < 0.05;
+            case showCpuUnder20Percent:       return entry != nullptr && entry->hasCpuCost() && entry->getAverageLoad() < 0.2;
+            case showLoadsUnder1Second:       return entry != nullptr && entry->hasLoadCost() && entry->loadMilliseconds < 1000.0;
+            case showMemoryUnder100Megabytes: return entry != nullptr && entry->hasLoadCost()
+                                                     && entry->residentBytes < (juce::int64) 100 * 1024 * 1024;
+            default:                          return true;
+        }
+    }
+    
+    void sortFilteredList()
+    {
+        if (sortColumnId == nameColumn)
+        {
+            filteredPlugins.sort(true);
+            if (!sortForwards) { std::reverse(filteredPlugins.begin(), filteredPlugins.end()); }
+            return;
+        }
+        
+        // 측정하지 않은 플러그인은 정렬 방향과 상관없이 뒤로 보냄
+        std::stable_sort(filteredPlugins.begin(), filteredPlugins.end(), [this](const juce::String& a, const juce::String& b)
+        {
+            const auto valueA = getCostValue(a, sortColumnId);
+            const auto valueB = getCostValue(b, sortColumnId);
+            
+            if ((valueA < 0.0) != (valueB < 0.0)) { return valueB < 0.0; }
+            return sortForwards ? valueA < valueB : valueA > valueB;
+        });
+    }
 };
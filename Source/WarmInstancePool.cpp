@@ -0,0 +1,243 @@
+#include "WarmInstancePool.h"
+#include "LoadProfiler.h"
+
+WarmInstancePool::WarmInstancePool()
+{
+    formatManager.addDefaultFormats();
+    enabled = settings->getBool(enabledKey, false);
+}
+
+WarmInstancePool::~WarmInstancePool()
+{
+    stopTimer();
+    
+    for (auto& warm : warmInstances)
+    {
+        warm.instance->releaseResources();
+    }
+}
+
+void WarmInstancePool::setEnabled(bool shouldBeEnabled)
+{
+    settings->set(enabledKey, shouldBeEnabled);
+    
+    const juce::ScopedLock sl(lock);
+    enabled = shouldBeEnabled;
+    
+    if (enabled && !usages.empty() && !isTimerRunning())
+    {
+        startTimer(warmIntervalMs);
+    }
+    
+    if (!enabled)
+    {
+        // 인스턴스는 메시지 스레드에서 지움
+        juce::WeakReference<WarmInstancePool> weakThis(this);
+        juce::MessageManager::callAsync([weakThis]()
+        {
+            if (weakThis != nullptr) { weakThis->evictUnwantedInstances(); }
+        });
+    }
+}
+
+bool WarmInstancePool::isEnabled() const
+{
+    const juce::ScopedLock sl(lock);
+    return enabled;
+}
+
+juce::String WarmInstancePool::getKey(const juce::PluginDescription& description)
+{
+    return description.createIdentifierString();
+}
+
+std::unique_ptr<juce::AudioPluginInstance> WarmInstancePool::take(const juce::PluginDescription& description)
+{
+    const juce::ScopedLock sl(lock);
+    if (!enabled) { return nullptr; }
+    
+    const auto key = getKey(description);
+    
+    for (auto it = warmInstances.begin(); it != warmInstances.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            auto instance = std::move(it->instance);
+            ++numHits;
+            savedMilliseconds += it->warmMilliseconds;
+            warmInstances.erase(it);
+            return instance;
+        }
+    }
+    
+    ++numMisses;
+    return nullptr;
+}
+
+void WarmInstancePool::noteLoaded(const juce::PluginDescription& description, double sampleRate, int blockSize)
+{
+    const juce::ScopedLock sl(lock);
+    
+    const auto key = getKey(description);
+    auto usage = std::find_if(usages.begin(), usages.end(), [&key](const Usage& u) { return getKey(u.description) == key; });
+    
+    if (usage == usages.end())
+    {
+        usages.push_back({ description });
+        usage = std::prev(usages.end());
+    }
+    
+    ++usage->numLoads;
+    usage->lastLoadOrder = ++loadCounter;
+    
+    if (sampleRate > 0.0) { warmSampleRate = sampleRate; }
+    if (blockSize > 0) { warmBlockSize = blockSize; }
+    
+    if (enabled && !isTimerRunning()) { startTimer(warmIntervalMs); }
+}
+
+juce::StringArray WarmInstancePool::getWantedKeys() const
+{
+    // 두 번 이상 로드한 것 중 많이 로드한 순, 같으면 최근에 로드한 순으로 상위 몇 개만 데워둠
+    std::vector<Usage> ranked;
+    std::copy_if(usages.begin(), usages.end(), std::back_inserter(ranked),
+                 [](const Usage& u) { return u.numLoads >= minLoadsBeforeWarming; });
+    
+    std::sort(ranked.begin(), ranked.end(), [](const Usage& a, const Usage& b)
+    {
+        return a.numLoads != b.numLoads ? a.numLoads > b.numLoads : a.lastLoadOrder > b.lastLoadOrder;
+    });
+    
+    juce::StringArray keys;
+    for (size_t i = 0; i < juce::jmin(ranked.size(), (size_t) maxWarmInstances); ++i)
+    {
+        keys.add(getKey(ranked[i].description));
+    }
+    return keys;
+}
+
+void WarmInstancePool::evictUnwantedInstances()
+{
+    std::vector<WarmInstance> evicted;
+    {
+        const juce::ScopedLock sl(lock);
+        const auto wantedKeys = enabled ? getWantedKeys() : juce::StringArray();
+        juce::int64 totalBytes = 0;
+        
+        // 순위가 높은 것부터 예산 안에 드는 것만 남김
+        std::stable_sort(warmInstances.begin(), warmInstances.end(), [&wantedKeys](const auto& a, const auto& b)
+        {
+            return wantedKeys.indexOf(a.key) < wantedKeys.indexOf(b.key);
+        });
+        
+        for (auto it = warmInstances.begin(); it != warmInstances.end();)
+        {
+            totalBytes += it->residentBytes;
+            
+            if (!wantedKeys.contains(it->key) || totalBytes > memoryBudgetBytes)
+            {
+                totalBytes -= it->residentBytes;
+                evicted.push_back(std::move(*it));
+                it = warmInstances.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    
+    for (auto& warm : evicted)
+    {
+        warm.instance->releaseResources();
+    }
+}
+
+bool WarmInstancePool::isUserIdle()
+{
+    // 마우스 클릭이나 휠 입력이 있었으면 그때부터 다시 셈
+    auto& desktop = juce::Desktop::getInstance();
+    const auto inputEventCount = desktop.getMouseButtonClickCounter() + desktop.getMouseWheelMoveCounter();
+    const auto now = juce::Time::getMillisecondCounter();
+    
+    if (inputEventCount != lastInputEventCount)
+    {
+        lastInputEventCount = inputEventCount;
+        lastInputMilliseconds = now;
+    }
+    
+    return now - lastInputMilliseconds >= idleMillisecondsBeforeWarming;
+}
+
+void WarmInstancePool::timerCallback()
+{
+    juce::PluginDescription description;
+    double sampleRate = 0.0;
+    int blockSize = 0;
+    {
+        const juce::ScopedLock sl(lock);
+        if (!enabled) { stopTimer(); return; }
+        if (isWarming || !isUserIdle()) { return; }
+        
+        juce::String missingKey;
+        for (const auto& key : getWantedKeys())
+        {
+            const auto isWarm = std::any_of(warmInstances.begin(), warmInstances.end(),
+                                            [&key](const WarmInstance& w) { return w.key == key; });
+            if (!isWarm) { missingKey = key; break; }
+        }
+        
+        if (missingKey.isEmpty()) { stopTimer(); return; }
+        
+        for (const auto& usage : usages)
+        {
+            if (getKey(usage.description) == missingKey) { description = usage.description; }
+        }
+        
+        isWarming = true;
+        sampleRate = warmSampleRate;
+        blockSize = warmBlockSize;
+    }
+    
+    const auto startMilliseconds = juce::Time::getMillisecondCounterHiRes();
+    const auto startResidentBytes = LoadProfiler::getResidentMemoryBytes();
+    juce::WeakReference<WarmInstancePool> weakThis(this);
+    
+    formatManager.createPluginInstanceAsync(description, sampleRate, blockSize,
+                                           [weakThis, description, sampleRate, blockSize, startMilliseconds, startResidentBytes]
+                                           (std::unique_ptr<juce::AudioPluginInstance> instance, const juce::String&)
+    {
+        if (weakThis == nullptr) { return; }
+        
+        if (instance != nullptr)
+        {
+            instance->enableAllBuses();
+            instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance->prepareToPlay(sampleRate, blockSize);
+            
+            WarmInstance warm;
+            warm.key = getKey(description);
+            warm.instance = std::move(instance);
+            warm.warmMilliseconds = juce::Time::getMillisecondCounterHiRes() - startMilliseconds;
+            warm.residentBytes = juce::jmax((juce::int64) 0, LoadProfiler::getResidentMemoryBytes() - startResidentBytes);
+            
+            const juce::ScopedLock sl(weakThis->lock);
+            weakThis->warmInstances.push_back(std::move(warm));
+        }
+        
+        {
+            const juce::ScopedLock sl(weakThis->lock);
+            weakThis->isWarming = false;
+        }
+        
+        weakThis->evictUnwantedInstances();
+    });
+}
+
+juce::String WarmInstancePool::getStatusText() const
+{
+    const juce::ScopedLock sl(lock);
+    
+    return juce::String(numHits) + "/" + juce::String(numHits + numMisses) + " hits, "
+         + juce::String(savedMilliseconds / 1000.0, 1) + " s saved";
+}
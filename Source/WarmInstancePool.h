@@ -0,0 +1,74 @@
+#pragma once
+#include <JuceHeader.h>
+#include "WrapperSettings.h"
+
+// 최근 자주 로드한 플러그인을 미리 만들고 준비해두는 프로세스 공용 풀
+// 풀에 있으면 로드는 포인터 넘기기와 상태 적용만 하면 됨
+// 모든 인스턴스 생성/삭제는 메시지 스레드에서 함
+// VST3 인스턴스 생성은 메시지 스레드를 막으므로 여러 번 로드한 플러그인만, 사용자 입력이 한동안 없을 때 하나씩 데움
+// 켜고 끄는 설정은 세션이 아니라 WrapperSettings 에 저장됨
+class WarmInstancePool : private juce::Timer
+{
+public:
+    WarmInstancePool();
+    ~WarmInstancePool() override;
+    
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const;
+    
+    // 메시지 스레드에서 호출
+    std::unique_ptr<juce::AudioPluginInstance> take(const juce::PluginDescription& description);
+    void noteLoaded(const juce::PluginDescription& description, double sampleRate, int blockSize);
+    
+    juce::String getStatusText() const;
+    
+private:
+    struct Usage
+    {
+        juce::PluginDescription description;
+        int numLoads = 0;
+        juce::int64 lastLoadOrder = 0;
+    };
+    
+    struct WarmInstance
+    {
+        juce::String key;
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        double warmMilliseconds = 0.0;
+        juce::int64 residentBytes = 0;
+    };
+    
+    juce::CriticalSection lock;
+    juce::SharedResourcePointer<WrapperSettings> settings;
+    juce::AudioPluginFormatManager formatManager;
+    std::vector<Usage> usages;
+    std::vector<WarmInstance> warmInstances;
+    
+    bool enabled = false;
+    bool isWarming = false;
+    double warmSampleRate = 44100.0;
+    int warmBlockSize = 512;
+    juce::int64 loadCounter = 0;
+    int lastInputEventCount = -1;
+    juce::uint32 lastInputMilliseconds = 0;
+    
+    int numHits = 0;
+    int numMisses = 0;
+    double savedMilliseconds = 0.0;
+    
+    static constexpr int maxWarmInstances = 4;
+    static constexpr juce::int64 memoryBudgetBytes = (juce::int64) 1024 * 1024 * 1024;
+    static constexpr int warmIntervalMs = 1000;
+    static constexpr int minLoadsBeforeWarming = 2;
+    static constexpr juce::uint32 idleMillisecondsBeforeWarming = 10000;
+    static constexpr const char* enabledKey = "warm_pool";
+    
+    static juce::String getKey(const juce::PluginDescription& description);
+    bool isUserIdle();
+    juce::StringArray getWantedKeys() const;
+    void evictUnwantedInstances();
+    void timerCallback() override;
+    
+    JUCE_DECLARE_WEAK_REFERENCEABLE (WarmInstancePool)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WarmInstancePool)
+};
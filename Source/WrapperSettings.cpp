@@ -0,0 +1,30 @@
+#include "WrapperSettings.h"
+
+WrapperSettings::WrapperSettings()
+{
+    juce::PropertiesFile::Options options;
+    options.applicationName = "VST3 Loader";
+    options.folderName = "VST3 Loader";
+    options.filenameSuffix = ".settings";
+    options.osxLibrarySubFolder = "Application Support";
+    options.millisecondsBeforeSaving = 0;
+    options.processLock = &processLock;
+    properties = std::make_unique<juce::PropertiesFile>(options);
+}
+
+bool WrapperSettings::getBool(juce::StringRef key, bool defaultValue) const
+{
+    return properties->getBoolValue(key, defaultValue);
+}
+
+int WrapperSettings::getInt(juce::StringRef key, int defaultValue) const
+{
+    return properties->getIntValue(key, defaultValue);
+}
+
+void WrapperSettings::set(juce::StringRef key, const juce::var& value)
+{
+    // 다른 프로세스에서 바꾼 값을 덮어쓰지 않도록 저장 직전에 다시 읽음
+    properties->reload();
+    properties->setValue(key, value);
+}
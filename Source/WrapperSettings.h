@@ -0,0 +1,21 @@
+#pragma once
+#include <JuceHeader.h>
+
+// 세션 상태가 아니라 이 컴퓨터의 모든 래퍼 인스턴스에 함께 적용되는 설정 (프로세스 공용)
+// ~/Library/Application Support/VST3 Loader/VST3 Loader.settings
+// 메시지 스레드에서 읽고 씀
+class WrapperSettings
+{
+public:
+    WrapperSettings();
+    
+    bool getBool(juce::StringRef key, bool defaultValue) const;
+    int getInt(juce::StringRef key, int defaultValue) const;
+    void set(juce::StringRef key, const juce::var& value);
+    
+private:
+    juce::InterProcessLock processLock { "VST3 Loader settings" };
+    std::unique_ptr<juce::PropertiesFile> properties;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WrapperSettings)
+};